@@ -112,6 +112,18 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
 
 void Compiler::CompileX86Module(const Module& module) { engine_->Link<CodeGenX86>(module); }
 
+void Compiler::BuildFromObjectFiles(const std::vector<absl::string_view>& objects) {
+  CHECK(target_.arch == Target::Arch::X86) << "Only X86 supports linking the object files";
+  for (auto& obj : objects) {
+    engine_->AddObjectFile(obj);
+  }
+}
+
+std::vector<std::string> Compiler::GetObjectFiles() const {
+  CHECK(target_.arch == Target::Arch::X86) << "Only X86 supports exporting the object files";
+  return engine_->GetObjectFiles();
+}
+
 lower_func_ptr_t Compiler::Lookup(absl::string_view fn_name) {
   CHECK(engine_);
   if (engine_->Lookup(fn_name) != nullptr) {
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cinn/backends/llvm/codegen_llvm.h"
 #include "cinn/backends/llvm/execution_engine.h"
@@ -45,6 +46,15 @@ class Compiler final {
 
   void BuildDefault(const ir::Module& module);
 
+  /**
+   * Link the object files exported by GetObjectFiles instead of compiling a module, only X86 is supported.
+   * @param objects The object files which should stay alive until the functions are looked up.
+   */
+  void BuildFromObjectFiles(const std::vector<absl::string_view>& objects);
+
+  //! Get the compiled object files of the X86 modules built, which can be linked later without compiling again.
+  std::vector<std::string> GetObjectFiles() const;
+
   /**
    * Retrieve a function by \p fn_name.
    * @return function address or null if not exists.
@@ -566,7 +566,69 @@ llvm::Value *CodeGenLLVM::CreateSerialFor(const ir::For *op, int stride) {
 llvm::Value *CodeGenLLVM::Visit(const ir::For *op) { return CreateSerialFor(op); }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::PolyFor *op) {
-  CINN_NOT_IMPLEMENTED
+  SymbolTableGuard symbol_table_guard(*symbol_table_);
+
+  llvm::BasicBlock *preheader_bb = b_->GetInsertBlock();
+  llvm::BasicBlock *exit_bb      = nullptr;
+
+  llvm::BasicBlock::iterator insert_point = b_->GetInsertPoint();
+
+  if (insert_point == preheader_bb->end()) {
+    CHECK(!preheader_bb->getTerminator());
+    exit_bb = llvm::BasicBlock::Create(b_->getContext(), "loop_exit", b_->GetInsertBlock()->getParent(), nullptr);
+  } else {
+    CHECK(preheader_bb->getTerminator());
+    exit_bb = preheader_bb->splitBasicBlock(insert_point, "loop_exit");
+    preheader_bb->getTerminator()->eraseFromParent();
+  }
+
+  llvm::BasicBlock *header_bb =
+      llvm::BasicBlock::Create(b_->getContext(), "loop_header", b_->GetInsertBlock()->getParent(), nullptr);
+  llvm::BasicBlock *body_bb =
+      llvm::BasicBlock::Create(b_->getContext(), "loop_body", b_->GetInsertBlock()->getParent(), nullptr);
+
+  llvm::Function *func = preheader_bb->getParent();
+  b_->SetInsertPoint(&func->getEntryBlock(), func->getEntryBlock().getFirstInsertionPt());
+
+  llvm::Value *old_var = GetVar(op->iterator->name);
+  // loop iterator, in its own type as the strength reduced iterators may be int64
+  llvm::Type *iterator_type  = CinnTypeToLLVMType(op->iterator->type(), m_);
+  llvm::AllocaInst *iterator = Alloca(iterator_type, nullptr, op->iterator->name);
+  iterator->setAlignment(llvm::Align(std::max(op->iterator->type().bits(), 8) / 8));
+  SetVar(op->iterator->name, iterator);
+  auto to_iterator_type = [&](llvm::Value *value) {
+    return b_->CreateIntCast(value, iterator_type, /*isSigned=*/true);
+  };
+
+  b_->SetInsertPoint(preheader_bb);
+  Store(to_iterator_type(Visit(&op->init)), iterator);
+  CHECK(!preheader_bb->getTerminator());
+  Br(header_bb);
+
+  // loop_header, the condition reads the iterator
+  b_->SetInsertPoint(header_bb);
+  CondBr(/*Cond=*/Visit(&op->condition),
+         /*True=*/body_bb,
+         /*False=*/exit_bb);
+
+  // loop_body
+  b_->SetInsertPoint(body_bb);
+  Visit(&op->body);
+  llvm::Value *indvar_inc = Add(Load(iterator, "indvar"),
+                                to_iterator_type(Visit(&op->inc)),
+                                "indvar.inc",
+                                /*HasNUW=*/true,
+                                /*HasNSW=*/true);
+  Store(indvar_inc, iterator);
+  Br(header_bb);
+
+  if (old_var) {
+    SetVar(op->iterator->name, old_var);
+  } else {
+    symbol_table_->Erase(op->iterator->name);
+  }
+
+  b_->SetInsertPoint(exit_bb);
   return nullptr;
 }
 
@@ -765,9 +827,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Load *op) {
       CHECK(op->type().is_vector());
       return DenseVectorLoad(op);
     }
-    // scalarize load
+    // scalarize load, each element is only known to be aligned to its own size
     Type type        = op->type();
-    int alignment    = type.bits() / 8;
+    int alignment    = std::max(type.ElementOf().bits() / 8, 1);
     llvm::Value *ret = llvm::UndefValue::get(CinnTypeToLLVMType(type, m_, true));
     auto flambda     = [&](int i, llvm::Value *index) {
       auto *ptr                 = CreateBufferPtr(type.ElementOf(), buffer, index);
@@ -846,9 +908,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
         return inst;
       }
     }
-    // scalarize store
+    // scalarize store, each element is only known to be aligned to its own size
     Type type        = op->type();
-    int alignment    = type.bits() / 8;
+    int alignment    = std::max(type.ElementOf().bits() / 8, 1);
     llvm::Value *ret = llvm::UndefValue::get(CinnTypeToLLVMType(type, m_, true));
     auto flambda     = [&](int i, llvm::Value *index) {
       auto *ptr = CreateBufferPtr(type.ElementOf(), buffer, index);
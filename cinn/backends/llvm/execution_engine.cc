@@ -102,6 +102,10 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   return llvm::MemoryBuffer::getMemBuffer(it->second->getMemBufferRef());
 }
 
+void NaiveObjectCache::AddObject(const std::string &name, llvm::StringRef obj) {
+  cached_objects_[name] = llvm::MemoryBuffer::getMemBuffer(obj, name, false);
+}
+
 /*static*/ std::unique_ptr<ExecutionEngine> ExecutionEngine::Create(const ExecutionOptions &config) {
   VLOG(1) << "===================== Create CINN ExecutionEngine begin ====================";
   VLOG(1) << "initialize llvm config";
@@ -199,6 +203,22 @@ bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module, std::uniqu
   return true;
 }
 
+void ExecutionEngine::AddObjectFile(absl::string_view obj) {
+  std::lock_guard<std::mutex> lock(mu_);
+  std::string name = "object_" + std::to_string(cache_->objects().size());
+  cache_->AddObject(name, AsStringRef(obj));
+  llvm::cantFail(jit_->addObjectFile(llvm::MemoryBuffer::getMemBuffer(AsStringRef(obj), name, false)));
+}
+
+std::vector<std::string> ExecutionEngine::GetObjectFiles() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  std::vector<std::string> res;
+  for (auto &item : cache_->objects()) {
+    res.push_back(item.second->getBuffer().str());
+  }
+  return res;
+}
+
 void *ExecutionEngine::Lookup(absl::string_view name) {
   std::lock_guard<std::mutex> lock(mu_);
   if (auto symbol = jit_->lookup(AsStringRef(name))) {
@@ -54,6 +54,11 @@ class NaiveObjectCache : public llvm::ObjectCache {
   void notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef) override;
   std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override;
 
+  //! Reference an object file compiled elsewhere without copying, so that it can be exported again.
+  void AddObject(const std::string &name, llvm::StringRef obj);
+
+  const llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> &objects() const { return cached_objects_; }
+
  private:
   llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> cached_objects_;
 };
@@ -77,6 +82,12 @@ class ExecutionEngine {
 
   bool AddModule(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context);
 
+  //! Link an object file exported by GetObjectFiles, \p obj should stay alive until the symbols are looked up.
+  void AddObjectFile(absl::string_view obj);
+
+  //! Get the object files of all the modules compiled or added, the modules should be materialized by Lookup first.
+  std::vector<std::string> GetObjectFiles() const;
+
  protected:
   explicit ExecutionEngine(bool enable_object_cache) : cache_(std::make_unique<NaiveObjectCache>()) {}
 
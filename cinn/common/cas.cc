@@ -14,6 +14,8 @@
 
 #include "cinn/common/cas.h"
 
+#include <absl/container/flat_hash_set.h>
+
 #include <algorithm>
 #include <cmath>
 #include <string>
@@ -33,7 +35,140 @@ namespace cinn {
 namespace common {
 using namespace ir;  // NOLINT
 
-Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals) {
+namespace {
+
+/**
+ * Encode the structure of an expression and the intervals of the variables it refers to as the key of the
+ * AutoSimplify cache. Only the pure math nodes are encoded, the others may carry more than their fields, e.g. the
+ * buffer of a Load.
+ */
+class AutoSimplifyKeyEncoder {
+ public:
+  //! Return false if \p u holds nodes not encoded.
+  bool operator()(const Expr& u, const cas_intervals_t& var_intervals, std::string* key) {
+    key_ = key;
+    key_->clear();
+    if (!Encode(u)) return false;
+    // the intervals given by expressions may refer to more variables
+    for (size_t i = 0; i < vars_.size(); i++) {
+      auto it = var_intervals.find(vars_[i]);
+      if (it == var_intervals.end()) continue;
+      Append(vars_[i].size());
+      key_->append(vars_[i]);
+      auto& interval = it->second;
+      if (interval.e_l.defined() && interval.e_r.defined()) {
+        key_->push_back('e');
+        if (!Encode(interval.e_l) || !Encode(interval.e_r)) return false;
+      } else {
+        key_->push_back('i');
+        Append(interval.l);
+        Append(interval.r);
+      }
+    }
+    return true;
+  }
+
+ private:
+  template <typename T>
+  void Append(const T& x) {
+    key_->append(reinterpret_cast<const char*>(&x), sizeof(x));
+  }
+
+  void AppendType(const Type& t) {
+    Append(t.type());
+    Append(t.bits());
+    Append(t.lanes());
+    Append(t.cpp_type());
+  }
+
+  bool Encode(const Expr& e) {
+    if (!e.defined()) return false;
+    Append(e->node_type());
+    AppendType(e.type());
+    switch (e->node_type()) {
+      case IrNodeTy::IntImm:
+        Append(e.As<IntImm>()->value);
+        return true;
+      case IrNodeTy::UIntImm:
+        Append(e.As<UIntImm>()->value);
+        return true;
+      case IrNodeTy::FloatImm:
+        Append(e.As<FloatImm>()->value);
+        return true;
+      case IrNodeTy::_Var_: {
+        // the reduce axes carry their bounds
+        if (e.As<_Var_>()->is_reduce_axis) return false;
+        auto& name = e.As<_Var_>()->name;
+        Append(name.size());
+        key_->append(name);
+        if (var_names_.insert(name).second) vars_.push_back(name);
+        return true;
+      }
+#define __(op__) case IrNodeTy::op__:
+        NODETY_BINARY_OP_FOR_EACH(__)
+        NODETY_UNARY_OP_FOR_EACH(__)
+#undef __
+      case IrNodeTy::Cast:
+        for (auto& x : e->operands) {
+          if (!Encode(x)) return false;
+        }
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  std::string* key_{};
+  //! The variables referred to, in the order of their first occurrence.
+  std::vector<std::string> vars_;
+  absl::flat_hash_set<std::string> var_names_;
+};
+
+class AutoSimplifyCache {
+ public:
+  static AutoSimplifyCache& ThreadLocal() {
+    thread_local AutoSimplifyCache x;
+    return x;
+  }
+
+  bool Get(const std::string& key, Expr* res) {
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+      stats_.misses++;
+      return false;
+    }
+    stats_.hits++;
+    *res = optim::IRCopy(it->second);
+    return true;
+  }
+
+  //! The callers may change the results in place, so a copy is cached.
+  void Put(std::string key, const Expr& res) {
+    if (cache_.size() >= kMaxSize) cache_.clear();
+    cache_.emplace(std::move(key), optim::IRCopy(res));
+  }
+
+  void Uncached() { stats_.uncached++; }
+
+  AutoSimplifyCacheStats stats() const {
+    auto stats = stats_;
+    stats.size = cache_.size();
+    return stats;
+  }
+
+  void Clear() {
+    cache_.clear();
+    stats_ = AutoSimplifyCacheStats();
+  }
+
+ private:
+  static constexpr size_t kMaxSize = 1 << 16;
+
+  absl::flat_hash_map<std::string, Expr> cache_;
+  AutoSimplifyCacheStats stats_;
+};
+
+Expr AutoSimplifyImpl(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals) {
   u = detail::ConvertCinnToCAS(u);
   absl::flat_hash_map<std::string, CasInterval> s_var_intervals;
   for (auto& item : var_intervals) {
@@ -50,6 +185,30 @@ Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& v
   return u;
 }
 
+}  // namespace
+
+Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals) {
+  // the immediates are in the canonical form already
+  if (u.As<IntImm>()) return u;
+
+  auto& cache = AutoSimplifyCache::ThreadLocal();
+  std::string key;
+  if (!AutoSimplifyKeyEncoder()(u, var_intervals, &key)) {
+    cache.Uncached();
+    return AutoSimplifyImpl(u, var_intervals);
+  }
+
+  Expr res;
+  if (cache.Get(key, &res)) return res;
+  res = AutoSimplifyImpl(u, var_intervals);
+  cache.Put(std::move(key), res);
+  return res;
+}
+
+AutoSimplifyCacheStats GetAutoSimplifyCacheStats() { return AutoSimplifyCache::ThreadLocal().stats(); }
+
+void ClearAutoSimplifyCache() { AutoSimplifyCache::ThreadLocal().Clear(); }
+
 int gcd(int a, int b) {
   // Everything divides 0
   if (a == 0) return b;
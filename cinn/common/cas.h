@@ -50,8 +50,26 @@ struct CasInterval {
 
 using cas_intervals_t = absl::flat_hash_map<std::string, CasInterval>;
 
+/**
+ * Simplify an expression with CAS.
+ *
+ * The results are memoized on the current thread, keyed by the structure of the expression and the intervals of the
+ * variables it refers to, so the index expressions simplified again by the later passes, or repeated in the loads and
+ * stores, are converted and simplified once.
+ */
 Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals = {});
 
+//! The statistics of the memoized AutoSimplify on the current thread.
+struct AutoSimplifyCacheStats {
+  int64_t hits{};
+  int64_t misses{};
+  //! The expressions not cached, for they hold nodes not keyed, e.g. Load or Call.
+  int64_t uncached{};
+  size_t size{};
+};
+AutoSimplifyCacheStats GetAutoSimplifyCacheStats();
+void ClearAutoSimplifyCache();
+
 //! Simplify a CAS expression.
 Expr CasSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals = {});
 
@@ -453,5 +453,34 @@ TEST(CAS, cond) {
   }
 }
 
+TEST(CAS, AutoSimplifyCache) {
+  ClearAutoSimplifyCache();
+  Var x = ir::_Var_::Make("x", Int(32));
+  Var y = ir::_Var_::Make("y", Int(32));
+  absl::flat_hash_map<std::string, CasInterval> var_intervals0, var_intervals1;
+  var_intervals0.emplace("x", CasInterval{0, 3});
+  var_intervals1.emplace("x", CasInterval{0, 8});
+
+  auto u0 = AutoSimplify((x + 5) % 5, var_intervals0);
+  auto u1 = AutoSimplify((x + 5) % 5, var_intervals0);
+  EXPECT_EQ(GetStreamCnt(u0), "x");
+  EXPECT_EQ(GetStreamCnt(u1), "x");
+  // a copy is returned for each call
+  EXPECT_FALSE(u0.same_as(u1));
+  EXPECT_EQ(GetAutoSimplifyCacheStats().hits, 1);
+
+  // the intervals of the variables are in the key, the unrelated ones are not
+  var_intervals0.emplace("y", CasInterval{0, 3});
+  EXPECT_EQ(GetStreamCnt(AutoSimplify((x + 5) % 5, var_intervals0)), "x");
+  AutoSimplify((x + 5) % 5, var_intervals1);
+  EXPECT_EQ(GetAutoSimplifyCacheStats().hits, 2);
+
+  // the names of the variables are in the key
+  EXPECT_EQ(GetStreamCnt(AutoSimplify((y + 5) % 5)), "(y % 5)");
+  EXPECT_EQ(GetStreamCnt(AutoSimplify((x + 5) % 5)), "(x % 5)");
+  EXPECT_EQ(GetAutoSimplifyCacheStats().hits, 2);
+  EXPECT_EQ(GetAutoSimplifyCacheStats().size, 4UL);
+}
+
 }  // namespace common
 }  // namespace cinn
@@ -19,12 +19,40 @@
 namespace cinn {
 namespace common {
 
-Context& Context::Global() {
-  static Context x;
+namespace {
+thread_local CompileSession* current_session = nullptr;
+}  // namespace
+
+Context& Context::Global() { return current_session ? current_session->context() : Process(); }
+
+Context& Context::Process() {
+  static NameGenerator name_generator;
+  static Context x(&name_generator);
   isl_options_set_on_error(x.ctx_.get(), ISL_ON_ERROR_ABORT);
   return x;
 }
 
+CompileSession::CompileSession() : context_(new Context(Context::Process().name_generator_)), parent_(current_session) {
+  isl_options_set_on_error(context_->ctx_.get(), ISL_ON_ERROR_ABORT);
+  current_session = this;
+}
+
+CompileSession::~CompileSession() {
+  CHECK_EQ(current_session, this) << "The CompileSessions should be destroyed in the reverse order of creation";
+  current_session = parent_;
+  isl_ctx* ctx    = context_->ctx_.get();
+  // release the isl objects held by the context, e.g. in the InfoRegistry, before the ctx
+  context_.reset();
+#ifdef NDEBUG
+  // an isl object outliving the session makes isl_ctx_free warn and leak the ctx instead of aborting in the release
+  // builds, the debug builds keep aborting to catch it
+  isl_options_set_on_error(ctx, ISL_ON_ERROR_WARN);
+#endif
+  isl_ctx_free(ctx);
+}
+
+CompileSession* CompileSession::Current() { return current_session; }
+
 const std::string& Context::runtime_include_dir() const {
   if (runtime_include_dir_.empty()) {
     char* env            = std::getenv(kRuntimeIncludeDirEnvironKey);
@@ -36,6 +64,7 @@ const std::string& Context::runtime_include_dir() const {
 const char* kRuntimeIncludeDirEnvironKey = "runtime_include_dir";
 
 std::string NameGenerator::New(const std::string& name_hint) {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto it = name_hint_idx_.find(name_hint);
   if (it == name_hint_idx_.end()) {
     name_hint_idx_.emplace(name_hint, -1);
@@ -47,4 +76,11 @@ std::string NameGenerator::New(const std::string& name_hint) {
 }  // namespace common
 
 DEFINE_bool(cinn_runtime_display_debug_info, false, "Whether to display debug information in runtime");
+DEFINE_string(cinn_param_cache_dir,
+              "",
+              "The directory to cache the parameters transformed at load time, no cache if it is empty");
+DEFINE_bool(cinn_ir_hash_cons, false, "Whether to share the numeric constants of the IR by value in a lowering");
+DEFINE_bool(cinn_loop_invariant_code_motion,
+            false,
+            "Whether to hoist the loop invariants and reduce the strength of the loop variables in optim::Optimize");
 }  // namespace cinn
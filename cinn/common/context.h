@@ -17,6 +17,8 @@
 #include <gflags/gflags.h>
 #include <isl/cpp.h>
 
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -28,6 +30,9 @@
 namespace cinn {
 
 DECLARE_bool(cinn_runtime_display_debug_info);
+DECLARE_string(cinn_param_cache_dir);
+DECLARE_bool(cinn_ir_hash_cons);
+DECLARE_bool(cinn_loop_invariant_code_motion);
 
 namespace ir {
 class Expr;
@@ -37,26 +42,39 @@ namespace common {
 
 extern const char* kRuntimeIncludeDirEnvironKey;
 
+//! Thread safe.
 struct NameGenerator {
   std::string New(const std::string& name_hint);
 
   // Reset id to initial.
-  void ResetID() { name_hint_idx_.clear(); }
+  void ResetID() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    name_hint_idx_.clear();
+  }
 
  private:
+  std::mutex mutex_;
   absl::flat_hash_map<std::string, uint32_t> name_hint_idx_;
 };
 
+class CompileSession;
+
 class Context {
  public:
+  /**
+   * The context of the CompileSession active on the current thread if any, otherwise the context of the process.
+   */
   static Context& Global();
 
+  //! The context of the process, shared by the compilations not in a CompileSession.
+  static Context& Process();
+
   /**
-   * Generate a new unique name.
+   * Generate a new unique name. The names are unique in the process, the sessions share the generator of the process.
    * @param name_hint The prefix.
    */
-  std::string NewName(const std::string& name_hint) { return name_generator_.New(name_hint); }
-  void ResetNameId() { name_generator_.ResetID(); }
+  std::string NewName(const std::string& name_hint) { return name_generator_->New(name_hint); }
+  void ResetNameId() { name_generator_->ResetID(); }
 
   InfoRegistry& info_rgt() { return info_rgt_; }
 
@@ -65,18 +83,49 @@ class Context {
   const std::string& runtime_include_dir() const;
 
   /**
-   * The global isl ctx.
+   * The isl ctx, the isl objects of a compilation should all be created in it.
    */
   isl::ctx isl_ctx() { return ctx_; }
 
  private:
-  Context() : ctx_(isl_ctx_alloc()) {}
-  NameGenerator name_generator_;
+  explicit Context(NameGenerator* name_generator) : name_generator_(name_generator), ctx_(isl_ctx_alloc()) {}
+
+  NameGenerator* name_generator_{};
   isl::ctx ctx_;
   DebugManager debug_mgr_;
   InfoRegistry info_rgt_;
 
   mutable std::string runtime_include_dir_;
+
+  friend class CompileSession;
+};
+
+/**
+ * A session of compilation with a Context of its own, e.g. the build of a model by GraphCompiler.
+ *
+ * A session is active on the thread creating it until it is destroyed, the sessions nest. While active,
+ * Context::Global() on the thread returns the context of the session, so the isl ctx, the InfoRegistry and the
+ * DebugManager are not shared with the compilations on the other threads, which are not safe to share. The isl objects
+ * of a compilation should all be created in its session, e.g. the tensors and the stages it lowers, and must be
+ * released before the session ends, which frees its isl ctx. An isl object outliving the session aborts the debug
+ * builds and leaks the ctx with a warning in the release builds.
+ */
+class CompileSession {
+ public:
+  CompileSession();
+  ~CompileSession();
+
+  CompileSession(const CompileSession&) = delete;
+  CompileSession& operator=(const CompileSession&) = delete;
+
+  //! The session active on the current thread, nullptr if none.
+  static CompileSession* Current();
+
+  Context& context() { return *context_; }
+
+ private:
+  std::unique_ptr<Context> context_;
+  CompileSession* parent_{};
 };
 
 static std::string UniqName(const std::string& prefix) { return Context::Global().NewName(prefix); }
@@ -0,0 +1,118 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/common/context.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "cinn/lang/compute.h"
+#include "cinn/lang/lower.h"
+#include "cinn/lang/placeholder.h"
+
+namespace cinn {
+namespace common {
+
+TEST(CompileSession, isolate) {
+  auto* process_ctx = Context::Process().isl_ctx().get();
+  ASSERT_EQ(Context::Global().isl_ctx().get(), process_ctx);
+  ASSERT_FALSE(CompileSession::Current());
+  Context::Global().info_rgt().Get<int>("session_test") = 1;
+
+  {
+    CompileSession session;
+    ASSERT_EQ(CompileSession::Current(), &session);
+    auto* session_ctx = Context::Global().isl_ctx().get();
+    ASSERT_NE(session_ctx, process_ctx);
+    // the registry is the session's
+    ASSERT_EQ(Context::Global().info_rgt().Get<int>("session_test"), 0);
+
+    {
+      CompileSession nested;
+      ASSERT_NE(Context::Global().isl_ctx().get(), session_ctx);
+    }
+    ASSERT_EQ(Context::Global().isl_ctx().get(), session_ctx);
+
+    isl::set domain(Context::Global().isl_ctx(), "{ S[i] : 0 <= i < 10 }");
+    ASSERT_EQ(domain.ctx().get(), session_ctx);
+  }
+
+  ASSERT_FALSE(CompileSession::Current());
+  ASSERT_EQ(Context::Global().isl_ctx().get(), process_ctx);
+  ASSERT_EQ(Context::Global().info_rgt().Get<int>("session_test"), 1);
+}
+
+TEST(CompileSession, unique_names) {
+  std::string name = UniqName("session_name");
+  CompileSession session;
+  // the names are still unique in the process
+  ASSERT_NE(UniqName("session_name"), name);
+}
+
+#ifdef NDEBUG
+TEST(CompileSession, outlived_object) {
+  std::unique_ptr<isl::set> domain;
+  {
+    CompileSession session;
+    domain.reset(new isl::set(Context::Global().isl_ctx(), "{ S[i] : 0 <= i < 10 }"));
+  }
+  // the release builds leak the ctx rather than free it under the set
+  ASSERT_EQ(isl_set_dim(domain->get(), isl_dim_set), 1);
+  domain.reset();
+}
+#else
+TEST(CompileSessionDeathTest, outlived_object) {
+  // the debug builds abort on an isl object outliving its session
+  auto outlive = [] {
+    std::unique_ptr<isl::set> domain;
+    {
+      CompileSession session;
+      domain.reset(new isl::set(Context::Global().isl_ctx(), "{ S[i] : 0 <= i < 10 }"));
+    }
+  };
+  EXPECT_DEATH(outlive(), "still reference");
+}
+#endif
+
+TEST(CompileSession, lower_on_threads) {
+  const int num_threads = 4;
+  std::vector<std::vector<std::string>> names(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([t, &names] {
+      CompileSession session;
+      Expr M(32), N(16);
+      lang::Placeholder<float> A("A", {M, N});
+      auto B = lang::Compute(
+          {M, N}, [=](Var i, Var j) -> Expr { return A(i, j) + 1.f; }, "B");
+      auto stages = poly::CreateStages({B});
+      stages[B]->Split(0, 4);
+      auto fn = lang::Lower("fn", stages, {A, B});
+      ASSERT_TRUE(fn.defined());
+      for (int k = 0; k < 100; k++) names[t].push_back(UniqName("thread_name"));
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  std::set<std::string> all;
+  for (auto& x : names) all.insert(x.begin(), x.end());
+  ASSERT_EQ(all.size(), num_threads * 100);
+}
+
+}  // namespace common
+}  // namespace cinn
@@ -13,37 +13,47 @@
 // limitations under the License.
 
 #pragma once
-#include <absl/container/flat_hash_map.h>
+#include <absl/container/node_hash_map.h>
 #include <absl/types/any.h>
 
+#include <mutex>
 #include <string>
 
 namespace cinn {
 namespace common {
 
 /**
- * Key value.
+ * Key value. The lookups are thread safe and the values stay in place, while the accesses to a value are not
+ * synchronized.
  */
 class InfoRegistry {
  public:
   template <typename T>
   T& Get(const std::string& key);
 
-  size_t size() const { return data_.size(); }
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_.size();
+  }
 
-  void Clear() { data_.clear(); }
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_.clear();
+  }
 
  private:
-  absl::flat_hash_map<std::string, absl::any> data_;
+  mutable std::mutex mutex_;
+  absl::node_hash_map<std::string, absl::any> data_;
 };
 
 template <typename T>
 T& InfoRegistry::Get(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto it = data_.find(key);
   if (it == data_.end()) {
-    data_[key] = T();
+    it = data_.emplace(key, T()).first;
   }
-  return absl::any_cast<T&>(data_[key]);
+  return absl::any_cast<T&>(it->second);
 }
 
 }  // namespace common
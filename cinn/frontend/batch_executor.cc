@@ -0,0 +1,194 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/batch_executor.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace cinn {
+namespace frontend {
+
+BatchExecutor::BatchExecutor(std::unique_ptr<Interpreter> interpreter,
+                             const std::vector<std::string>& input_names,
+                             const std::vector<std::string>& output_names,
+                             const BatchExecutorOptions& options)
+    : interpreter_(std::move(interpreter)), options_(options) {
+  CHECK(interpreter_);
+  // the requests are copied in and out of the tensors on the host
+  CHECK(interpreter_->target().arch == Target::Arch::X86) << "BatchExecutor only supports the X86 target";
+  CHECK(!input_names.empty());
+  CHECK_GT(options_.max_queue_size, 0);
+  for (auto& name : input_names) {
+    auto tensor = interpreter_->GetTensor(name);
+    auto& shape = tensor->shape().data();
+    CHECK(!shape.empty()) << "The input [" << name << "] should have the batch dimension";
+    if (max_batch_size_ == 0) max_batch_size_ = shape[0];
+    CHECK_EQ(shape[0], max_batch_size_) << "The inputs should have the same batch size";
+    inputs_.push_back(tensor);
+    input_row_sizes_.push_back(tensor->shape().numel() / max_batch_size_);
+  }
+  for (auto& name : output_names) {
+    auto tensor = interpreter_->GetTensor(name);
+    auto& shape = tensor->shape().data();
+    CHECK(!shape.empty() && shape[0] == max_batch_size_)
+        << "The first dimension of the output [" << name << "] should be the batch";
+    outputs_.push_back(tensor);
+    output_row_sizes_.push_back(tensor->shape().numel() / max_batch_size_);
+  }
+  worker_ = std::thread([this] { Loop(); });
+}
+
+BatchExecutor::~BatchExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  not_empty_.notify_all();
+  not_full_.notify_all();
+  // the worker runs the requests left in the queue before it exits
+  worker_.join();
+}
+
+int BatchExecutor::RowsOf(const Tensors& inputs, std::string* error) const {
+  if (inputs.size() != inputs_.size()) {
+    *error = "The request should hold all the inputs";
+    return -1;
+  }
+  if (inputs[0].empty() || inputs[0].size() % input_row_sizes_[0] != 0) {
+    *error = "The input should hold whole rows of the batch";
+    return -1;
+  }
+  int rows = inputs[0].size() / input_row_sizes_[0];
+  for (size_t i = 1; i < inputs.size(); i++) {
+    if (inputs[i].size() != rows * input_row_sizes_[i]) {
+      *error = "The inputs should hold the same number of rows";
+      return -1;
+    }
+  }
+  if (rows > max_batch_size_) {
+    *error = "The request is larger than the max batch size";
+    return -1;
+  }
+  return rows;
+}
+
+std::future<BatchExecutor::Tensors> BatchExecutor::Failed(std::exception_ptr error) {
+  std::promise<Tensors> promise;
+  promise.set_exception(error);
+  return promise.get_future();
+}
+
+std::future<BatchExecutor::Tensors> BatchExecutor::Submit(Tensors inputs) {
+  std::string error;
+  int rows = RowsOf(inputs, &error);
+  if (rows < 0) return Failed(std::make_exception_ptr(std::invalid_argument(error)));
+
+  std::future<Tensors> outputs;
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_full_.wait(lock, [this] { return stopped_ || static_cast<int>(queue_.size()) < options_.max_queue_size; });
+  Enqueue(std::move(inputs), rows, &outputs, &lock);
+  return outputs;
+}
+
+bool BatchExecutor::TrySubmit(Tensors inputs, std::future<Tensors>* outputs) {
+  std::string error;
+  int rows = RowsOf(inputs, &error);
+  if (rows < 0) {
+    *outputs = Failed(std::make_exception_ptr(std::invalid_argument(error)));
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (static_cast<int>(queue_.size()) >= options_.max_queue_size) return false;
+  Enqueue(std::move(inputs), rows, outputs, &lock);
+  return true;
+}
+
+void BatchExecutor::Enqueue(Tensors inputs,
+                            int rows,
+                            std::future<Tensors>* outputs,
+                            std::unique_lock<std::mutex>* lock) {
+  // a request racing with the destructor fails instead of waiting for a worker that is gone
+  if (stopped_) {
+    lock->unlock();
+    *outputs = Failed(std::make_exception_ptr(std::runtime_error("The executor is stopped")));
+    return;
+  }
+  Request request;
+  request.rows     = rows;
+  request.inputs   = std::move(inputs);
+  request.enqueued = std::chrono::steady_clock::now();
+  *outputs         = request.outputs.get_future();
+  queue_.push_back(std::move(request));
+  lock->unlock();
+  not_empty_.notify_one();
+}
+
+std::vector<BatchExecutor::Request> BatchExecutor::NextBatch() {
+  std::vector<Request> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+  if (queue_.empty()) return batch;
+
+  auto deadline = queue_.front().enqueued + options_.max_latency;
+  int rows      = 0;
+  while (true) {
+    while (!queue_.empty() && rows + queue_.front().rows <= max_batch_size_) {
+      rows += queue_.front().rows;
+      batch.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    not_full_.notify_all();
+    // run now if the batch is full, the next request does not fit in it, or no more requests are coming
+    if (rows == max_batch_size_ || !queue_.empty() || stopped_) break;
+    if (!not_empty_.wait_until(lock, deadline, [this] { return stopped_ || !queue_.empty(); })) break;
+  }
+  return batch;
+}
+
+void BatchExecutor::RunBatch(std::vector<Request>* batch) {
+  for (size_t i = 0; i < inputs_.size(); i++) {
+    float* data = inputs_[i]->mutable_data<float>(common::DefaultHostTarget());
+    for (auto& request : *batch) {
+      std::memcpy(data, request.inputs[i].data(), request.inputs[i].size() * sizeof(float));
+      data += request.inputs[i].size();
+    }
+  }
+  VLOG(3) << "Run a batch of " << batch->size() << " requests";
+  interpreter_->Run();
+
+  std::vector<const float*> outputs;
+  for (auto& tensor : outputs_) outputs.push_back(tensor->data<float>());
+  for (auto& request : *batch) {
+    Tensors result(outputs_.size());
+    for (size_t i = 0; i < outputs_.size(); i++) {
+      size_t size = request.rows * output_row_sizes_[i];
+      result[i].assign(outputs[i], outputs[i] + size);
+      outputs[i] += size;
+    }
+    request.outputs.set_value(std::move(result));
+  }
+}
+
+void BatchExecutor::Loop() {
+  while (true) {
+    auto batch = NextBatch();
+    if (batch.empty()) return;
+    RunBatch(&batch);
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
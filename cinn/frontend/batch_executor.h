@@ -0,0 +1,113 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cinn/frontend/interpreter.h"
+
+namespace cinn {
+namespace frontend {
+
+struct BatchExecutorOptions {
+  //! The longest time the first request of a batch waits for others to join it.
+  std::chrono::microseconds max_latency{1000};
+  //! The most requests waiting in the queue, Submit blocks when the queue is full.
+  int max_queue_size{64};
+};
+
+/**
+ * Serve concurrent requests with a model built for a fixed batch size. The requests waiting in the queue are
+ * coalesced along the first dimension of the inputs until the batch is full or the latency budget of the first request
+ * runs out, then the model runs once and the outputs are scattered back to the requests.
+ *
+ * The model should be loaded by \p interpreter for the X86 target with the first dimension of all the inputs as the max
+ * batch size, and the first dimension of all the outputs should be the batch too. A request may hold several rows of the
+ * batch.
+ */
+class BatchExecutor {
+ public:
+  //! The float32 data of the inputs or outputs of a request, in the order of their names.
+  using Tensors = std::vector<std::vector<float>>;
+
+  BatchExecutor(std::unique_ptr<Interpreter> interpreter,
+                const std::vector<std::string>& input_names,
+                const std::vector<std::string>& output_names,
+                const BatchExecutorOptions& options = BatchExecutorOptions());
+  ~BatchExecutor();
+
+  /**
+   * Add a request to the queue, block while the queue is full.
+   * @param inputs The inputs of the request, each holds the same number of rows of the batch.
+   * @return The outputs of the request once the batch holding it runs. It holds std::invalid_argument if \p inputs
+   * are malformed, or std::runtime_error if the executor is being destroyed.
+   */
+  std::future<Tensors> Submit(Tensors inputs);
+
+  /**
+   * Add a request to the queue if it is not full.
+   * @return false if the queue is full, and \p outputs is not touched. A malformed request is not queued and
+   * \p outputs holds the error as Submit does.
+   */
+  bool TrySubmit(Tensors inputs, std::future<Tensors>* outputs);
+
+  int max_batch_size() const { return max_batch_size_; }
+
+ private:
+  struct Request {
+    Tensors inputs;
+    int rows;
+    std::chrono::steady_clock::time_point enqueued;
+    std::promise<Tensors> outputs;
+  };
+
+  //! The number of rows of the batch held by \p inputs, or -1 with the reason in \p error if they are malformed.
+  int RowsOf(const Tensors& inputs, std::string* error) const;
+  //! A future holding \p error.
+  static std::future<Tensors> Failed(std::exception_ptr error);
+  void Enqueue(Tensors inputs, int rows, std::future<Tensors>* outputs, std::unique_lock<std::mutex>* lock);
+  //! Take the requests of the next batch, return empty when stopped.
+  std::vector<Request> NextBatch();
+  void RunBatch(std::vector<Request>* batch);
+  void Loop();
+
+  std::unique_ptr<Interpreter> interpreter_;
+  std::vector<hlir::framework::Tensor> inputs_;
+  std::vector<hlir::framework::Tensor> outputs_;
+  //! The number of floats of a row in each input or output.
+  std::vector<size_t> input_row_sizes_;
+  std::vector<size_t> output_row_sizes_;
+  int max_batch_size_{};
+  BatchExecutorOptions options_;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<Request> queue_;
+  bool stopped_{false};
+  std::thread worker_;
+};
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,99 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/batch_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+#include "cinn/runtime/use_extern_funcs.h"
+
+DEFINE_string(model_dir, "", "");
+
+namespace cinn::frontend {
+
+TEST(BatchExecutor, basic) {
+  const int batch_size = 4;
+  const int num_rows   = 10;
+  std::vector<std::vector<float>> rows(num_rows, std::vector<float>(30));
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (auto& row : rows) {
+    for (auto& x : row) x = dist(engine);
+  }
+
+  // the reference runs the rows one by one
+  Interpreter single({"A"}, {{1, 30}});
+  single.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+  std::vector<std::vector<float>> expected;
+  for (auto& row : rows) {
+    auto input = single.GetTensor("A");
+    std::memcpy(input->mutable_data<float>(common::DefaultHostTarget()), row.data(), row.size() * sizeof(float));
+    single.Run();
+    auto output = single.GetTensor("fc_0.tmp_2");
+    expected.emplace_back(output->data<float>(), output->data<float>() + output->shape().numel());
+  }
+
+  std::unique_ptr<Interpreter> batched(new Interpreter({"A"}, {{batch_size, 30}}));
+  batched->LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+  BatchExecutorOptions options;
+  options.max_queue_size = 3;
+  BatchExecutor executor(std::move(batched), {"A"}, {"fc_0.tmp_2"}, options);
+  ASSERT_EQ(executor.max_batch_size(), batch_size);
+
+  std::vector<std::future<BatchExecutor::Tensors>> futures;
+  std::vector<std::thread> clients;
+  std::mutex mutex;
+  futures.resize(num_rows);
+  for (int i = 0; i < num_rows; i++) {
+    clients.emplace_back([&, i] {
+      auto future = executor.Submit({rows[i]});
+      std::lock_guard<std::mutex> lock(mutex);
+      futures[i] = std::move(future);
+    });
+  }
+  for (auto& client : clients) client.join();
+
+  for (int i = 0; i < num_rows; i++) {
+    auto outputs = futures[i].get();
+    ASSERT_EQ(outputs.size(), 1UL);
+    ASSERT_EQ(outputs[0].size(), expected[i].size());
+    for (size_t j = 0; j < expected[i].size(); j++) {
+      EXPECT_NEAR(outputs[0][j], expected[i][j], 1e-5);
+    }
+  }
+}
+
+TEST(BatchExecutor, malformed_request) {
+  std::unique_ptr<Interpreter> batched(new Interpreter({"A"}, {{2, 30}}));
+  batched->LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+  BatchExecutor executor(std::move(batched), {"A"}, {"fc_0.tmp_2"});
+
+  // the malformed requests fail on their own futures and do not stop the executor
+  EXPECT_THROW(executor.Submit({std::vector<float>(29)}).get(), std::invalid_argument);
+  EXPECT_THROW(executor.Submit({std::vector<float>(90)}).get(), std::invalid_argument);
+  EXPECT_THROW(executor.Submit({}).get(), std::invalid_argument);
+  std::future<BatchExecutor::Tensors> future;
+  ASSERT_TRUE(executor.TrySubmit({std::vector<float>(31)}, &future));
+  EXPECT_THROW(future.get(), std::invalid_argument);
+
+  auto outputs = executor.Submit({std::vector<float>(60, 0.5f)}).get();
+  ASSERT_EQ(outputs.size(), 1UL);
+  EXPECT_FALSE(outputs[0].empty());
+}
+
+}  // namespace cinn::frontend
@@ -14,9 +14,19 @@
 
 #include "cinn/frontend/interpreter.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#include "cinn/common/context.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/param_transform.h"
 #include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/program_serializer.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/hlir/pass/use_pass.h"
 
@@ -40,6 +50,7 @@ struct Interpreter::Impl {
 
   std::vector<std::string> input_names_;
   std::vector<hlir::framework::shape_t> input_shapes_;
+  Target target_;
 
   std::shared_ptr<hlir::framework::Scope> scope_;
   std::unique_ptr<frontend::Program> program_;
@@ -48,9 +59,32 @@ struct Interpreter::Impl {
   absl::flat_hash_map<std::string, Variable> var_map_;
   absl::flat_hash_map<std::string, std::string> var_map_paddle_to_cinn_;
   absl::flat_hash_map<std::string, std::string> var_map_cinn_to_paddle_;
+  std::unordered_set<std::string> fetch_ids_;
+  //! The file each parameter is loaded from, keys the transformed parameters cached on disk.
+  absl::flat_hash_map<std::string, std::string> param_files_;
 
+  //! Hold the compiled code and the mapped file of a loaded model, declared before the programs running the code so
+  //! it outlives them and their pending async runs.
+  std::unique_ptr<hlir::framework::CompiledProgram> compiled_program_;
   std::unique_ptr<hlir::framework::Program> runtime_program_;
   std::unique_ptr<hlir::framework::Program> prerun_program_;
+
+  struct BoundMemory {
+    hlir::framework::Tensor tensor;
+    void* data;
+    size_t size;
+    std::shared_ptr<void> holder;
+  };
+  //! The memory bound by the caller which should be copied before or after each run.
+  std::vector<BoundMemory> input_copies_;
+  std::vector<BoundMemory> output_copies_;
+
+  //! Bind the memory to the tensor directly, or add it to \p copies and return false if it is misaligned.
+  bool Bind(const hlir::framework::Tensor& tensor,
+            void* data,
+            size_t size,
+            std::shared_ptr<void> holder,
+            std::vector<BoundMemory>* copies);
 };
 
 void Interpreter::LoadPaddleModel(const std::string& model_dir, const Target& target, bool params_combined) {
@@ -61,11 +95,104 @@ void Interpreter::LoadPaddleModel(const std::string& model_dir, const Target& ta
   impl_->program_.reset(program.release());
   impl_->var_map_                = var_map;
   impl_->var_map_paddle_to_cinn_ = var_map_paddle_to_program;
+  impl_->fetch_ids_              = std::get<3>(programTuple);
+  impl_->target_                 = target;
+  for (auto& item : var_map_paddle_to_program) {
+    impl_->param_files_[item.second] = params_combined ? model_dir + "/params" : model_dir + "/" + item.first;
+  }
 
   impl_->Build(impl_->input_names_, impl_->input_shapes_, target);
 }
 
-void Interpreter::Run() { impl_->runtime_program_->Execute(); }
+namespace {
+// the prefix of the metadata keys saving the names of the Paddle vars
+const char kPaddleVarPrefix[] = "paddle_var:";
+}  // namespace
+
+void Interpreter::SaveCompiledModel(const std::string& path) {
+  CHECK(impl_->runtime_program_ && impl_->graph_compiler_) << "The model should be built before saving";
+  std::vector<std::string> feed_names;
+  for (auto& name : impl_->input_names_) {
+    feed_names.push_back(impl_->var_map_.at(name)->id);
+  }
+  std::map<std::string, std::string> metadata;
+  for (auto& item : impl_->var_map_paddle_to_cinn_) {
+    metadata[kPaddleVarPrefix + item.first] = item.second;
+  }
+  hlir::framework::SaveCompiledProgram(path,
+                                       *impl_->runtime_program_,
+                                       *impl_->scope_,
+                                       *impl_->graph_compiler_->GetCompiler(),
+                                       feed_names,
+                                       metadata);
+}
+
+bool Interpreter::LoadCompiledModel(const std::string& path, const Target& target) {
+  auto compiled = hlir::framework::LoadCompiledProgram(path, target);
+  if (!compiled) return false;
+  impl_->var_map_paddle_to_cinn_.clear();
+  for (auto& item : compiled->metadata) {
+    if (item.first.find(kPaddleVarPrefix) == 0) {
+      impl_->var_map_paddle_to_cinn_[item.first.substr(std::strlen(kPaddleVarPrefix))] = item.second;
+    }
+  }
+  impl_->target_           = target;
+  impl_->scope_            = compiled->scope;
+  impl_->runtime_program_  = std::move(compiled->program);
+  impl_->compiled_program_ = std::move(compiled);
+  return true;
+}
+
+bool Interpreter::Impl::Bind(const hlir::framework::Tensor& tensor,
+                             void* data,
+                             size_t size,
+                             std::shared_ptr<void> holder,
+                             std::vector<BoundMemory>* copies) {
+  auto erase = [&](std::vector<BoundMemory>* bound) {
+    bound->erase(std::remove_if(
+                     bound->begin(), bound->end(), [&](const BoundMemory& x) { return x.tensor.get() == tensor.get(); }),
+                 bound->end());
+  };
+  erase(&input_copies_);
+  erase(&output_copies_);
+
+  Type type    = tensor->type().valid() ? tensor->type() : Float(32);
+  size_t bytes = tensor->shape().numel() * ((type.bits() + 7) / 8);
+  CHECK_GE(size, bytes) << "The memory bound is smaller than the tensor";
+  // keep the same alignment as the memory allocated by the tensor itself
+  if (reinterpret_cast<uintptr_t>(data) % type.ElementOf().bits() != 0) {
+    VLOG(3) << "The memory bound is misaligned, copy it at each run";
+    // the tensor may still reference the memory bound before, so give it memory of its own
+    size_t alignment = type.ElementOf().bits();
+    std::shared_ptr<void> staging(std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment),
+                                  std::free);
+    tensor->ShareExternalData(staging.get(), type, common::DefaultHostTarget(), staging);
+    copies->push_back({tensor, data, bytes, std::move(holder)});
+    return false;
+  }
+  tensor->ShareExternalData(data, type, common::DefaultHostTarget(), std::move(holder));
+  return true;
+}
+
+void Interpreter::BindInput(const std::string& name, void* data, size_t size, std::shared_ptr<void> holder) {
+  CHECK(impl_->runtime_program_) << "The model should be built before binding the inputs";
+  impl_->Bind(GetTensor(name), data, size, std::move(holder), &impl_->input_copies_);
+}
+
+void Interpreter::BindOutput(const std::string& name, void* data, size_t size, std::shared_ptr<void> holder) {
+  CHECK(impl_->runtime_program_) << "The model should be built before binding the outputs";
+  impl_->Bind(GetTensor(name), data, size, std::move(holder), &impl_->output_copies_);
+}
+
+void Interpreter::Run() {
+  for (auto& input : impl_->input_copies_) {
+    std::memcpy(input.tensor->buffer()->memory, input.data, input.size);
+  }
+  impl_->runtime_program_->Execute();
+  for (auto& output : impl_->output_copies_) {
+    std::memcpy(output.data, output.tensor->buffer()->memory, output.size);
+  }
+}
 
 hlir::framework::Tensor Interpreter::GetTensor(const std::string& name) {
   if (impl_->scope_->FindVar(name)) return impl_->scope_->GetTensor(name);
@@ -94,18 +221,25 @@ void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
 
   program_->SetInputs({input_vars});
   program_->Validate();
+  frontend::ProgramPass::Apply(
+      program_.get(), fetch_ids_, target, {"CommonSubexpressionEliminate", "DeadCodeEliminate"});
 
   LOG(INFO) << "Program:\n" << *program_;
 
-  auto graph = std::make_shared<hlir::framework::Graph>(*program_, target);
+  auto graph = std::make_shared<hlir::framework::Graph>(*program_, fetch_ids_, target);
 
   hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "ConstantFolding");
 #ifndef CINN_WITH_CUDA
   if (target.arch == Target::Arch::X86) {
     hlir::framework::ApplyPass(graph.get(), "AlterLayout");
   }
 #endif
 
+  // the weights packed by AlterLayout are transformed directly in the scope instead of by pre_run instructions
+  hlir::framework::TransformParamsAtLoad(
+      graph.get(), scope_.get(), target, FLAGS_cinn_param_cache_dir, param_files_);
+
   hlir::framework::ApplyPass(graph.get(), "OpFusion");
   // Target target = common::DefaultHostTarget();
   scope_ = hlir::framework::BuildScope(target, graph, scope_);
@@ -114,6 +248,8 @@ void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
   runtime_program_->PreRun();
 }
 
+const Target& Interpreter::target() const { return impl_->target_; }
+
 std::shared_ptr<hlir::framework::Scope> Interpreter::scope() {
   CHECK(impl_->scope_);
   return impl_->scope_;
@@ -41,6 +41,36 @@ class Interpreter final {
    */
   void LoadPaddleModel(const std::string& model_dir, const Target& target, bool params_combined = false);
 
+  /**
+   * Save the built model with its parameters and compiled code, only X86 is supported.
+   * @param path The file to save the model.
+   */
+  void SaveCompiledModel(const std::string& path);
+
+  /**
+   * Load a model saved by SaveCompiledModel instead of loading and compiling a Paddle model.
+   * @return false if the saved model does not exist or is stale, then the Paddle model should be loaded.
+   */
+  bool LoadCompiledModel(const std::string& path, const Target& target);
+
+  /**
+   * Bind the memory owned by the caller to an input of the model, so that Run reads the input from it directly.
+   * If the memory is not aligned as the tensor requires, it is copied into the tensor at each Run instead.
+   * The tensor should not be resized larger while bound, it would stop reading the memory, bind it again instead.
+   * @param name The name of the input in the Paddle model or the CINN program.
+   * @param data The memory which should hold the whole tensor and stay alive while it is bound.
+   * @param size The size of the memory in bytes.
+   * @param holder Optionally keep the memory alive while it is bound.
+   */
+  void BindInput(const std::string& name, void* data, size_t size, std::shared_ptr<void> holder = nullptr);
+
+  /**
+   * Bind the memory owned by the caller to an output of the model, so that Run writes the output to it directly.
+   * If the memory is not aligned as the tensor requires, the output is copied to it after each Run instead.
+   * The tensor should not be resized larger while bound, it would stop writing the memory, bind it again instead.
+   */
+  void BindOutput(const std::string& name, void* data, size_t size, std::shared_ptr<void> holder = nullptr);
+
   /**
    * Run the executor.
    */
@@ -50,6 +80,9 @@ class Interpreter final {
 
   std::shared_ptr<hlir::framework::Scope> scope();
 
+  //! The target the model is loaded for.
+  const Target& target() const;
+
   ~Interpreter();
 
  private:
@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
 #include "cinn/runtime/use_extern_funcs.h"
 
 DEFINE_string(model_dir, "", "");
@@ -29,4 +33,79 @@ TEST(Interpreter, basic) {
   executor.GetTensor("fc_0.tmp_2");
 }
 
+namespace {
+
+const int kInputSize = 30;
+
+std::shared_ptr<float> AlignedFloats(size_t size) {
+  return std::shared_ptr<float>(static_cast<float*>(std::aligned_alloc(64, size * sizeof(float))), std::free);
+}
+
+void FillInput(float* data) {
+  for (int i = 0; i < kInputSize; i++) data[i] = static_cast<float>(i % 7) / 7.f - 0.5f;
+}
+
+std::vector<float> RunWithoutBinding() {
+  Interpreter executor({"A"}, {{1, kInputSize}});
+  executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+  FillInput(executor.GetTensor("A")->mutable_data<float>(common::DefaultHostTarget()));
+  executor.Run();
+  auto out = executor.GetTensor("fc_0.tmp_2");
+  return std::vector<float>(out->data<float>(), out->data<float>() + out->shape().numel());
+}
+
+}  // namespace
+
+TEST(Interpreter, bind_aligned_input) {
+  auto expected = RunWithoutBinding();
+  Interpreter executor({"A"}, {{1, kInputSize}});
+  executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+  auto input = AlignedFloats(kInputSize);
+  executor.BindInput("A", input.get(), kInputSize * sizeof(float), input);
+  // the aligned memory is read directly without a copy
+  ASSERT_EQ(executor.GetTensor("A")->buffer()->memory, reinterpret_cast<uint8_t*>(input.get()));
+  FillInput(input.get());
+  executor.Run();
+  auto out = executor.GetTensor("fc_0.tmp_2");
+  ASSERT_EQ(out->shape().numel(), expected.size());
+  for (int i = 0; i < expected.size(); i++) {
+    ASSERT_FLOAT_EQ(out->data<float>()[i], expected[i]);
+  }
+}
+
+TEST(Interpreter, bind_misaligned_input) {
+  auto expected = RunWithoutBinding();
+  Interpreter executor({"A"}, {{1, kInputSize}});
+  executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+  auto memory  = AlignedFloats(kInputSize + 1);
+  float* input = memory.get() + 1;
+  executor.BindInput("A", input, kInputSize * sizeof(float), memory);
+  // the misaligned memory is copied to the staging memory of the tensor at each run
+  ASSERT_NE(executor.GetTensor("A")->buffer()->memory, reinterpret_cast<uint8_t*>(input));
+  FillInput(input);
+  executor.Run();
+  auto out = executor.GetTensor("fc_0.tmp_2");
+  ASSERT_EQ(out->shape().numel(), expected.size());
+  for (int i = 0; i < expected.size(); i++) {
+    ASSERT_FLOAT_EQ(out->data<float>()[i], expected[i]);
+  }
+}
+
+TEST(Interpreter, bind_output) {
+  auto expected = RunWithoutBinding();
+  Interpreter executor({"A"}, {{1, kInputSize}});
+  executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+  FillInput(executor.GetTensor("A")->mutable_data<float>(common::DefaultHostTarget()));
+  auto output = AlignedFloats(expected.size());
+  executor.BindOutput("fc_0.tmp_2", output.get(), expected.size() * sizeof(float), output);
+  for (int run = 0; run < 2; run++) {
+    executor.Run();
+    // the output is written to the bound memory, which is never reallocated by the run
+    ASSERT_EQ(executor.GetTensor("fc_0.tmp_2")->buffer()->memory, reinterpret_cast<uint8_t*>(output.get()));
+    for (int i = 0; i < expected.size(); i++) {
+      ASSERT_FLOAT_EQ(output.get()[i], expected[i]);
+    }
+  }
+}
+
 }  // namespace cinn::frontend
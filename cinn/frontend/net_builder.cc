@@ -205,6 +205,14 @@ Variable NetBuilder::softmax(const Variable& a, int axis, const std::string& dat
   return instr.GetOutput(0);
 }
 
+Variable NetBuilder::log_softmax(const Variable& a, int axis) {
+  Instruction instr("log_softmax", {a});
+  instr.SetAttr("axis", axis);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 Variable NetBuilder::sigmoid(const Variable& a) {
   Instruction instr("sigmoid", {a});
   InferShape(instr);
@@ -126,6 +126,11 @@ class NetBuilder : public BaseBuilder {
 
   Variable softmax(const Variable& a, int axis = -1, const std::string& data_format = "AnyLayout");
 
+  /**
+   * Compute log(softmax(a)) along the axis without evaluating the softmax first.
+   */
+  Variable log_softmax(const Variable& a, int axis = -1);
+
   Variable sigmoid(const Variable& a);
 
   Variable slice(const Variable& a,
@@ -14,6 +14,7 @@
 
 #include "cinn/frontend/paddle/model_parser.h"
 
+#include <cstring>
 #include <fstream>
 #include <vector>
 
@@ -23,6 +24,8 @@
 #include "cinn/backends/cuda_util.h"
 #include "cinn/common/common.h"
 #include "cinn/frontend/paddle/compatible_pb.h"
+#include "cinn/utils/functional.h"
+#include "cinn/utils/mapped_file.h"
 
 namespace cinn::frontend::paddle {
 
@@ -129,6 +132,142 @@ void LoadLoDTensor(std::istream &is, hlir::framework::Variable *var, const commo
   TensorFromStream(is, tensor.operator->(), target);
 }
 
+namespace {
+
+// Return \p size bytes at \p offset of a mapped file, and move the offset forward.
+const char *ReadMapped(const utils::MappedFile &file, size_t *offset, size_t size) {
+  CHECK_LE(*offset + size, file.size()) << "Unexpected end of file " << file.path();
+  const char *res = file.data() + *offset;
+  *offset += size;
+  return res;
+}
+
+template <typename T>
+T ReadMappedPOD(const utils::MappedFile &file, size_t *offset) {
+  T res;
+  std::memcpy(&res, ReadMapped(file, offset, sizeof(T)), sizeof(T));
+  return res;
+}
+
+Type TypeOfVarType(framework_proto::VarType::Type type) {
+  using VarType = framework_proto::VarType::Type;
+  switch (static_cast<int>(type)) {
+    case VarType::VarType_Type_FP32:
+      return Float(32);
+    case VarType::VarType_Type_INT8:
+      return Int(8);
+    case VarType::VarType_Type_INT16:
+      return Int(16);
+    case VarType::VarType_Type_INT32:
+      return Int(32);
+    case VarType::VarType_Type_INT64:
+      return Int(64);
+    default:
+      LOG(FATAL) << "unknown type " << type;
+  }
+  return Type();
+}
+
+//! A tensor located in a mapped file with its desc parsed, its data is not read yet.
+struct MappedTensor {
+  framework_proto::VarType::TensorDesc desc;
+  const char *data;
+  size_t size;
+};
+
+// Locate the tensor at \p offset of a mapped file and move the offset past it.
+MappedTensor LocateTensor(const utils::MappedFile &file, size_t *offset) {
+  auto version = ReadMappedPOD<uint32_t>(file, offset);
+  CHECK_EQ(version, 0U) << "Only version 0 is supported";
+  MappedTensor res;
+  auto desc_size = ReadMappedPOD<int32_t>(file, offset);
+  CHECK(res.desc.ParseFromArray(ReadMapped(file, offset, desc_size), desc_size)) << "Cannot parse tensor desc";
+  size_t numel = 1;
+  for (auto dim : res.desc.dims()) numel *= dim;
+  res.size = numel * SizeOfType(res.desc.data_type());
+  res.data = ReadMapped(file, offset, res.size);
+  return res;
+}
+
+// Locate the LoDTensor at \p offset of a mapped file and move the offset past it, the LoD is skipped.
+MappedTensor LocateLoDTensor(const utils::MappedFile &file, size_t *offset) {
+  auto version = ReadMappedPOD<uint32_t>(file, offset);
+  CHECK_EQ(version, 0U) << "Only version 0 is supported";
+  auto lod_level = ReadMappedPOD<uint64_t>(file, offset);
+  for (uint64_t i = 0; i < lod_level; ++i) {
+    auto size = ReadMappedPOD<uint64_t>(file, offset);
+    ReadMapped(file, offset, size);
+  }
+  return LocateTensor(file, offset);
+}
+
+void TensorFromMapped(const std::shared_ptr<utils::MappedFile> &file,
+                      const MappedTensor &mapped,
+                      hlir::framework::_Tensor_ *tensor,
+                      const common::Target &target) {
+  std::vector<int32_t> dims_vec(mapped.desc.dims().begin(), mapped.desc.dims().end());
+  tensor->Resize(hlir::framework::Shape(dims_vec));
+  size_t size      = mapped.size;
+  const char *data = mapped.data;
+  if (target.arch == Target::Arch::X86) {
+    Type type = TypeOfVarType(mapped.desc.data_type());
+    // the kernels only assume the memory is aligned to the element, copy only if the data is misaligned to it
+    size_t alignment = type.bits() / 8;
+    if (reinterpret_cast<uintptr_t>(data) % alignment == 0) {
+      tensor->ShareExternalData(const_cast<char *>(data), type, target, file);
+    } else {
+      VLOG(4) << "Copy the misaligned parameter at offset " << data - file->data() << " of " << file->path();
+      void *buf;
+      switch (type.bits()) {
+        case 8:
+          buf = tensor->mutable_data<int8_t>(target);
+          break;
+        case 16:
+          buf = tensor->mutable_data<int16_t>(target);
+          break;
+        case 32:
+          buf = tensor->mutable_data<int32_t>(target);
+          break;
+        default:
+          buf = tensor->mutable_data<int64_t>(target);
+      }
+      tensor->set_type(type);
+      std::memcpy(buf, data, size);
+    }
+  } else if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    if (mapped.desc.data_type() != framework_proto::VarType::Type::VarType_Type_FP32)
+      LOG(FATAL) << "[CUDA] The type is not fp32!!";
+    auto *buf = tensor->mutable_data<float>(target);
+    tensor->set_type(Float(32));
+    CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(buf), data, size, cudaMemcpyHostToDevice));
+#else
+    LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+#endif
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
+}  // namespace
+
+void TensorFromMappedFile(const std::shared_ptr<utils::MappedFile> &file,
+                          size_t *offset,
+                          hlir::framework::_Tensor_ *tensor,
+                          const common::Target &target) {
+  CHECK(file);
+  TensorFromMapped(file, LocateTensor(*file, offset), tensor, target);
+}
+
+void LoadLoDTensor(const std::shared_ptr<utils::MappedFile> &file,
+                   size_t *offset,
+                   hlir::framework::Variable *var,
+                   const common::Target &target) {
+  CHECK(file);
+  auto &tensor = absl::get<hlir::framework::Tensor>(*var);
+  TensorFromMapped(file, LocateLoDTensor(*file, offset), tensor.operator->(), target);
+}
+
 void ReadBinaryFile(const std::string &filename, std::string *contents) {
   std::ifstream fin(filename, std::ios::in | std::ios::binary);
   CHECK(fin.is_open()) << "Cannot open file: " << filename;
@@ -144,9 +283,9 @@ void ReadBinaryFile(const std::string &filename, std::string *contents) {
 std::unique_ptr<framework_proto::ProgramDesc> LoadProgram(const std::string &path, bool program_from_memory) {
   std::unique_ptr<framework_proto::ProgramDesc> main_program(new framework_proto::ProgramDesc);
   if (!program_from_memory) {
-    std::string desc_str;
-    ReadBinaryFile(path, &desc_str);
-    main_program->ParseFromString(desc_str);
+    auto file = utils::MappedFile::Open(path);
+    CHECK(file) << "Cannot open file: " << path;
+    CHECK(main_program->ParseFromArray(file->data(), file->size())) << "Cannot parse program " << path;
   } else {
     main_program->ParseFromString(path);
   }
@@ -205,9 +344,24 @@ void LoadCombinedParamsPb(const std::string &path,
     std::stringstream fin(path, std::ios::in | std::ios::binary);
     load_var_func(fin);
   } else {
-    std::ifstream fin(path, std::ios::binary);
-    CHECK(fin.is_open());
-    load_var_func(fin);
+    // The parameters reference the mapped file directly, which is unmapped once none of them does.
+    auto file = utils::MappedFile::Open(path);
+    CHECK(file) << "Cannot open file: " << path;
+    // Locate the parameters and create their vars first, each desc is parsed only once, then decode them in
+    // parallel. The data of the aligned ones is not read here but paged in on the first access.
+    std::vector<MappedTensor> tensors;
+    std::vector<hlir::framework::Variable *> vars;
+    size_t offset = 0;
+    for (auto &param : paramlist) {
+      tensors.push_back(LocateLoDTensor(*file, &offset));
+      vars.push_back(scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(param)));
+    }
+    CHECK_EQ(offset, file->size()) << "You are not allowed to load partial data via"
+                                   << " LoadCombinedParamsPb, use LoadParam instead.";
+    utils::ParallelFor(0, paramlist.size(), [&](int i) {
+      auto &tensor = absl::get<hlir::framework::Tensor>(*vars[i]);
+      TensorFromMapped(file, tensors[i], tensor.operator->(), target);
+    });
   }
 }
 
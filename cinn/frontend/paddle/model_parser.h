@@ -25,6 +25,7 @@
 #include "cinn/frontend/paddle/pb/program_desc.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/framework/tensor.h"
+#include "cinn/utils/mapped_file.h"
 
 namespace cinn::frontend::paddle {
 namespace framework_proto = ::paddle::framework::proto;
@@ -63,4 +64,15 @@ void TensorFromStream(std::istream& is,
                       const common::Target& target = common::DefaultHostTarget());
 void ReadBinaryFile(const std::string& filename, std::string* contents);
 
+// Load a tensor from a memory-mapped file at \p offset and move the offset past it. On X86 the tensor references the
+// mapped memory directly if it is aligned to the element, and holds the mapping alive.
+void TensorFromMappedFile(const std::shared_ptr<utils::MappedFile>& file,
+                          size_t* offset,
+                          hlir::framework::_Tensor_* tensor,
+                          const common::Target& target = common::DefaultHostTarget());
+void LoadLoDTensor(const std::shared_ptr<utils::MappedFile>& file,
+                   size_t* offset,
+                   hlir::framework::Variable* var,
+                   const common::Target& target);
+
 }  // namespace cinn::frontend::paddle
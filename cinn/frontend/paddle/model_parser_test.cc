@@ -17,6 +17,8 @@
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <fstream>
+
 DEFINE_string(model_dir, "<NOTEXIST>", "model directory path");
 
 namespace cinn::frontend::paddle {
@@ -42,4 +44,51 @@ TEST(LoadModelPb, naive_model) {
   // fetch
 }
 
+void WriteLoDTensor(std::ostream& os, const std::vector<int64_t>& dims, const std::vector<float>& data) {
+  uint32_t version   = 0;
+  uint64_t lod_level = 0;
+  os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  os.write(reinterpret_cast<const char*>(&lod_level), sizeof(lod_level));
+  os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  framework_proto::VarType::TensorDesc desc;
+  desc.set_data_type(framework_proto::VarType::FP32);
+  for (auto dim : dims) desc.add_dims(dim);
+  std::string desc_str = desc.SerializeAsString();
+  int32_t size         = desc_str.size();
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  os.write(desc_str.data(), size);
+  os.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+}
+
+TEST(LoadLoDTensor, mapped_file) {
+  std::string path = "./test_model_parser_mapped_params";
+  std::vector<float> data0(6), data1(35);
+  for (int i = 0; i < data0.size(); i++) data0[i] = i;
+  for (int i = 0; i < data1.size(); i++) data1[i] = -i;
+  {
+    std::ofstream os(path, std::ios::binary);
+    WriteLoDTensor(os, {2, 3}, data0);
+    WriteLoDTensor(os, {5, 7}, data1);
+  }
+
+  hlir::framework::Scope scope;
+  auto* var0    = scope.Var<hlir::framework::Tensor>("var0");
+  auto* var1    = scope.Var<hlir::framework::Tensor>("var1");
+  auto file     = utils::MappedFile::Open(path);
+  size_t offset = 0;
+  ASSERT_TRUE(file);
+  LoadLoDTensor(file, &offset, var0, common::DefaultHostTarget());
+  LoadLoDTensor(file, &offset, var1, common::DefaultHostTarget());
+  ASSERT_EQ(offset, file->size());
+  file.reset();
+
+  auto tensor0 = absl::get<hlir::framework::Tensor>(*var0);
+  auto tensor1 = absl::get<hlir::framework::Tensor>(*var1);
+  ASSERT_EQ(tensor0->shape().data(), std::vector<int>({2, 3}));
+  ASSERT_EQ(tensor1->shape().data(), std::vector<int>({5, 7}));
+  // the tensors keep the mapping alive
+  for (int i = 0; i < data0.size(); i++) ASSERT_EQ(tensor0->data<float>()[i], data0[i]);
+  for (int i = 0; i < data1.size(); i++) ASSERT_EQ(tensor1->data<float>()[i], data1[i]);
+}
+
 }  // namespace cinn::frontend::paddle
@@ -70,6 +70,7 @@ void PaddleModelToProgram::AddOpMapper_fetch() {
     CHECK_EQ(op_desc.Input("X").size(), 1UL);
     auto output_name = op_desc.Input("X").front();
     LOG(INFO) << "detect model output: [" << output_name << "]";
+    fetch_ids_.insert(GetVar(utils::TransValidVarName(output_name))->id);
   };
 }
 
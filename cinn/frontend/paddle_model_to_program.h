@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -92,6 +93,8 @@ class PaddleModelToProgram {
 
   const absl::flat_hash_map<std::string, Variable>& var_map() const { return var_map_; }
   const absl::flat_hash_map<std::string, std::string>& var_model_to_program_map() { return var_model_to_program_map_; }
+  //! The ids of the program variables fetched by the model.
+  const std::unordered_set<std::string>& fetch_ids() const { return fetch_ids_; }
 
  protected:
   void AddVar(const std::string& name, const Variable& var, bool replace = false);
@@ -108,6 +111,7 @@ class PaddleModelToProgram {
   absl::flat_hash_map<std::string, Variable> var_map_;
   // map from var in Paddle model to var name in program.
   absl::flat_hash_map<std::string, std::string> var_model_to_program_map_;
+  std::unordered_set<std::string> fetch_ids_;
   hlir::framework::Scope* scope_{};
   common::Target target_;
 };
@@ -0,0 +1,118 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+#include "cinn/frontend/program_pass.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+/**
+ * Remove the instructions computing the same op with the same inputs and attributes as an earlier instruction, and
+ * let the users of their outputs read the outputs of the earlier one instead.
+ */
+class CommonSubexpressionEliminatePass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) const override {
+    absl::flat_hash_map<std::string, Instruction> instr_map;
+    absl::flat_hash_map<std::string, Variable> var_map;
+    std::vector<Instruction> instrs;
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      for (auto& input : instr->inputs) {
+        auto it = var_map.find(input->id);
+        if (it != var_map.end()) input = it->second;
+      }
+
+      auto key = GetKey(instr);
+      auto it  = instr_map.find(key);
+      if (it == instr_map.end() || IsFetched(instr, fetch_ids) ||
+          it->second->outputs.size() != instr->outputs.size()) {
+        instr_map.emplace(key, instr);
+        instrs.push_back(instr);
+        continue;
+      }
+      VLOG(3) << "Remove the duplicated instruction: " << instr;
+      for (size_t j = 0; j < instr->outputs.size(); j++) {
+        var_map[instr->outputs[j]->id] = it->second->outputs[j];
+      }
+    }
+    VLOG(3) << "CommonSubexpressionEliminate removes " << prog->size() - instrs.size() << " instructions";
+    if (instrs.size() == prog->size()) return;
+    std::vector<Variable> inputs = prog->GetInputs();
+    *prog                        = Program(std::move(instrs), std::move(inputs));
+  }
+
+ private:
+  static bool IsFetched(const Instruction& instr, const std::unordered_set<std::string>& fetch_ids) {
+    for (auto& output : instr->outputs) {
+      if (fetch_ids.count(output->id)) return true;
+    }
+    return false;
+  }
+
+  // The op type, inputs and attributes identify the computation of an instruction.
+  static std::string GetKey(const Instruction& instr) {
+    struct Visit {
+      std::stringstream& s_;
+      explicit Visit(std::stringstream& s) : s_(s) {}
+      void operator()(int x) { s_ << "i" << x; }
+      void operator()(float x) { s_ << "f" << x; }
+      void operator()(bool x) { s_ << (x ? "true" : "false"); }
+      void operator()(const std::string& x) { s_ << "s" << x; }
+      void operator()(const std::vector<int>& x) { s_ << "i[" + utils::Join(x, ",") + "]"; }
+      void operator()(const std::vector<float>& x) { s_ << "f[" + utils::Join(x, ",") + "]"; }
+      void operator()(const std::vector<bool>& x) { s_ << "b[" + utils::Join(x, ",") + "]"; }
+      void operator()(const std::vector<std::string>& x) { s_ << "s[" + utils::Join(x, ",") + "]"; }
+    };
+
+    std::stringstream ss;
+    ss.precision(9);
+    ss << instr->op_type << "(";
+    for (auto& input : instr->inputs) {
+      ss << input->id << ",";
+    }
+    ss << ")";
+    std::vector<std::string> attr_names;
+    for (auto& attr : instr->attrs) {
+      attr_names.push_back(attr.first);
+    }
+    std::sort(attr_names.begin(), attr_names.end());
+    for (auto& name : attr_names) {
+      ss << name << "=";
+      absl::visit(Visit{ss}, instr->attrs.at(name));
+      ss << ";";
+    }
+    return ss.str();
+  }
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(CommonSubexpressionEliminate) {
+  CINN_REGISTER_PROGRAM_PASS(CommonSubexpressionEliminate, ::cinn::frontend::pass::CommonSubexpressionEliminatePass);
+
+  return true;
+}
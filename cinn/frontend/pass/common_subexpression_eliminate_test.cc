@@ -0,0 +1,56 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+
+namespace cinn::frontend {
+
+TEST(CommonSubexpressionEliminate, basic) {
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {32, 24});
+  auto b       = builder.CreateInput(Float(32), {32, 24});
+  auto c       = builder.add(a, b);
+  auto d       = builder.add(a, b);
+  auto e       = builder.relu(c);
+  auto f       = builder.relu(d);
+  auto g       = builder.elementwise_mul(e, f);
+  auto program = builder.Build();
+  ASSERT_EQ(program.size(), 5UL);
+
+  ProgramPass::Apply(&program, {g->id}, common::DefaultHostTarget(), {"CommonSubexpressionEliminate"});
+  for (int i = 0; i < program.size(); i++) {
+    LOG(INFO) << "instruction: " << program[i];
+  }
+  ASSERT_EQ(program.size(), 3UL);
+  // both inputs of the last instruction are the output of the first relu
+  ASSERT_EQ(program[2]->inputs[0]->id, e->id);
+  ASSERT_EQ(program[2]->inputs[1]->id, e->id);
+}
+
+TEST(CommonSubexpressionEliminate, keep_fetched) {
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {32, 24});
+  auto c       = builder.relu(a);
+  auto d       = builder.relu(a);
+  auto program = builder.Build();
+
+  ProgramPass::Apply(&program, {c->id, d->id}, common::DefaultHostTarget(), {"CommonSubexpressionEliminate"});
+  ASSERT_EQ(program.size(), 2UL);
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,77 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unordered_set>
+
+#include "cinn/frontend/program_pass.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+/**
+ * Remove the instructions whose outputs are neither fetched nor used by the fetched variables.
+ * Nothing is removed if no fetch target is declared.
+ */
+class DeadCodeEliminatePass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) const override {
+    if (fetch_ids.empty()) {
+      VLOG(3) << "No fetch target is declared, skip DeadCodeEliminate";
+      return;
+    }
+    std::unordered_set<std::string> used_ids(fetch_ids.begin(), fetch_ids.end());
+    std::vector<bool> is_alive(prog->size(), false);
+    for (int i = static_cast<int>(prog->size()) - 1; i >= 0; i--) {
+      auto& instr = (*prog)[i];
+      for (auto& output : instr->outputs) {
+        if (used_ids.count(output->id)) {
+          is_alive[i] = true;
+          break;
+        }
+      }
+      if (!is_alive[i]) {
+        VLOG(3) << "Remove the dead instruction: " << instr;
+        continue;
+      }
+      for (auto& input : instr->inputs) {
+        used_ids.insert(input->id);
+      }
+    }
+
+    std::vector<Instruction> instrs;
+    for (size_t i = 0; i < prog->size(); i++) {
+      if (is_alive[i]) instrs.push_back((*prog)[i]);
+    }
+    VLOG(3) << "DeadCodeEliminate removes " << prog->size() - instrs.size() << " instructions";
+    if (instrs.size() == prog->size()) return;
+    CHECK(!instrs.empty()) << "None of the fetch targets is computed by the program";
+    std::vector<Variable> inputs = prog->GetInputs();
+    *prog                        = Program(std::move(instrs), std::move(inputs));
+  }
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(DeadCodeEliminate) {
+  CINN_REGISTER_PROGRAM_PASS(DeadCodeEliminate, ::cinn::frontend::pass::DeadCodeEliminatePass);
+
+  return true;
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+
+namespace cinn::frontend {
+
+TEST(DeadCodeEliminate, basic) {
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {32, 24});
+  auto b       = builder.CreateInput(Float(32), {32, 24});
+  auto c       = builder.add(a, b);
+  auto d       = builder.relu(a);
+  auto e       = builder.relu(c);
+  auto program = builder.Build();
+  ASSERT_EQ(program.size(), 3UL);
+
+  // nothing is removed without fetch targets
+  ProgramPass::Apply(&program, common::DefaultHostTarget(), {"DeadCodeEliminate"});
+  ASSERT_EQ(program.size(), 3UL);
+
+  ProgramPass::Apply(&program, {e->id}, common::DefaultHostTarget(), {"DeadCodeEliminate"});
+  for (int i = 0; i < program.size(); i++) {
+    LOG(INFO) << "instruction: " << program[i];
+  }
+  ASSERT_EQ(program.size(), 2UL);
+  ASSERT_EQ(program[0]->outputs[0]->id, c->id);
+  ASSERT_EQ(program[1]->outputs[0]->id, e->id);
+}
+
+}  // namespace cinn::frontend
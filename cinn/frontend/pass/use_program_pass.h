@@ -17,3 +17,5 @@
 #include "cinn/common/macros.h"
 
 CINN_USE_REGISTER(Decomposer)
+CINN_USE_REGISTER(CommonSubexpressionEliminate)
+CINN_USE_REGISTER(DeadCodeEliminate)
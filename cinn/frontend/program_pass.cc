@@ -17,14 +17,17 @@
 namespace cinn {
 namespace frontend {
 
-void ProgramPass::Apply(Program* prog, const common::Target& target, const std::vector<std::string>& passes) {
+void ProgramPass::Apply(Program* prog,
+                        const std::unordered_set<std::string>& fetch_ids,
+                        const common::Target& target,
+                        const std::vector<std::string>& passes) {
   std::vector<const ProgramPass*> fpass;
   for (auto& name : passes) {
     auto pass = ProgramPassRegistry::Global()->Get(name);
     fpass.push_back(pass);
   }
   for (auto& pass : fpass) {
-    pass->ApplyImpl(prog, target);
+    pass->ApplyImpl(prog, fetch_ids, target);
   }
 }
 
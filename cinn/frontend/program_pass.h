@@ -17,6 +17,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cinn/frontend/syntax.h"
@@ -32,11 +33,20 @@ class ProgramPass {
   /**
    * \brief Apply a sequence of passes on a program.
    * @param prog The input program to apply passes on.
+   * @param fetch_ids The ids of the variables fetched by the user, empty means all the variables might be fetched.
    * @param passes The sequence of pass.
    * @return The program after being modified by the passes.
    */
-  static void Apply(Program* prog, const common::Target& target, const std::vector<std::string>& passes);
-  virtual void ApplyImpl(Program* prog, const common::Target& target) const {}
+  static void Apply(Program* prog,
+                    const std::unordered_set<std::string>& fetch_ids,
+                    const common::Target& target,
+                    const std::vector<std::string>& passes);
+  static void Apply(Program* prog, const common::Target& target, const std::vector<std::string>& passes) {
+    Apply(prog, {}, target, passes);
+  }
+  virtual void ApplyImpl(Program* prog,
+                         const std::unordered_set<std::string>& fetch_ids,
+                         const common::Target& target) const {}
 
   const std::string& name() { return name_; }
 
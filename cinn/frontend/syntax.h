@@ -23,6 +23,7 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -416,12 +417,13 @@ struct Program {
  * Load a Paddle model and return a frontend program.
  * @param model_dir The directory of the model.
  * @param is_combined Whether the parameters in the Paddle model is combined.
- * @returns program, a map from name to variable and a map from variable name in Paddle model to the corresponding in
- * program
+ * @returns program, a map from name to variable, a map from variable name in Paddle model to the corresponding in
+ * program and the ids of the variables fetched by the model
  */
 std::tuple<std::unique_ptr<Program>,
            absl::flat_hash_map<std::string, Variable>,
-           absl::flat_hash_map<std::string, std::string>>
+           absl::flat_hash_map<std::string, std::string>,
+           std::unordered_set<std::string>>
 LoadPaddleProgram(const std::string& model_dir,
                   hlir::framework::Scope* scope,
                   bool is_combined,
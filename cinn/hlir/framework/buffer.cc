@@ -14,6 +14,8 @@
 
 #include "cinn/hlir/framework/buffer.h"
 
+#include <utility>
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -47,6 +49,22 @@ void Buffer::SetTarget(const common::Target& target) {
   memory_mng_cache_ = MemoryManager::Global().RetrieveSafely(target_.arch);
 }
 
+void Buffer::ShareExternalMemory(void* memory,
+                                 uint32_t size,
+                                 const common::Target& target,
+                                 std::shared_ptr<void> holder) {
+  if (data_.memory && (memory_mng_cache_ || external_)) {
+    Free();
+  }
+  SetTarget(target);
+  data_.memory = reinterpret_cast<uint8_t*>(memory);
+  // the runtime allocates the memory of an output buffer only if its memory_size is not large enough
+  data_.memory_size = size;
+  size_             = size;
+  external_         = true;
+  external_holder_  = std::move(holder);
+}
+
 void Buffer::ResizeLazy(uint32_t size) {
   if (size <= size_) return;
   Resize(size);
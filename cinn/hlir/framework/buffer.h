@@ -53,12 +53,26 @@ struct Buffer final {
 
   void SetTarget(const common::Target& target);
 
+  /**
+   * Let this buffer reference the memory \p memory of \p size bytes which is owned by others, \p holder keeps the
+   * memory alive while it is referenced, it can be null if the caller keeps the memory alive. The buffer allocates its
+   * own memory again once it is resized to be larger.
+   */
+  void ShareExternalMemory(void* memory, uint32_t size, const common::Target& target, std::shared_ptr<void> holder);
+
   const cinn_buffer_t* data() const { return &data_; }
   cinn_buffer_t* data() { return &data_; }
 
   //! Free all the memory owned by this buffer.
   void Free() {
     if (!data_.memory) return;
+    if (external_holder_ || external_) {
+      external_holder_.reset();
+      external_         = false;
+      data_.memory      = nullptr;
+      data_.memory_size = 0;
+      return;
+    }
     memory_mng_cache_->free(data_.memory);
   }
 
@@ -84,6 +98,11 @@ struct Buffer final {
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! Keep the external memory referenced by this buffer alive.
+  std::shared_ptr<void> external_holder_;
+  //! Whether the memory is owned by others.
+  bool external_{false};
 };
 
 }  // namespace framework
@@ -51,8 +51,19 @@ Graph::Graph(const frontend::Program& prog, const Target& target) {
     }
     this->RegisterNode(node_tmp->id(), node_tmp);
   }
+  std::vector<std::string> feed_names;
+  for (auto& var : prog.GetInputs()) {
+    feed_names.push_back(var->id);
+  }
   this->attrs["infershape"] = std::make_shared<absl::any>(shape_dict);
   this->attrs["inferdtype"] = std::make_shared<absl::any>(dtype_dict);
+  this->attrs["feed_names"] = std::make_shared<absl::any>(feed_names);
+}
+
+Graph::Graph(const frontend::Program& prog, const std::unordered_set<std::string>& fetch_ids, const Target& target)
+    : Graph(prog, target) {
+  std::vector<std::string> fetch_names(fetch_ids.begin(), fetch_ids.end());
+  this->attrs["fetch_names"] = std::make_shared<absl::any>(fetch_names);
 }
 
 }  // namespace framework
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "cinn/common/graph_utils.h"
@@ -35,6 +36,11 @@ namespace framework {
 class Graph : public cinn::common::Graph {
  public:
   Graph(const frontend::Program& prog, const Target& target);
+  /**
+   * @param fetch_ids The ids of the variables fetched by the user, saved as the "fetch_names" attr. The passes keep
+   * them computed as they are, besides the final outputs of the graph.
+   */
+  Graph(const frontend::Program& prog, const std::unordered_set<std::string>& fetch_ids, const Target& target);
 
   Target target_;
   /** \brief outputs of the computation graph. */
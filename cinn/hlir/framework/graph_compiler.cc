@@ -19,6 +19,7 @@
 #include <unordered_set>
 
 #include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/common/context.h"
 #include "cinn/hlir/framework/instruction.h"
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/pe/schedule.h"
@@ -52,6 +53,56 @@ void AddAttrs(const absl::flat_hash_map<std::string, AttrType>& attrs_store,
   }
 }
 
+std::future<void> Program::ExecuteAsync(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  std::packaged_task<void()> run([this, name2podargs] {
+    for (auto& ins : instrs_) {
+      ins->Run(name2podargs);
+    }
+#ifdef CINN_WITH_CUDA
+    if (instrs_[0]->target_.arch == Target::Arch::NVGPU) {
+      // only wait for the kernels launched before, the later runs and other streams are not blocked
+      cudaEvent_t event;
+      CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming | cudaEventBlockingSync));
+      CUDA_CALL(cudaEventRecord(event, nullptr));
+      CUDA_CALL(cudaEventSynchronize(event));
+      CUDA_CALL(cudaEventDestroy(event));
+    }
+#endif
+  });
+  auto future = run.get_future();
+  {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if (!async_worker_.joinable()) {
+      async_worker_ = std::thread([this] {
+        while (true) {
+          std::packaged_task<void()> task;
+          {
+            std::unique_lock<std::mutex> lock(async_mutex_);
+            async_cv_.wait(lock, [this] { return async_stopped_ || !async_runs_.empty(); });
+            if (async_runs_.empty()) return;
+            task = std::move(async_runs_.front());
+            async_runs_.pop_front();
+          }
+          task();
+        }
+      });
+    }
+    async_runs_.push_back(std::move(run));
+  }
+  async_cv_.notify_one();
+  return future;
+}
+
+Program::~Program() {
+  {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    async_stopped_ = true;
+  }
+  async_cv_.notify_one();
+  // finish the runs issued before
+  if (async_worker_.joinable()) async_worker_.join();
+}
+
 void GraphCompiler::PrintFunc() {
   auto topo_order = graph_->topological_order();
   auto& nodes     = std::get<0>(topo_order);
@@ -368,6 +419,9 @@ std::unique_ptr<Program> GraphCompiler::Build(const std::string& code) {
 }
 
 GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::CompileOptions& options) {
+  std::unique_ptr<common::CompileSession> session;
+  if (options.with_session) session.reset(new common::CompileSession);
+
   auto topo_order = graph_->topological_order();
   auto& nodes     = std::get<0>(topo_order);
   auto& edges     = std::get<1>(topo_order);
@@ -411,6 +465,9 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   }
 
   compiler_->Build(build_module, options.attached_code);
+  // the stages lowered in the session are all released by now, free its isl ctx before the instructions are built
+  session.reset();
+
   if (options.with_instantiate_variables) {
     VLOG(3) << "Initantiate all variables on compile-time";
     // All variables reside in scope_, so traverse it to instantiate each one
@@ -576,7 +633,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
       std::string op_func_name = GenOpFuncName(node);
       auto* fn                 = compiler_->Lookup(op_func_name);
       CHECK(fn);
-      instr->SetLoweredFunc(fn);
+      instr->SetLoweredFunc(fn, op_func_name);
       int i                   = 1;
       std::string new_op_func = op_func_name + "_" + std::to_string(i);
       if (function2input_args_.count(new_op_func) != 0) {
@@ -587,7 +644,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
       while (function2input_args_.count(new_op_func) != 0) {
         auto* fn2 = compiler_->Lookup(new_op_func);
         CHECK(fn2);
-        instr->SetLoweredFunc(fn2);
+        instr->SetLoweredFunc(fn2, new_op_func);
         instr->AddInArgs(function2input_args_[new_op_func]);
         instr->AddOutArgs(function2output_args_[new_op_func]);
         i++;
@@ -638,7 +695,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
       VLOG(3) << "out_names: " << utils::Join(outputNames, ", ");
       auto* fn = compiler_->Lookup(fuse_name);
       CHECK(fn);
-      instr->SetLoweredFunc(fn);
+      instr->SetLoweredFunc(fn, fuse_name);
       instructions.push_back(std::move(instr));
     }
   }
@@ -676,6 +733,7 @@ std::shared_ptr<Scope> BuildScope(Target target, const std::shared_ptr<Graph>& g
     tensor->Resize(Shape{shape});
     CHECK(dtype_dict.at(iter.first) == Float(32) || dtype_dict.at(iter.first).is_bool())
         << "The dtype of node " << iter.first << " is not float or bool! Other dtype is not implemented yet.";
+    tensor->set_type(dtype_dict.at(iter.first));
   }
   return scope;
 }
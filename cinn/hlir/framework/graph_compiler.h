@@ -14,9 +14,14 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -74,6 +79,17 @@ class Program {
 #endif
   }
 
+  /**
+   * Execute the program on a dedicated thread and return at once, so that the caller can prepare the next run
+   * meanwhile. The runs are executed in the order they are issued, the future is ready once the run finishes.
+   * @param name2podargs The arguments of the run which should stay alive until the run finishes.
+   * On NVGPU the thread waits for the kernels of the run by an event instead of synchronizing the whole device.
+   * Execute should not be called while an asynchronous run is not finished.
+   */
+  std::future<void> ExecuteAsync(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr);
+
+  ~Program();
+
   void ExecuteTest(int repeat_) {
     cinn::utils::Timer timer1;
     for (int i = 0; i < 100; i++) {
@@ -100,6 +116,9 @@ class Program {
    */
   size_t size() const { return instrs_.size(); }
 
+  const std::vector<std::unique_ptr<Instruction>>& GetPreRunInstructions() const { return prerun_instrs_; }
+  const std::vector<std::unique_ptr<Instruction>>& GetRunInstructions() const { return instrs_; }
+
  private:
   // We need to hold scope to assure tensors alive used in instructions.
   std::shared_ptr<Scope> scope_;
@@ -107,6 +126,13 @@ class Program {
   std::vector<std::unique_ptr<Instruction>> prerun_instrs_;
   // only runtime instructions
   std::vector<std::unique_ptr<Instruction>> instrs_;
+
+  // the runs issued by ExecuteAsync, executed in order by async_worker_
+  std::mutex async_mutex_;
+  std::condition_variable async_cv_;
+  std::deque<std::packaged_task<void()>> async_runs_;
+  std::thread async_worker_;
+  bool async_stopped_{false};
 };
 
 /**
@@ -124,11 +150,20 @@ class GraphCompiler final {
   struct CompileOptions {
     std::string attached_code       = "";
     bool with_instantiate_variables = false;
+    //! Lower the graph in a CompileSession of its own, so the graphs can be compiled on multiple threads at once.
+    bool with_session = false;
   };
 
-  // Compile with a packing option and result, to be extended easily.
+  /**
+   * Compile with a packing option and result, to be extended easily.
+   *
+   * Without \p options.with_session the graph is lowered in the session active on the calling thread, or in the
+   * process-wide Context if there is none, which is not safe to share. So the Builds running on several threads at once
+   * should each set with_session or open a CompileSession of their own.
+   */
   CompilationResult Build(const CompileOptions& options);
 
+  //! Compile without a session of its own, see Build(const CompileOptions&) for building on several threads.
   std::unique_ptr<Program> Build(const std::string& code = "");
 
   std::string GenSourceCode();
@@ -137,6 +172,8 @@ class GraphCompiler final {
 
   const std::shared_ptr<Scope>& GetScope() const { return scope_; }
 
+  backends::Compiler* GetCompiler() const { return compiler_.get(); }
+
  private:
   std::vector<ir::LoweredFunc> GetOpFunc(const std::vector<Node*>& nodes);
 
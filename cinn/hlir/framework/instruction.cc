@@ -15,6 +15,8 @@
 #include "cinn/hlir/framework/instruction.h"
 
 #include "cinn/common/test_helper.h"
+#include "cinn/hlir/framework/profiler.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace hlir {
@@ -49,6 +51,47 @@ std::vector<cinn_pod_value_t>& Instruction::PreparePodArgs(
 }
 
 void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  if (!InstructionProfiler::Enabled()) {
+    RunImpl(name2podargs);
+    return;
+  }
+  bool count_hardware = InstructionProfiler::CountersEnabled();
+  utils::PerfCounters::Values counters;
+  if (count_hardware) counters = utils::PerfCounters::ThisThread().Read();
+  auto start = InstructionProfiler::Clock::now();
+  RunImpl(name2podargs);
+#ifdef CINN_WITH_CUDA
+  if (target_.arch == Target::Arch::NVGPU) {
+    CUDA_CALL(cudaDeviceSynchronize());
+  }
+#endif
+  auto end = InstructionProfiler::Clock::now();
+  if (count_hardware) counters = utils::PerfCounters::Diff(counters, utils::PerfCounters::ThisThread().Read());
+
+  // the cost is only estimated at the first run
+  auto cost = [this] {
+    std::vector<Tensor> inputs, outputs;
+    auto collect = [this](const std::vector<std::vector<std::string>>& args_list, std::vector<Tensor>* tensors) {
+      for (auto& args : args_list) {
+        for (auto& arg : args) {
+          if (scope_->FindVar(arg)) tensors->push_back(scope_->GetTensor(arg));
+        }
+      }
+    };
+    collect(in_args_, &inputs);
+    collect(out_args_, &outputs);
+    auto res = EstimateInstructionCost(function_name_, inputs, outputs);
+    std::stringstream params;
+    if (!attrs.empty()) params << "attrs=[" << utils::Join(attrs, ",") << "]";
+    if (!str_attrs.empty()) params << (attrs.empty() ? "" : " ") << "str_attrs=[" << utils::Join(str_attrs, ",") << "]";
+    res.params = params.str();
+    return res;
+  };
+  const std::string& name = fn_names_.empty() || fn_names_[0].empty() ? function_name_ : fn_names_[0];
+  InstructionProfiler::Global().Record(this, name, start, end, cost, count_hardware ? &counters : nullptr);
+}
+
+void Instruction::RunImpl(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
   if (fn_.size() > 1 && fn_.size() != in_args_.size()) {
     out_args_.back()[0] = out_args_.front()[0];
     out_args_.erase(out_args_.begin());
@@ -57,11 +57,23 @@ class Instruction {
   /**
    * Set compiled function address.
    * @param fn The JIT compiled function address.
+   * @param fn_name The name of the function, to look it up again when the program is reloaded.
    */
-  void SetLoweredFunc(lower_func_ptr_t fn) { fn_.push_back(fn); }
+  void SetLoweredFunc(lower_func_ptr_t fn, const std::string& fn_name = "") {
+    fn_.push_back(fn);
+    fn_names_.push_back(fn_name);
+  }
+
+  //! Look up the functions by their names again, e.g. after the program is reloaded.
+  void ResolveLoweredFuncs(const std::function<lower_func_ptr_t(const std::string&)>& lookup) {
+    for (int i = 0; i < fn_.size(); i++) {
+      fn_[i] = lookup(fn_names_[i]);
+      CHECK(fn_[i]) << "Cannot find function " << fn_names_[i];
+    }
+  }
 
   /**
-   * Run the Instruction.
+   * Run the Instruction, and record the run if the InstructionProfiler is enabled.
    */
   void Run(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr);
 
@@ -69,12 +81,15 @@ class Instruction {
   std::vector<std::vector<std::string>> GetOutArgs() { return out_args_; }
   void AddInArgs(const std::vector<std::string>& in_args) { in_args_.push_back(in_args); }
   void AddOutArgs(const std::vector<std::string>& out_args) { out_args_.push_back(out_args); }
+  const std::string& function_name() const { return function_name_; }
+  const std::vector<std::string>& GetFnNames() const { return fn_names_; }
   std::vector<int> attrs;
   std::vector<std::string> str_attrs;
   bool pre_run = false;
   Target target_;
 
  protected:
+  void RunImpl(const std::map<std::string, cinn_pod_value_t>* name2podargs);
   std::vector<cinn_pod_value_t>& PreparePodArgs(int i, const std::map<std::string, cinn_pod_value_t>* name2podargs);
 
  private:
@@ -86,6 +101,7 @@ class Instruction {
   std::vector<std::vector<cinn_pod_value_t>> args_cached_;
 
   std::vector<lower_func_ptr_t> fn_{};
+  std::vector<std::string> fn_names_;
 };
 
 }  // namespace framework
@@ -0,0 +1,297 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/param_transform.h"
+
+#include <absl/container/flat_hash_map.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cinn/hlir/framework/node.h"
+#include "cinn/ir/layout.h"
+#include "cinn/utils/functional.h"
+#include "cinn/utils/mapped_file.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+struct ParamTransform {
+  Node* node;
+  NodeData* input;
+  NodeData* output;
+  std::string src_layout;
+  std::string dst_layout;
+  Tensor result;
+};
+
+// For each axis of the layout, return the stride of the axis in its primal axis, e.g. 16 for O and 1 for o in OIHW16o.
+std::vector<int> StridesInPrimalAxis(const ir::Layout& layout) {
+  std::vector<int> strides(layout.ndims(), 1);
+  for (int i = 0; i < layout.ndims(); i++) {
+    char name = layout.axis_names(i);
+    if (name >= 'a' && name <= 'z') {
+      auto primal = layout.axis_names().find(name - 'a' + 'A');
+      CHECK_NE(primal, std::string::npos);
+      strides[primal] *= layout[i]->upper_bound.as_int32();
+    }
+  }
+  return strides;
+}
+
+// The host version of pe::LayoutTransform, supports splitting and merging the sub-axes at the same time.
+void LayoutTransformOnHost(const float* src,
+                           const std::vector<int>& src_shape,
+                           const std::string& src_layout,
+                           float* dst,
+                           const std::vector<int>& dst_shape,
+                           const std::string& dst_layout) {
+  ir::Layout src_l(src_layout), dst_l(dst_layout);
+  CHECK_EQ(src_l.ndims(), src_shape.size());
+  CHECK_EQ(dst_l.ndims(), dst_shape.size());
+  auto dst_strides = StridesInPrimalAxis(dst_l);
+  auto src_strides = StridesInPrimalAxis(src_l);
+
+  // Number the primal axes once, so the index of each primal axis lives in a small array instead of a map.
+  std::string primals;
+  auto slot_of = [&](char name) {
+    char primal = name >= 'a' && name <= 'z' ? name - 'a' + 'A' : name;
+    auto slot   = primals.find(primal);
+    if (slot != std::string::npos) return static_cast<int>(slot);
+    primals.push_back(primal);
+    return static_cast<int>(primals.size()) - 1;
+  };
+  int ndims = dst_shape.size();
+  std::vector<int> dst_slots(ndims), src_slots(src_shape.size()), src_elem_strides(src_shape.size(), 1);
+  std::vector<bool> src_is_sub(src_shape.size());
+  for (int i = 0; i < ndims; i++) dst_slots[i] = slot_of(dst_l.axis_names(i));
+  for (int i = src_shape.size() - 1; i >= 0; i--) {
+    char name     = src_l.axis_names(i);
+    src_slots[i]  = slot_of(name);
+    src_is_sub[i] = name >= 'a' && name <= 'z';
+    if (i + 1 < src_shape.size()) src_elem_strides[i] = src_elem_strides[i + 1] * src_shape[i + 1];
+  }
+
+  int numel = 1;
+  for (int dim : dst_shape) numel *= dim;
+  std::vector<int> coords(ndims);
+  std::vector<int> primal_index(primals.size());
+  for (int idx = 0; idx < numel; idx++) {
+    std::fill(primal_index.begin(), primal_index.end(), 0);
+    for (int i = 0; i < ndims; i++) primal_index[dst_slots[i]] += coords[i] * dst_strides[i];
+    int src_idx = 0;
+    for (int i = 0; i < src_shape.size(); i++) {
+      int index = primal_index[src_slots[i]];
+      int coord = src_is_sub[i] ? index % src_shape[i] : index / src_strides[i];
+      src_idx += coord * src_elem_strides[i];
+    }
+    dst[idx] = src[src_idx];
+    // step the coordinates to the next element in the row-major order of dst
+    for (int i = ndims - 1; i >= 0 && ++coords[i] == dst_shape[i]; i--) coords[i] = 0;
+  }
+}
+
+// The cached file starts with a header of kCacheHeaderBytes, which keeps the data after it aligned for mapping.
+// Bump kCacheVersion when the transforms or the header change, so that the files written before are not used.
+constexpr char kCacheMagic[8]      = {'C', 'I', 'N', 'N', 'P', 'A', 'R', 'M'};
+constexpr uint64_t kCacheVersion   = 1;
+constexpr size_t kCacheHeaderBytes = 64;
+
+struct CacheHeader {
+  char magic[8];
+  uint64_t version;
+  uint64_t hash;
+  uint64_t size;
+};
+static_assert(sizeof(CacheHeader) <= kCacheHeaderBytes, "the cache header is too large");
+
+// The FNV-1a hash over the 8-byte words of the data, it is stable across processes unlike std::hash.
+uint64_t HashBytes(const char* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+  constexpr uint64_t kPrime = 1099511628211ULL;
+  size_t i                  = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kPrime;
+  }
+  for (; i < size; i++) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * kPrime;
+  }
+  return hash;
+}
+
+// The key of the parameter and the transform applied to it. A parameter loaded from a file is keyed by the identity
+// of the file (path, size and modification time), so the cache is hit without reading the parameter, and rewriting the
+// file never reuses the stale cached one. The other parameters are keyed by their contents.
+uint64_t CacheKey(const ParamTransform& transform, const Tensor& src, const std::string& param_file) {
+  std::string desc = transform.input->id() + ":" + transform.src_layout + "->" + transform.dst_layout + ":" +
+                     utils::Join(src->shape().data(), ",");
+  uint64_t hash    = HashBytes(desc.data(), desc.size());
+  hash             = HashBytes(reinterpret_cast<const char*>(&kCacheVersion), sizeof(kCacheVersion), hash);
+  struct stat st;
+  if (!param_file.empty() && ::stat(param_file.c_str(), &st) == 0) {
+    int64_t identity[3] = {static_cast<int64_t>(st.st_size), st.st_mtim.tv_sec, st.st_mtim.tv_nsec};
+    hash                = HashBytes(param_file.data(), param_file.size(), hash);
+    return HashBytes(reinterpret_cast<const char*>(identity), sizeof(identity), hash);
+  }
+  return HashBytes(reinterpret_cast<const char*>(src->data<float>()), src->shape().numel() * sizeof(float), hash);
+}
+
+std::string CacheFileName(const std::string& cache_dir, const ParamTransform& transform, uint64_t key) {
+  char hex[17];
+  std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));  // NOLINT
+  return cache_dir + "/" + transform.input->id() + "." + transform.dst_layout + "." + hex;
+}
+
+// Return the data in the cached \p file if it is written by this version for \p key with \p size bytes.
+char* ValidCacheData(utils::MappedFile* file, uint64_t key, size_t size) {
+  if (file->size() != kCacheHeaderBytes + size) return nullptr;
+  CacheHeader header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheVersion ||
+      header.hash != key || header.size != size) {
+    return nullptr;
+  }
+  return file->mutable_data() + kCacheHeaderBytes;
+}
+
+// Write the cached file to a temporary one first and rename it, so a crashed or concurrent writer never leaves a
+// partial file to be mapped by others.
+void WriteCacheFile(const std::string& path, uint64_t key, const float* data, size_t size) {
+  std::string tmp_path = path + ".tmp." + std::to_string(::getpid()) + "." +
+                         std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  {
+    std::ofstream os(tmp_path, std::ios::binary);
+    if (!os.is_open()) {
+      LOG(WARNING) << "Cannot cache the transformed parameter to " << path;
+      return;
+    }
+    char header_bytes[kCacheHeaderBytes] = {};
+    CacheHeader header;
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.hash    = key;
+    header.size    = size;
+    std::memcpy(header_bytes, &header, sizeof(header));
+    os.write(header_bytes, kCacheHeaderBytes);
+    os.write(reinterpret_cast<const char*>(data), size);
+    if (!os.good()) {
+      LOG(WARNING) << "Failed to write the cached parameter " << tmp_path;
+      os.close();
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to rename the cached parameter " << tmp_path << " to " << path;
+    std::remove(tmp_path.c_str());
+  }
+}
+
+}  // namespace
+
+int TransformParamsAtLoad(Graph* graph,
+                          Scope* scope,
+                          const Target& target,
+                          const std::string& cache_dir,
+                          const absl::flat_hash_map<std::string, std::string>& param_files) {
+  CHECK(graph);
+  CHECK(scope);
+  if (target.arch != Target::Arch::X86) return 0;
+  auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+
+  std::vector<ParamTransform> transforms;
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node || node->op()->name != "layout_transform") continue;
+    auto& attrs = node->attrs.attr_store;
+    if (!attrs.count("pre_run") || !absl::get<bool>(attrs.at("pre_run"))) continue;
+    auto in_links  = node->inlinks_in_order(true);
+    auto out_links = node->outlinks_in_order(true);
+    if (in_links.size() != 1U || out_links.size() != 1U) continue;
+    auto* input  = in_links[0]->source()->safe_as<NodeData>();
+    auto* output = out_links[0]->sink()->safe_as<NodeData>();
+    // only the parameters already loaded can be transformed
+    if (!input || !output || !input->inlinks().empty() || !scope->FindVar(input->id())) continue;
+    auto tensor = scope->GetTensor(input->id());
+    if (!tensor->buffer()->memory || tensor->type() != Float(32)) continue;
+    transforms.push_back({node,
+                          input,
+                          output,
+                          absl::get<std::string>(attrs.at("src_layout")),
+                          absl::get<std::string>(attrs.at("dst_layout")),
+                          Tensor()});
+  }
+
+  utils::ParallelFor(0, transforms.size(), [&](int i) {
+    auto& transform = transforms[i];
+    auto src        = scope->GetTensor(transform.input->id());
+    auto& dst_shape = shape_dict.at(transform.output->id());
+    transform.result->Resize(Shape(dst_shape));
+    size_t size = transform.result->shape().numel() * sizeof(float);
+    uint64_t key = 0;
+    std::string path;
+    if (!cache_dir.empty()) {
+      auto it    = param_files.find(transform.input->id());
+      key        = CacheKey(transform, src, it == param_files.end() ? "" : it->second);
+      path       = CacheFileName(cache_dir, transform, key);
+      auto file  = utils::MappedFile::Open(path);
+      char* data = file ? ValidCacheData(file.get(), key, size) : nullptr;
+      if (data) {
+        VLOG(3) << "Map the transformed parameter " << transform.output->id() << " from " << file->path();
+        transform.result->ShareExternalData(data, Float(32), target, file);
+        return;
+      }
+    }
+    auto* dst = transform.result->mutable_data<float>(target);
+    LayoutTransformOnHost(
+        src->data<float>(), src->shape().data(), transform.src_layout, dst, dst_shape, transform.dst_layout);
+    if (!cache_dir.empty()) {
+      WriteCacheFile(path, key, dst, size);
+    }
+  });
+
+  for (auto& transform : transforms) {
+    VLOG(3) << "Transform the parameter " << transform.input->id() << " from " << transform.src_layout << " to "
+            << transform.dst_layout << " at load time";
+    *scope->Var<Tensor>(transform.output->id()) = transform.result;
+    transform.input->UnLinkTo(transform.node);
+    transform.node->UnLinkTo(transform.output);
+    if (transform.input->outlinks().empty()) {
+      scope->EraseVar(transform.input->id());
+    }
+  }
+  absl::flat_hash_map<std::string, std::string> layout_dict;
+  graph->ClearUnlinkedNodes(&shape_dict, &dtype_dict, &layout_dict);
+  return transforms.size();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,50 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <absl/container/flat_hash_map.h>
+
+#include <string>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * Apply the layout transforms of the parameters directly to their tensors in the scope, instead of running them as
+ * pre_run instructions.
+ *
+ * The layout_transform nodes marked pre_run whose input is a parameter loaded in \p scope are computed on the host in
+ * parallel, their outputs are put into the scope as new parameters and the nodes are removed from the graph. The
+ * original parameters not used by any other op are erased from the scope, so no unpacked copy is kept.
+ *
+ * @param cache_dir If not empty, the transformed parameters are cached in this directory and mapped from the cached
+ * files next time. The cached files are keyed by the parameter and its transform, and carry a format version, so a
+ * changed parameter is transformed again instead of reusing the stale file.
+ * @param param_files The files the parameters are loaded from. The cache of such a parameter is keyed by the path, size
+ * and modification time of its file instead of by hashing its contents, the other parameters are hashed.
+ * @return the number of parameters transformed.
+ */
+int TransformParamsAtLoad(Graph* graph,
+                          Scope* scope,
+                          const Target& target,
+                          const std::string& cache_dir                                     = "",
+                          const absl::flat_hash_map<std::string, std::string>& param_files = {});
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,279 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/profiler.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+double NumelOf(const Tensor& tensor) { return tensor.defined() ? tensor->shape().numel() : 0; }
+
+double BytesOf(const Tensor& tensor) {
+  if (!tensor.defined()) return 0;
+  int bits = tensor->type().valid() ? tensor->type().bits() : 32;
+  return NumelOf(tensor) * ((bits + 7) / 8);
+}
+
+//! Whether the function \p name computes the op \p op, e.g. "mul" is in "fn_mul_1_fused" but not in "elementwise_mul".
+bool HasOp(const std::string& name, const std::string& op) {
+  for (size_t pos = name.find(op); pos != std::string::npos; pos = name.find(op, pos + 1)) {
+    bool begin       = pos == 0 || name[pos - 1] == '_';
+    bool end         = pos + op.size() == name.size() || name[pos + op.size()] == '_';
+    bool elementwise = pos >= 12 && name.compare(pos - 12, 12, "elementwise_") == 0;
+    if (begin && end && !elementwise) return true;
+  }
+  return false;
+}
+
+/**
+ * The multiply-adds of a conv per output element, i.e. in_channels / groups * kh * kw, counted as the direct conv
+ * whatever the algorithm is. The layout of the weight is told by its shape:
+ * - NCHW or NHWC: [out_channels, in_channels / groups, kh, kw]
+ * - NCHWc: [oc_chunk, ic_chunk, kh, kw, ic_bn, oc_bn]
+ * - Winograd on NCHW: [alpha, alpha, in_channels, out_channels] transformed from a 3x3 filter
+ */
+double ConvMacsPerOutput(const Tensor& input, const Tensor& weight, const Tensor& output) {
+  auto& w_shape = weight->shape().data();
+  if (w_shape.size() == 6U) {
+    return NumelOf(weight) / (static_cast<double>(w_shape[0]) * w_shape[5]);
+  }
+  if (w_shape.size() != 4U) return 0;
+  if (input.defined() && output.defined() && input->shape().data().size() == 4U &&
+      output->shape().data().size() == 4U) {
+    int alpha     = w_shape[0];
+    int in_chans  = input->shape().data()[1];
+    int out_chans = output->shape().data()[1];
+    if ((alpha == 4 || alpha == 6) && w_shape[1] == alpha && w_shape[2] == in_chans && w_shape[3] == out_chans) {
+      return 3. * 3 * in_chans;
+    }
+  }
+  return NumelOf(weight) / w_shape[0];
+}
+
+double Percentile(std::vector<int64_t>* sorted, double p) {
+  if (sorted->empty()) return 0;
+  size_t index = std::min(sorted->size() - 1, static_cast<size_t>(p * sorted->size()));
+  return (*sorted)[index];
+}
+
+std::string Escape(const std::string& s) {
+  std::string res;
+  for (char c : s) {
+    if (c == '"' || c == '\\') res.push_back('\\');
+    res.push_back(c);
+  }
+  return res;
+}
+
+}  // namespace
+
+InstructionCost EstimateInstructionCost(const std::string& op_name,
+                                        const std::vector<Tensor>& inputs,
+                                        const std::vector<Tensor>& outputs) {
+  InstructionCost cost;
+  for (auto& tensor : inputs) cost.bytes += BytesOf(tensor);
+  for (auto& tensor : outputs) cost.bytes += BytesOf(tensor);
+  if (outputs.empty()) return cost;
+
+  double out_numel = NumelOf(outputs[0]);
+  if (HasOp(op_name, "conv2d") || HasOp(op_name, "depthwise_conv2d")) {
+    if (inputs.size() > 1 && inputs[1].defined() && !inputs[1]->shape().data().empty()) {
+      double macs = ConvMacsPerOutput(inputs[0], inputs[1], outputs[0]);
+      if (macs > 0) {
+        cost.flops = 2 * out_numel * macs;
+        return cost;
+      }
+    }
+  } else if (HasOp(op_name, "mul") || HasOp(op_name, "matmul")) {
+    // A[b, M, K] * B[b, K, N] = Out[b, M, N], so K = sqrt(|A| * |B| / |Out| / b)
+    if (inputs.size() > 1 && out_numel > 0) {
+      auto& out_shape = outputs[0]->shape().data();
+      double batch    = 1;
+      for (int i = 0; i + 2 < static_cast<int>(out_shape.size()); i++) batch *= out_shape[i];
+      double k   = std::sqrt(NumelOf(inputs[0]) * NumelOf(inputs[1]) / out_numel / batch);
+      cost.flops = 2 * out_numel * k;
+      return cost;
+    }
+  }
+  // elementwise ops touch each output once, reductions each input once
+  cost.flops = std::max(out_numel, inputs.empty() ? 0. : NumelOf(inputs[0]));
+  return cost;
+}
+
+std::atomic<bool> InstructionProfiler::enabled_{false};
+std::atomic<bool> InstructionProfiler::counters_enabled_{false};
+
+InstructionProfiler& InstructionProfiler::Global() {
+  static InstructionProfiler x;
+  return x;
+}
+
+void InstructionProfiler::Record(const void* key,
+                                 const std::string& name,
+                                 Clock::time_point start,
+                                 Clock::time_point end,
+                                 const std::function<InstructionCost()>& cost,
+                                 const utils::PerfCounters::Values* counters) {
+  static thread_local uint32_t thread = std::hash<std::thread::id>()(std::this_thread::get_id()) % 100000;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    it               = entries_.emplace(key, Entry()).first;
+    it->second.name  = name;
+    it->second.cost  = cost();
+    order_.push_back(key);
+  }
+  Event event{std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_).count(),
+              std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+              thread};
+  if (counters) {
+    event.counters = *counters;
+  } else {
+    event.counters.fill(-1);
+  }
+  it->second.events.push_back(event);
+}
+
+std::string InstructionProfiler::Summary() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  using utils::PerfCounters;
+  struct Row {
+    const Entry* entry;
+    std::vector<int64_t> durations;
+    double total_ns;
+    // the sum of each counter and the number of runs it is available in
+    std::array<double, PerfCounters::kNumEvents> counters;
+    std::array<int, PerfCounters::kNumEvents> counted;
+  };
+  std::vector<Row> rows;
+  double all_ns = 0;
+  bool counted  = false;
+  for (auto key : order_) {
+    auto& entry = entries_.at(key);
+    Row row{&entry, {}, 0, {}, {}};
+    for (auto& event : entry.events) {
+      row.durations.push_back(event.duration_ns);
+      row.total_ns += event.duration_ns;
+      for (int i = 0; i < PerfCounters::kNumEvents; i++) {
+        if (event.counters[i] < 0) continue;
+        row.counters[i] += event.counters[i];
+        row.counted[i]++;
+        counted = true;
+      }
+    }
+    std::sort(row.durations.begin(), row.durations.end());
+    all_ns += row.total_ns;
+    rows.push_back(std::move(row));
+  }
+  std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.total_ns > b.total_ns; });
+
+  std::stringstream ss;
+  ss << std::left << std::setw(48) << "instruction" << std::right << std::setw(8) << "calls" << std::setw(12)
+     << "total(ms)" << std::setw(8) << "%" << std::setw(12) << "mean(us)" << std::setw(12) << "p50(us)"
+     << std::setw(12) << "p90(us)" << std::setw(12) << "p99(us)" << std::setw(10) << "GFLOP/s" << std::setw(10)
+     << "GB/s"
+     << "\n";
+  ss << std::fixed << std::setprecision(3);
+  for (auto& row : rows) {
+    size_t calls   = row.durations.size();
+    double mean_ns = row.total_ns / calls;
+    ss << std::left << std::setw(48) << row.entry->name << std::right << std::setw(8) << calls << std::setw(12)
+       << row.total_ns / 1e6 << std::setw(8) << std::setprecision(1) << 100 * row.total_ns / all_ns
+       << std::setprecision(3) << std::setw(12) << mean_ns / 1e3 << std::setw(12)
+       << Percentile(&row.durations, 0.5) / 1e3 << std::setw(12) << Percentile(&row.durations, 0.9) / 1e3
+       << std::setw(12) << Percentile(&row.durations, 0.99) / 1e3 << std::setw(10)
+       << row.entry->cost.flops / mean_ns << std::setw(10) << row.entry->cost.bytes / mean_ns << "\n";
+  }
+  if (!counted) return ss.str();
+
+  // the counters per run, "-" if unavailable
+  auto per_run = [](const Row& row, int event) {
+    std::stringstream ss;
+    if (row.counted[event] == 0) return std::string("-");
+    ss << std::fixed << std::setprecision(0) << row.counters[event] / row.counted[event];
+    return ss.str();
+  };
+  auto ratio = [](const Row& row, int a, int b) {
+    std::stringstream ss;
+    if (row.counted[a] == 0 || row.counted[b] == 0 || row.counters[b] == 0) return std::string("-");
+    ss << std::fixed << std::setprecision(2) << row.counters[a] / row.counters[b];
+    return ss.str();
+  };
+  ss << "\n"
+     << std::left << std::setw(48) << "instruction" << std::right << std::setw(14) << "cycles" << std::setw(8)
+     << "IPC" << std::setw(12) << "L1D miss" << std::setw(12) << "LLC miss" << std::setw(12) << "br miss"
+     << std::setw(8) << "AVX2" << std::setw(8) << "AVX512"
+     << "  params\n";
+  for (auto& row : rows) {
+    ss << std::left << std::setw(48) << row.entry->name << std::right << std::setw(14)
+       << per_run(row, PerfCounters::kCycles) << std::setw(8)
+       << ratio(row, PerfCounters::kInstructions, PerfCounters::kCycles) << std::setw(12)
+       << per_run(row, PerfCounters::kL1DMisses) << std::setw(12) << per_run(row, PerfCounters::kLLCMisses)
+       << std::setw(12) << per_run(row, PerfCounters::kBranchMisses) << std::setw(8)
+       << ratio(row, PerfCounters::kAVX2LicenseCycles, PerfCounters::kCycles) << std::setw(8)
+       << ratio(row, PerfCounters::kAVX512LicenseCycles, PerfCounters::kCycles) << "  " << row.entry->cost.params
+       << "\n";
+  }
+  return ss.str();
+}
+
+void InstructionProfiler::ExportChromeTrace(const std::string& path) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ofstream os(path);
+  CHECK(os.is_open()) << "Cannot open " << path;
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  os << std::fixed << std::setprecision(3);
+  for (auto key : order_) {
+    auto& entry = entries_.at(key);
+    for (auto& event : entry.events) {
+      if (!first) os << ",";
+      first = false;
+      os << "\n{\"name\":\"" << Escape(entry.name) << "\",\"cat\":\"instruction\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+         << event.thread << ",\"ts\":" << event.start_ns / 1e3 << ",\"dur\":" << event.duration_ns / 1e3
+         << ",\"args\":{\"flops\":" << entry.cost.flops << ",\"bytes\":" << entry.cost.bytes;
+      for (int i = 0; i < utils::PerfCounters::kNumEvents; i++) {
+        if (event.counters[i] < 0) continue;
+        os << ",\"" << utils::PerfCounters::Name(static_cast<utils::PerfCounters::Event>(i))
+           << "\":" << event.counters[i];
+      }
+      if (!entry.cost.params.empty()) os << ",\"params\":\"" << Escape(entry.cost.params) << "\"";
+      os << "}}";
+    }
+  }
+  os << "\n]}\n";
+}
+
+void InstructionProfiler::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  order_.clear();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
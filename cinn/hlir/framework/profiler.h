@@ -0,0 +1,126 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  //NOLINT
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/utils/perf_counters.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+//! The estimated work of an instruction.
+struct InstructionCost {
+  double flops{0};
+  //! The bytes of all the inputs and outputs, each read or written once.
+  double bytes{0};
+  //! The attributes of the op which its schedule is chosen by, reported with the hardware counters.
+  std::string params;
+};
+
+/**
+ * Estimate the work of an op or a fused group from its name and the shapes of its arguments. Convolutions and matrix
+ * multiplications count two flops per multiply-add, other ops count one flop per element of the output.
+ * @param op_name The name of the op or the function of the fused group, e.g. "fn_conv2d_1_elementwise_add_2_fused".
+ */
+InstructionCost EstimateInstructionCost(const std::string& op_name,
+                                        const std::vector<Tensor>& inputs,
+                                        const std::vector<Tensor>& outputs);
+
+/**
+ * Profile the instructions of the programs. Once enabled, every Instruction::Run records its wall time, and the
+ * records are reported as a table sorted by the total time or as a Chrome trace, which can be opened by
+ * chrome://tracing or Perfetto. When disabled, Instruction::Run only checks a flag.
+ *
+ * On NVGPU each profiled instruction synchronizes the device to measure its kernels.
+ *
+ * The hardware counters of the CPU, e.g. cycles and cache misses, can be enabled too, to tell whether a kernel is
+ * bound by compute or memory. They are counted for the thread running the instruction, so the kernels parallelized to
+ * other threads are not fully counted.
+ */
+class InstructionProfiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static InstructionProfiler& Global();
+
+  static bool Enabled() { return enabled_.load(std::memory_order_relaxed); }
+  static void Enable() { enabled_.store(true); }
+  static void Disable() { enabled_.store(false); }
+
+  static bool CountersEnabled() { return counters_enabled_.load(std::memory_order_relaxed); }
+  static void EnableCounters(bool enabled = true) { counters_enabled_.store(enabled); }
+
+  /**
+   * Record a run of an instruction.
+   * @param key Identify the instruction, the records with the same key are summarized together.
+   * @param name The name of the instruction to display.
+   * @param cost Estimate the work of the instruction, only called at the first record of \p key.
+   * @param counters The hardware counters of the run if they are enabled.
+   */
+  void Record(const void* key,
+              const std::string& name,
+              Clock::time_point start,
+              Clock::time_point end,
+              const std::function<InstructionCost()>& cost,
+              const utils::PerfCounters::Values* counters = nullptr);
+
+  //! A table of the instructions sorted by their total time, with the percentiles, GFLOP/s and GB/s, and a table of
+  //! the hardware counters per run if they are recorded.
+  std::string Summary() const;
+
+  //! Write the records as the events of a Chrome trace.
+  void ExportChromeTrace(const std::string& path) const;
+
+  //! Drop all the records, should be called before the profiled instructions are destroyed.
+  void Clear();
+
+ private:
+  InstructionProfiler() = default;
+
+  struct Event {
+    int64_t start_ns;
+    int64_t duration_ns;
+    uint32_t thread;
+    utils::PerfCounters::Values counters;
+  };
+  struct Entry {
+    std::string name;
+    InstructionCost cost;
+    std::vector<Event> events;
+  };
+
+  static std::atomic<bool> enabled_;
+  static std::atomic<bool> counters_enabled_;
+
+  mutable std::mutex mutex_;
+  std::map<const void*, Entry> entries_;
+  //! The entries in the order of their first record.
+  std::vector<const void*> order_;
+  Clock::time_point origin_{Clock::now()};
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,132 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+Tensor MakeTensor(const std::vector<int>& shape) {
+  Tensor tensor;
+  tensor->Resize(Shape(shape));
+  tensor->set_type(Float(32));
+  return tensor;
+}
+
+TEST(InstructionProfiler, EstimateCost) {
+  auto conv = EstimateInstructionCost("fn_conv2d_0_elementwise_add_1_fused",
+                                      {MakeTensor({1, 3, 32, 32}), MakeTensor({8, 3, 3, 3}), MakeTensor({8})},
+                                      {MakeTensor({1, 8, 30, 30})});
+  ASSERT_DOUBLE_EQ(conv.flops, 2. * 8 * 30 * 30 * 3 * 3 * 3);
+  ASSERT_DOUBLE_EQ(conv.bytes, 4. * (3 * 32 * 32 + 8 * 3 * 3 * 3 + 8 + 8 * 30 * 30));
+
+  // the conv2d_NCHWc weight [oc_chunk, ic_chunk, kh, kw, ic_bn, oc_bn]
+  auto conv_nchwc = EstimateInstructionCost("fn_conv2d_NCHWc_0",
+                                            {MakeTensor({1, 2, 32, 32, 4}), MakeTensor({4, 2, 3, 3, 4, 4})},
+                                            {MakeTensor({1, 4, 30, 30, 4})});
+  ASSERT_DOUBLE_EQ(conv_nchwc.flops, 2. * 16 * 30 * 30 * 8 * 3 * 3);
+
+  // the winograd weight [alpha, alpha, in_channels, out_channels] counts as the direct 3x3 conv
+  auto conv_winograd = EstimateInstructionCost(
+      "fn_conv2d_0", {MakeTensor({1, 8, 32, 32}), MakeTensor({6, 6, 8, 16})}, {MakeTensor({1, 16, 32, 32})});
+  ASSERT_DOUBLE_EQ(conv_winograd.flops, 2. * 16 * 32 * 32 * 8 * 3 * 3);
+
+  auto matmul =
+      EstimateInstructionCost("matmul", {MakeTensor({4, 16, 32}), MakeTensor({4, 32, 8})}, {MakeTensor({4, 16, 8})});
+  ASSERT_NEAR(matmul.flops, 2. * 4 * 16 * 8 * 32, 1e-6);
+
+  auto mul =
+      EstimateInstructionCost("elementwise_mul", {MakeTensor({16, 32}), MakeTensor({16, 32})}, {MakeTensor({16, 32})});
+  ASSERT_DOUBLE_EQ(mul.flops, 16. * 32);
+}
+
+TEST(InstructionProfiler, program) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.relu(c);
+  Target target(Target::OS::Linux, Target::Arch::X86, Target::Bit::k64, {});
+
+  auto g = std::make_shared<Graph>(prog, target);
+  ApplyPass(g.get(), "InferShape");
+  auto scope = BuildScope(target, g);
+  GraphCompiler gc(target, scope, g);
+  auto program = gc.Build();
+  scope->GetTensor("A")->mutable_data<float>(target);
+  scope->GetTensor("B")->mutable_data<float>(target);
+
+  auto& profiler = InstructionProfiler::Global();
+  profiler.Clear();
+  program->Execute();
+  ASSERT_EQ(profiler.Summary().find("relu"), std::string::npos);
+
+  InstructionProfiler::Enable();
+  for (int i = 0; i < 10; i++) program->Execute();
+  InstructionProfiler::Disable();
+
+  auto summary = profiler.Summary();
+  LOG(INFO) << "\n" << summary;
+  ASSERT_NE(summary.find("relu"), std::string::npos);
+  ASSERT_NE(summary.find("elementwise_add"), std::string::npos);
+
+  std::string path = "./test_instruction_profiler.json";
+  profiler.ExportChromeTrace(path);
+  std::ifstream is(path);
+  std::stringstream ss;
+  ss << is.rdbuf();
+  auto trace = ss.str();
+  ASSERT_EQ(trace.find("{\"displayTimeUnit\""), 0UL);
+  int events = 0;
+  for (size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos; pos = trace.find("\"ph\":\"X\"", pos + 1)) {
+    events++;
+  }
+  ASSERT_EQ(events, 10 * program->size());
+  profiler.Clear();
+
+  if (!utils::PerfCounters::ThisThread().available()) {
+    LOG(WARNING) << "Skip the hardware counters which are not available";
+    return;
+  }
+  InstructionProfiler::Enable();
+  InstructionProfiler::EnableCounters();
+  for (int i = 0; i < 10; i++) program->Execute();
+  InstructionProfiler::EnableCounters(false);
+  InstructionProfiler::Disable();
+  summary = profiler.Summary();
+  LOG(INFO) << "\n" << summary;
+  ASSERT_NE(summary.find("IPC"), std::string::npos);
+  profiler.Clear();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
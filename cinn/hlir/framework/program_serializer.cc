@@ -0,0 +1,387 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/program_serializer.h"
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/Host.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "cinn/common/version.h"
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+const char kMagic[]          = "CINNPROG";
+const uint32_t kFormatVersion = 1;
+// the data of the tensors and the object files are aligned to the cache line
+const size_t kDataAlignment = 64;
+
+size_t AlignUp(size_t x) { return (x + kDataAlignment - 1) / kDataAlignment * kDataAlignment; }
+
+// The ABI of the runtime the compiled code calls into: the layouts of the runtime types and the libraries providing
+// the extern functions.
+std::string RuntimeAbi() {
+  std::string abi = "buffer " + std::to_string(sizeof(cinn_buffer_t)) + ",type " + std::to_string(sizeof(cinn_type_t)) +
+                    ",pod " + std::to_string(sizeof(cinn_pod_value_t));
+#ifdef CINN_WITH_MKL_CBLAS
+  abi += ",mklcblas";
+#endif
+#ifdef CINN_WITH_MKLDNN
+  abi += ",mkldnn";
+#endif
+#ifdef CINN_USE_OPENMP
+  abi += ",openmp";
+#endif
+#ifdef CINN_WITH_CUDA
+  abi += ",cuda";
+#endif
+  return abi;
+}
+
+// The programs are invalidated by the revision of CINN, the runtime ABI, the LLVM version and the CPU features of the
+// host.
+std::string BuildStamp() {
+  std::string stamp = std::string("cinn ") + CINN_GIT_HASH + ";runtime " + RuntimeAbi() + ";llvm " +
+                      LLVM_VERSION_STRING + ";cpu " + llvm::sys::getHostCPUName().str();
+  llvm::StringMap<bool> features;
+  if (llvm::sys::getHostCPUFeatures(features)) {
+    std::vector<std::string> enabled;
+    for (auto& feature : features) {
+      if (feature.second) enabled.push_back(feature.first().str());
+    }
+    std::sort(enabled.begin(), enabled.end());
+    for (auto& feature : enabled) stamp += "," + feature;
+  }
+  return stamp;
+}
+
+class Writer {
+ public:
+  template <typename T>
+  void WritePOD(const T& x) {
+    buf_.append(reinterpret_cast<const char*>(&x), sizeof(T));
+  }
+  void Write(const std::string& x) {
+    WritePOD<uint64_t>(x.size());
+    buf_.append(x);
+  }
+  void Write(const std::vector<std::string>& x) {
+    WritePOD<uint64_t>(x.size());
+    for (auto& i : x) Write(i);
+  }
+  template <typename T>
+  void WritePODs(const std::vector<T>& x) {
+    WritePOD<uint64_t>(x.size());
+    buf_.append(reinterpret_cast<const char*>(x.data()), x.size() * sizeof(T));
+  }
+  //! Add a blob to the data section, return its offset in the data section.
+  uint64_t AddData(const char* data, size_t size) {
+    uint64_t offset = data_size_;
+    blobs_.emplace_back(data, size);
+    data_size_ = AlignUp(data_size_ + size);
+    return offset;
+  }
+
+  void Save(const std::string& path) {
+    std::ofstream os(path, std::ios::binary);
+    CHECK(os.is_open()) << "Cannot open file " << path;
+    uint64_t header_size = AlignUp(sizeof(uint64_t) + buf_.size());
+    os.write(reinterpret_cast<const char*>(&header_size), sizeof(header_size));
+    os.write(buf_.data(), buf_.size());
+    std::string padding(kDataAlignment, '\0');
+    os.write(padding.data(), header_size - sizeof(uint64_t) - buf_.size());
+    for (auto& blob : blobs_) {
+      os.write(blob.first, blob.second);
+      os.write(padding.data(), AlignUp(blob.second) - blob.second);
+    }
+    CHECK(os.good()) << "Failed to write file " << path;
+  }
+
+ private:
+  std::string buf_;
+  std::vector<std::pair<const char*, size_t>> blobs_;
+  uint64_t data_size_{};
+};
+
+//! Read the file saved by the Writer, a read out of the bounds marks the file broken instead of failing.
+class Reader {
+ public:
+  explicit Reader(const utils::MappedFile& file) : file_(file), offset_(0), data_offset_(file.size()) {
+    data_offset_ = ReadPOD<uint64_t>();
+    if (data_offset_ > file.size()) Fail();
+  }
+
+  //! Whether all the reads are in the bounds of the file.
+  bool ok() const { return ok_; }
+
+  template <typename T>
+  T ReadPOD() {
+    T res{};
+    if (const char* data = Read(sizeof(T))) std::memcpy(&res, data, sizeof(T));
+    return res;
+  }
+  std::string ReadString() {
+    auto size        = ReadPOD<uint64_t>();
+    const char* data = Read(size);
+    return data ? std::string(data, size) : std::string();
+  }
+  std::vector<std::string> ReadStrings() {
+    // each string takes at least its size
+    auto size = ReadCount(sizeof(uint64_t));
+    std::vector<std::string> res;
+    for (uint64_t i = 0; i < size && ok_; i++) res.push_back(ReadString());
+    return res;
+  }
+  template <typename T>
+  std::vector<T> ReadPODs() {
+    std::vector<T> res(ReadCount(sizeof(T)));
+    if (const char* data = Read(res.size() * sizeof(T))) std::memcpy(res.data(), data, res.size() * sizeof(T));
+    return res;
+  }
+  const char* Data(uint64_t offset, uint64_t size) {
+    uint64_t data_size = file_.size() - data_offset_;
+    if (!ok_ || offset > data_size || size > data_size - offset) {
+      Fail();
+      return nullptr;
+    }
+    return file_.data() + data_offset_ + offset;
+  }
+
+ private:
+  const char* Read(size_t size) {
+    if (!ok_ || size > data_offset_ - offset_) {
+      Fail();
+      return nullptr;
+    }
+    const char* res = file_.data() + offset_;
+    offset_ += size;
+    return res;
+  }
+
+  //! Read the number of the elements of \p element_size bytes that follow, 0 if they overflow the file.
+  uint64_t ReadCount(size_t element_size) {
+    auto count = ReadPOD<uint64_t>();
+    if (!ok_ || count > (data_offset_ - offset_) / element_size) {
+      Fail();
+      return 0;
+    }
+    return count;
+  }
+
+  void Fail() {
+    if (ok_) LOG(WARNING) << "The compiled program " << file_.path() << " is broken";
+    ok_ = false;
+  }
+
+  const utils::MappedFile& file_;
+  size_t offset_;
+  size_t data_offset_;
+  bool ok_{true};
+};
+
+}  // namespace
+
+void SaveCompiledProgram(const std::string& path,
+                         const Program& program,
+                         const Scope& scope,
+                         const backends::Compiler& compiler,
+                         const std::vector<std::string>& feed_names,
+                         const std::map<std::string, std::string>& metadata) {
+  Writer writer;
+  writer.Write(std::string(kMagic));
+  writer.WritePOD(kFormatVersion);
+  writer.Write(BuildStamp());
+
+  // the tensors written at runtime have no data to save
+  std::set<std::string> no_data(feed_names.begin(), feed_names.end());
+  for (auto& instr : program.GetRunInstructions()) {
+    for (auto& args : instr->GetOutArgs()) no_data.insert(args.begin(), args.end());
+  }
+  auto names = scope.var_names();
+  writer.WritePOD<uint64_t>(names.size());
+  for (auto& view : names) {
+    std::string name(view.data(), view.size());
+    auto tensor = scope.GetTensor(name);
+    writer.Write(name);
+    writer.WritePODs(tensor->shape().data());
+    auto& type = tensor->type();
+    writer.WritePOD<int32_t>(static_cast<int32_t>(type.type()));
+    writer.WritePOD<int32_t>(type.bits());
+    writer.WritePOD<int32_t>(type.lanes());
+    bool has_data = !no_data.count(name) && tensor->buffer()->memory && type.bits() > 0;
+    writer.WritePOD<uint8_t>(has_data);
+    if (has_data) {
+      size_t size = tensor->shape().numel() * ((type.bits() + 7) / 8);
+      writer.WritePOD<uint64_t>(writer.AddData(tensor->data<char>(), size));
+      writer.WritePOD<uint64_t>(size);
+    }
+  }
+
+  writer.WritePOD<uint64_t>(program.GetRunInstructions().size());
+  for (auto& instr : program.GetRunInstructions()) {
+    writer.Write(instr->function_name());
+    auto in_args  = instr->GetInArgs();
+    auto out_args = instr->GetOutArgs();
+    CHECK_EQ(in_args.size(), out_args.size());
+    writer.WritePOD<uint64_t>(in_args.size());
+    for (int i = 0; i < in_args.size(); i++) {
+      writer.Write(in_args[i]);
+      writer.Write(out_args[i]);
+    }
+    for (auto& fn_name : instr->GetFnNames()) {
+      CHECK(!fn_name.empty()) << "The instruction " << instr->function_name() << " has an unnamed function";
+    }
+    writer.Write(instr->GetFnNames());
+    writer.WritePODs(instr->attrs);
+    writer.Write(instr->str_attrs);
+  }
+
+  auto objects = compiler.GetObjectFiles();
+  writer.WritePOD<uint64_t>(objects.size());
+  for (auto& obj : objects) {
+    writer.WritePOD<uint64_t>(writer.AddData(obj.data(), obj.size()));
+    writer.WritePOD<uint64_t>(obj.size());
+  }
+
+  writer.WritePOD<uint64_t>(metadata.size());
+  for (auto& item : metadata) {
+    writer.Write(item.first);
+    writer.Write(item.second);
+  }
+  writer.Save(path);
+  VLOG(2) << "Save the compiled program with " << names.size() << " tensors, " << program.GetRunInstructions().size()
+          << " instructions and " << objects.size() << " object files to " << path;
+}
+
+std::unique_ptr<CompiledProgram> LoadCompiledProgram(const std::string& path, const Target& target) {
+  CHECK(target.arch == Target::Arch::X86) << "Only X86 programs can be loaded";
+  auto file = utils::MappedFile::Open(path);
+  if (!file || file->size() < sizeof(uint64_t)) return nullptr;
+  Reader reader(*file);
+  if (reader.ReadString() != kMagic) {
+    LOG(WARNING) << path << " is not a compiled program";
+    return nullptr;
+  }
+  if (reader.ReadPOD<uint32_t>() != kFormatVersion || reader.ReadString() != BuildStamp()) {
+    LOG(WARNING) << "The compiled program " << path << " is built by another version of CINN or for another CPU";
+    return nullptr;
+  }
+
+  std::unique_ptr<CompiledProgram> res(new CompiledProgram);
+  res->file      = file;
+  res->scope     = std::make_shared<Scope>();
+  auto n_tensors = reader.ReadPOD<uint64_t>();
+  for (uint64_t i = 0; i < n_tensors && reader.ok(); i++) {
+    auto name  = reader.ReadString();
+    auto shape = reader.ReadPODs<Shape::dim_t>();
+    auto code  = reader.ReadPOD<int32_t>();
+    auto bits  = reader.ReadPOD<int32_t>();
+    auto lanes = reader.ReadPOD<int32_t>();
+    Type type(static_cast<Type::type_t>(code), bits, lanes);
+    auto tensor = absl::get<Tensor>(*res->scope->Var<Tensor>(name));
+    tensor->Resize(Shape(shape));
+    tensor->set_type(type);
+    if (reader.ReadPOD<uint8_t>()) {
+      auto offset      = reader.ReadPOD<uint64_t>();
+      auto size        = reader.ReadPOD<uint64_t>();
+      const char* data = reader.Data(offset, size);
+      if (!data || size != tensor->shape().numel() * ((type.bits() + 7) / 8)) {
+        LOG(WARNING) << "The compiled program " << path << " is broken, the data of " << name
+                     << " mismatches its shape";
+        return nullptr;
+      }
+      // the private mapping is only copied if the tensor is written
+      tensor->ShareExternalData(const_cast<char*>(data), type, target, file);
+    }
+  }
+  if (!reader.ok()) return nullptr;
+
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  std::vector<std::string> fn_names;
+  auto n_instrs = reader.ReadPOD<uint64_t>();
+  for (uint64_t i = 0; i < n_instrs && reader.ok(); i++) {
+    auto function_name = reader.ReadString();
+    auto n_args        = reader.ReadPOD<uint64_t>();
+    std::vector<std::vector<std::string>> in_args, out_args;
+    for (uint64_t j = 0; j < n_args && reader.ok(); j++) {
+      in_args.push_back(reader.ReadStrings());
+      out_args.push_back(reader.ReadStrings());
+    }
+    if (!reader.ok()) return nullptr;
+    if (n_args == 0) {
+      LOG(WARNING) << "The compiled program " << path << " is broken, the instruction " << function_name
+                   << " has no arguments";
+      return nullptr;
+    }
+    std::unique_ptr<Instruction> instr(
+        new Instruction(target, res->scope.get(), in_args[0], out_args[0], function_name));
+    for (uint64_t j = 1; j < n_args; j++) {
+      instr->AddInArgs(in_args[j]);
+      instr->AddOutArgs(out_args[j]);
+    }
+    for (auto& fn_name : reader.ReadStrings()) {
+      // the functions are looked up after linking the object files
+      instr->SetLoweredFunc(nullptr, fn_name);
+      fn_names.push_back(fn_name);
+    }
+    instr->attrs     = reader.ReadPODs<int>();
+    instr->str_attrs = reader.ReadStrings();
+    instrs.push_back(std::move(instr));
+  }
+
+  std::vector<absl::string_view> objects;
+  auto n_objects = reader.ReadPOD<uint64_t>();
+  for (uint64_t i = 0; i < n_objects && reader.ok(); i++) {
+    auto offset = reader.ReadPOD<uint64_t>();
+    auto size   = reader.ReadPOD<uint64_t>();
+    objects.emplace_back(reader.Data(offset, size), size);
+  }
+  if (!reader.ok()) return nullptr;
+  res->compiler = backends::Compiler::Create(target);
+  res->compiler->BuildFromObjectFiles(objects);
+  for (auto& fn_name : fn_names) {
+    if (!res->compiler->Lookup(fn_name)) {
+      LOG(WARNING) << "The compiled program " << path << " is broken, the function " << fn_name << " is not found";
+      return nullptr;
+    }
+  }
+  for (auto& instr : instrs) {
+    instr->ResolveLoweredFuncs([&](const std::string& fn_name) { return res->compiler->Lookup(fn_name); });
+  }
+
+  auto n_metadata = reader.ReadPOD<uint64_t>();
+  for (uint64_t i = 0; i < n_metadata && reader.ok(); i++) {
+    auto key            = reader.ReadString();
+    res->metadata[key] = reader.ReadString();
+  }
+  if (!reader.ok()) return nullptr;
+  res->program.reset(new Program(res->scope, std::move(instrs)));
+  return res;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,70 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/backends/compiler.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/utils/mapped_file.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * A Program loaded from a file saved by SaveCompiledProgram, it holds the compiled code and the mapped file that the
+ * parameters reference.
+ */
+struct CompiledProgram {
+  //! The mapped file, the object code and the parameters reference it.
+  std::shared_ptr<utils::MappedFile> file;
+  std::shared_ptr<Scope> scope;
+  std::unique_ptr<Program> program;
+  std::unique_ptr<backends::Compiler> compiler;
+  //! The extra information saved with the program.
+  std::map<std::string, std::string> metadata;
+};
+
+/**
+ * Save a built X86 program to \p path, so that it can be loaded later without compiling again.
+ *
+ * The file contains the tensors of the scope, the instructions and the object code of \p compiler. The data of the
+ * tensors not written by the instructions, such as the parameters and the results of the pre_run instructions, are
+ * saved as well, so the pre_run instructions are dropped. The program should have run PreRun before.
+ *
+ * @param feed_names The names of the tensors fed by users, whose data are not saved.
+ * @param metadata The extra information to save with the program.
+ */
+void SaveCompiledProgram(const std::string& path,
+                         const Program& program,
+                         const Scope& scope,
+                         const backends::Compiler& compiler,
+                         const std::vector<std::string>& feed_names        = {},
+                         const std::map<std::string, std::string>& metadata = {});
+
+/**
+ * Load a program saved by SaveCompiledProgram. The file is memory-mapped and the parameters reference it directly.
+ * @return null if the file does not exist, is broken, or it is saved by another build of CINN or for a host with
+ * different CPU features.
+ */
+std::unique_ptr<CompiledProgram> LoadCompiledProgram(const std::string& path, const Target& target);
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,120 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/program_serializer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(CompiledProgram, save_and_load) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.relu(c);
+  Target target(Target::OS::Linux, Target::Arch::X86, Target::Bit::k64, {});
+
+  auto g = std::make_shared<Graph>(prog, target);
+  ApplyPass(g.get(), "InferShape");
+  ApplyPass(g.get(), "OpFusion");
+  auto scope = BuildScope(target, g);
+  GraphCompiler gc(target, scope, g);
+  auto program = gc.Build();
+
+  // B is a parameter saved with the program, A is fed at runtime
+  auto* b_data = scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) b_data[i] = i % 7 - 3.f;
+  program->PreRun();
+  std::string path = "./test_compiled_program";
+  SaveCompiledProgram(path, *program, *scope, *gc.GetCompiler(), {"A"}, {{"model", "add_relu"}});
+
+  auto loaded = LoadCompiledProgram(path, target);
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(loaded->metadata.at("model"), "add_relu");
+  ASSERT_EQ(loaded->program->size(), program->size());
+  auto* a_data = loaded->scope->GetTensor("A")->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) a_data[i] = i % 5 - 2.f;
+  loaded->program->Execute();
+
+  auto* out = loaded->scope->GetTensor(d->id)->data<float>();
+  for (int i = 0; i < 100 * 32; i++) {
+    ASSERT_NEAR(out[i], std::max(i % 5 - 2.f + i % 7 - 3.f, 0.f), 1e-5);
+  }
+}
+
+TEST(CompiledProgram, load_broken) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  a->shape = {16, 32};
+  a->type  = Float(32);
+  prog.relu(a);
+  Target target(Target::OS::Linux, Target::Arch::X86, Target::Bit::k64, {});
+
+  auto g = std::make_shared<Graph>(prog, target);
+  ApplyPass(g.get(), "InferShape");
+  ApplyPass(g.get(), "OpFusion");
+  auto scope = BuildScope(target, g);
+  GraphCompiler gc(target, scope, g);
+  auto program = gc.Build();
+  program->PreRun();
+  std::string path = "./test_broken_program";
+  SaveCompiledProgram(path, *program, *scope, *gc.GetCompiler(), {"A"});
+
+  std::stringstream ss;
+  ss << std::ifstream(path, std::ios::binary).rdbuf();
+  std::string content = ss.str();
+
+  auto write = [&](const std::string& data) {
+    std::ofstream os(path, std::ios::binary);
+    os.write(data.data(), data.size());
+  };
+
+  // a truncated file
+  write(content.substr(0, content.size() / 2));
+  ASSERT_FALSE(LoadCompiledProgram(path, target));
+  write(content.substr(0, 32));
+  ASSERT_FALSE(LoadCompiledProgram(path, target));
+
+  // the header size points out of the file
+  std::string broken   = content;
+  uint64_t header_size = content.size() + 1;
+  std::memcpy(&broken[0], &header_size, sizeof(header_size));
+  write(broken);
+  ASSERT_FALSE(LoadCompiledProgram(path, target));
+
+  write(content);
+  ASSERT_TRUE(LoadCompiledProgram(path, target));
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
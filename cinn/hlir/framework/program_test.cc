@@ -14,6 +14,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "cinn/hlir/framework/graph_compiler.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/framework/scope.h"
@@ -79,6 +84,99 @@ TEST(Program, ExecuteWithRawArgs) {
   }
 }
 
+TEST(Program, ExecuteAsync) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.relu(c);
+  Target target(Target::OS::Linux, Target::Arch::X86, Target::Bit::k64, {});
+
+  auto g = std::make_shared<Graph>(prog, target);
+  ApplyPass(g.get(), "InferShape");
+  auto scope = BuildScope(target, g);
+  GraphCompiler gc(target, scope, g);
+  auto program = gc.Build();
+
+  auto* a_data = scope->GetTensor("A")->mutable_data<float>(target);
+  auto* b_data = scope->GetTensor("B")->mutable_data<float>(target);
+  for (int round = 0; round < 3; round++) {
+    // the inputs are prepared while no run is pending
+    for (int i = 0; i < 100 * 32; i++) {
+      a_data[i] = (i + round) % 5 - 2.f;
+      b_data[i] = i % 7 - 3.f;
+    }
+    auto first  = program->ExecuteAsync();
+    auto second = program->ExecuteAsync();
+    second.get();
+    ASSERT_EQ(first.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+
+    auto* out = scope->GetTensor(d->id)->data<float>();
+    for (int i = 0; i < 100 * 32; i++) {
+      ASSERT_NEAR(out[i], std::max((i + round) % 5 - 2.f + i % 7 - 3.f, 0.f), 1e-5);
+    }
+  }
+}
+
+TEST(GraphCompiler, BuildWithSessionOnThreads) {
+  Target target(Target::OS::Linux, Target::Arch::X86, Target::Bit::k64, {});
+  const int num_threads = 4;
+  std::vector<std::shared_ptr<Graph>> graphs;
+  std::vector<std::shared_ptr<Scope>> scopes;
+  std::vector<std::string> out_ids;
+  for (int t = 0; t < num_threads; t++) {
+    frontend::Program prog;
+    frontend::Variable a("A");
+    frontend::Variable b("B");
+    a->shape = {64, 32};
+    b->shape = {64, 32};
+    a->type  = Float(32);
+    b->type  = Float(32);
+    auto c   = prog.add(a, b);
+    auto d   = prog.relu(c);
+    auto g   = std::make_shared<Graph>(prog, target);
+    ApplyPass(g.get(), "InferShape");
+    ApplyPass(g.get(), "OpFusion");
+    graphs.push_back(g);
+    scopes.push_back(BuildScope(target, g));
+    out_ids.push_back(d->id);
+  }
+
+  // each graph is lowered and compiled in a session of its own, at the same time
+  std::vector<std::unique_ptr<Program>> programs(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      GraphCompiler gc(target, scopes[t], graphs[t]);
+      GraphCompiler::CompileOptions options;
+      options.with_instantiate_variables = true;
+      options.with_session               = true;
+      programs[t]                        = std::move(gc.Build(options).runtime_program);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (int t = 0; t < num_threads; t++) {
+    ASSERT_TRUE(programs[t]);
+    auto* a_data = scopes[t]->GetTensor("A")->mutable_data<float>(target);
+    auto* b_data = scopes[t]->GetTensor("B")->mutable_data<float>(target);
+    for (int i = 0; i < 64 * 32; i++) {
+      a_data[i] = (i + t) % 5 - 2.f;
+      b_data[i] = i % 7 - 3.f;
+    }
+    programs[t]->Execute();
+    auto* out = scopes[t]->GetTensor(out_ids[t])->data<float>();
+    for (int i = 0; i < 64 * 32; i++) {
+      ASSERT_NEAR(out[i], std::max((i + t) % 5 - 2.f + i % 7 - 3.f, 0.f), 1e-5);
+    }
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -33,6 +33,8 @@ Tensor Scope::GetTensor(const std::string& name) const {
   return absl::get<Tensor>(*var);
 }
 
+void Scope::EraseVar(const std::string& name) { data_.erase(name); }
+
 std::vector<absl::string_view> Scope::var_names() const {
   std::vector<absl::string_view> names;
   for (auto& item : data_) {
@@ -46,6 +46,9 @@ class Scope {
 
   Tensor GetTensor(const std::string& name) const;
 
+  //! Erase a variable if it exists.
+  void EraseVar(const std::string& name);
+
   //! Get variable names.
   std::vector<absl::string_view> var_names() const;
 
@@ -73,6 +73,28 @@ class _Tensor_ : public Object {
     return reinterpret_cast<T*>(buffer_->data()->memory);
   }
 
+  //! The same as mutable_data<T> but with the element type given at runtime.
+  void* mutable_data(const Target& target, const Type& type) {
+    set_type(type);
+    uint32_t size = shape_.numel() * ((type.bits() + 7) / 8);
+    if (target == common::DefaultHostTarget()) {
+      buffer_->ResizeLazy(type.ElementOf().bits(), size, target);
+    } else {
+      buffer_->ResizeLazy(size, target);
+    }
+    return buffer_->data()->memory;
+  }
+
+  /**
+   * Reference the memory \p data owned by \p holder instead of allocating, the shape should be set first. The tensor
+   * should not be resized larger while it references the memory, it would allocate memory of its own and stop reading
+   * and writing \p data silently, share a larger memory instead.
+   */
+  void ShareExternalData(void* data, const Type& type, const Target& target, std::shared_ptr<void> holder) {
+    set_type(type);
+    buffer_->ShareExternalMemory(data, shape_.numel() * ((type.bits() + 7) / 8), target, std::move(holder));
+  }
+
   template <typename T>
   const T* data() const {
     return reinterpret_cast<T*>(buffer_->data()->memory);
@@ -149,6 +149,8 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
   int groups              = 1;
   std::string key         = "";
   std::string conv_type   = "";
+  std::string algorithm   = "direct";
+  int tile_size           = 0;
   if (attrs.attr_store.find("padding") != attrs.attr_store.end()) {
     padding = absl::get<std::vector<int>>(attrs.attr_store.at("padding"));
   }
@@ -173,9 +175,18 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
   } else {
     conv_type = "forward";
   }
+  // the algorithm selected by AlterLayout pass, one of {direct, winograd, im2col, mkldnn}
+  if (attrs.attr_store.find("algorithm") != attrs.attr_store.end()) {
+    algorithm = absl::get<std::string>(attrs.attr_store.at("algorithm"));
+  }
+  if (attrs.attr_store.find("tile_size") != attrs.attr_store.end()) {
+    tile_size = absl::get<int>(attrs.attr_store.at("tile_size"));
+  }
   // if target arch == x86
   if (target.arch == common::Target::Arch::X86) {
     CHECK_EQ(conv_type, "forward") << "arch x86 only support conv_type == forward.";
+  } else {
+    algorithm = "direct";
   }
 
   framework::CINNCompute conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
@@ -201,7 +212,34 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
     if (data_format == "NCHW") {
       // A is input: [N, C, H, W], B is filter: [C_out, C_in/group, filter_h, filter_w]
       if (target.arch == Target::Arch::X86) {
-        if (groups == 1) {
+        if (algorithm == "winograd") {
+          // B is the transformed filter: [alpha, alpha, C_in, C_out]
+          CHECK(tile_size == 2 || tile_size == 4)
+              << "winograd only supports the tile size 2 or 4, but got " << tile_size;
+          CHECK_EQ(B.as_tensor_ref()->shape.size(), 4U) << "winograd conv2d's weight should be transformed";
+          CHECK(B.as_tensor_ref()->shape[0].is_constant() && B.as_tensor_ref()->shape[0].as_int32() == tile_size + 2)
+              << "winograd conv2d only supports the 3x3 filter";
+          CHECK(stride[0] == 1 && stride[1] == 1) << "winograd conv2d only supports the stride 1";
+          CHECK(dilation[0] == 1 && dilation[1] == 1) << "winograd conv2d only supports the dilation 1";
+          CHECK_EQ(groups, 1) << "winograd conv2d does not support the grouped conv";
+          out = pe::Conv2d_NCHW_Winograd(A.as_tensor_ref(),
+                                         B.as_tensor_ref(),
+                                         padding[0],
+                                         padding[1],
+                                         tile_size,
+                                         UniqName("Conv2d_nchw_winograd_out"));
+        } else if (algorithm == "im2col") {
+          out = pe::Conv2d_NCHW_Im2col(A.as_tensor_ref(),
+                                       B.as_tensor_ref(),
+                                       padding[0],
+                                       padding[1],
+                                       stride[0],
+                                       stride[1],
+                                       dilation[0],
+                                       dilation[1],
+                                       target,
+                                       UniqName("Conv2d_nchw_im2col_out"));
+        } else if (groups == 1 && algorithm != "mkldnn") {
           out = pe::Conv2d_NCHW_5D(A.as_tensor_ref(),
                                    B.as_tensor_ref(),
                                    padding[0],
@@ -256,8 +294,8 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
       stages->InsertLazily(t);
       res.push_back(CINNValue(t));
     }
-    CHECK(out.size() == 3U || out.size() == 2U || out.size() == 5U)
-        << "The output tensor sizes of conv2d op in conv2d op should be 2 or 3 or 5\n";
+    CHECK(out.size() == 3U || out.size() == 2U || out.size() == 5U || out.size() == 4U)
+        << "The output tensor sizes of conv2d op in conv2d op should be 2 or 3 or 4 or 5\n";
 
     res.push_back(CINNValue(stages));
     *ret = CINNValuePack{res};
@@ -266,9 +304,23 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
   framework::CINNSchedule conv2d_schedule([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of conv2d schedule is empty! Please check.\n";
     CINNValuePack arg_pack = args[0];
-    CHECK(arg_pack.size() == 4UL || arg_pack.size() == 3UL || arg_pack.size() == 6UL);
+    CHECK(arg_pack.size() == 4UL || arg_pack.size() == 3UL || arg_pack.size() == 6UL || arg_pack.size() == 5UL);
     poly::StageMap stages = arg_pack.back();
-    if (target.arch == Target::Arch::NVGPU) {
+    if (algorithm == "winograd" || algorithm == "im2col") {
+      CHECK_EQ(arg_pack.size(), 5UL);
+      std::vector<ir::Tensor> tensors;
+      for (int i = 0; i < 4; i++) {
+        Expr t = arg_pack[i];
+        CHECK(t.as_tensor());
+        tensors.push_back(t.as_tensor_ref());
+      }
+      if (algorithm == "winograd") {
+        pe::Conv2d_Winograd_Schedule_CPU(stages, tensors[0], tensors[1], tensors[2], tensors[3], target);
+      } else {
+        pe::Conv2d_Im2col_Schedule_CPU(stages, tensors[0], tensors[1], tensors[2], tensors[3], target);
+      }
+      *ret = CINNValuePack{{arg_pack[0], CINNValue(stages)}};
+    } else if (target.arch == Target::Arch::NVGPU) {
       Expr Out             = arg_pack[0];
       Expr input_pad       = arg_pack[1];
       Expr weights         = arg_pack[2];
@@ -363,6 +415,7 @@ std::vector<shape_t> InferShapeForConv2d(const std::vector<shape_t> &inputs_shap
   int group               = 1;
   std::string data_format = "NCHW";
   std::string conv_type   = "";
+  std::string algorithm   = "direct";
   if (attrs.find("padding") != attrs.end()) {
     padding = absl::get<std::vector<int>>(attrs.at("padding"));
   }
@@ -383,6 +436,9 @@ std::vector<shape_t> InferShapeForConv2d(const std::vector<shape_t> &inputs_shap
   } else {
     conv_type = "forward";
   }
+  if (attrs.find("algorithm") != attrs.end()) {
+    algorithm = absl::get<std::string>(attrs.at("algorithm"));
+  }
 
   CHECK_EQ(padding.size(), 2) << "The size of padding in conv2d op is not 2! Please check.";
   CHECK_EQ(stride.size(), 2) << "The size of stride in conv2d op is not 2! Please check.";
@@ -391,6 +447,37 @@ std::vector<shape_t> InferShapeForConv2d(const std::vector<shape_t> &inputs_shap
       << "The conv type should be one of {forward, backward_data, backward_filter}.";
 
   std::vector<shape_t> res;
+  if (data_format == "NCHW" && algorithm != "direct") {
+    // the outputs after the first one are the intermediate tensors of the algorithm, in the order of the pe
+    int batch = inputs_shape[0][0], c_in = inputs_shape[0][1];
+    int c_out = inputs_shape[1][0], h_f = inputs_shape[1][2], w_f = inputs_shape[1][3];
+    if (algorithm == "winograd") {
+      // B is the transformed filter: [alpha, alpha, C_in, C_out]
+      c_out = inputs_shape[1][3];
+      h_f   = 3;
+      w_f   = 3;
+    }
+    int out_shape_h = (inputs_shape[0][2] - ((h_f - 1) * dilation[0] + 1) + 2 * padding[0]) / stride[0] + 1;
+    int out_shape_w = (inputs_shape[0][3] - ((w_f - 1) * dilation[1] + 1) + 2 * padding[1]) / stride[1] + 1;
+    shape_t out_shape{batch, c_out, out_shape_h, out_shape_w};
+    if (algorithm == "winograd") {
+      // {inverse, batch_gemm, input_tile} of pe::Conv2d_NCHW_Winograd
+      int alpha = inputs_shape[1][0];
+      int m     = alpha - 2;
+      int tiles = batch * ((out_shape_h + m - 1) / m) * ((out_shape_w + m - 1) / m);
+      return {out_shape, {c_out, tiles, m, m}, {alpha, alpha, c_out, tiles}, {alpha, alpha, c_in, tiles}};
+    }
+    if (algorithm == "mkldnn") {
+      // the extern call of mkldnn is the only intermediate tensor, of shape {1}, the others keep the number of outputs
+      return {out_shape, {1}, {1}, {1}};
+    }
+    CHECK_EQ(algorithm, "im2col") << "conv2d does not support the algorithm " << algorithm;
+    // {gemm, packed_weights, col} of pe::Conv2d_NCHW_Im2col
+    int oc_bn  = pe::GetArrayPackingFactor(c_out, Float(32), common::DefaultHostTarget());
+    int k_size = c_in * h_f * w_f;
+    int pixels = out_shape_h * out_shape_w;
+    return {out_shape, {batch, c_out / oc_bn, pixels, oc_bn}, {c_out / oc_bn, k_size, oc_bn}, {batch, k_size, pixels}};
+  }
   if (data_format == "NCHW") {
     // A is input: [N, C, H, W], B is filter: [C_out, C_in/group, filter_h, filter_w]
     int out_shape_h = 0, out_shape_w = 0;
@@ -492,6 +579,68 @@ std::vector<std::vector<std::string>> InferLayoutForConv2d(const std::vector<fra
   return {{input_layouts[0], input_layouts[0], input_layouts[0], input_layouts[0]}, input_layouts};
 }
 
+std::shared_ptr<OpStrategy> StrategyForConv2dWinogradWeightTransform(const framework::NodeAttr &attrs,
+                                                                     const std::vector<ir::Tensor> &inputs,
+                                                                     const std::vector<Type> &out_type,
+                                                                     const std::vector<std::vector<int>> &output_shapes,
+                                                                     const Target &target) {
+  CHECK(attrs.attr_store.count("tile_size")) << "tile_size is not found in conv2d_winograd_weight_transform op";
+  int tile_size = absl::get<int>(attrs.attr_store.at("tile_size"));
+
+  framework::CINNCompute transform_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of conv2d_winograd_weight_transform compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK(!a.empty()) << "at least one input tensor for conv2d_winograd_weight_transform compute\n";
+    Expr A = a[0];
+    CHECK(A.as_tensor());
+    auto out = pe::Conv2d_Winograd_WeightTransform(
+        A.as_tensor_ref(), tile_size, UniqName("Conv2d_winograd_weight_transform_out"));
+    auto stages = CreateStages({A.as_tensor_ref(), out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  framework::CINNSchedule transform_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of conv2d_winograd_weight_transform schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 2UL);
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of conv2d_winograd_weight_transform op is empty! Please check.";
+  if (out_type[0] == Float(32)) {
+    strategy->AddImpl(transform_compute, transform_schedule, "strategy.conv2d_winograd_weight_transform.x86", 1);
+  } else {
+    LOG(FATAL) << "Conv2d_winograd_weight_transform op with dtype != float32 is not implemented yet!";
+  }
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForConv2dWinogradWeightTransform(const std::vector<shape_t> &inputs_shape,
+                                                                 const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The input's shape size should be 1! Please check again.";
+  CHECK_EQ(inputs_shape[0].size(), 4U) << "The weight's shape size should be 4! Please check again.";
+  CHECK(attrs.count("tile_size")) << "tile_size is not found in conv2d_winograd_weight_transform op";
+  int alpha = absl::get<int>(attrs.at("tile_size")) + 2;
+  // [C_out, C_in, 3, 3] -> [alpha, alpha, C_in, C_out]
+  return {{alpha, alpha, inputs_shape[0][1], inputs_shape[0][0]}};
+}
+
+std::vector<Type> InferDtypeForConv2dWinogradWeightTransform(const std::vector<Type> &inputs_type,
+                                                             const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0]};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForConv2dWinogradWeightTransform(
+    const std::vector<framework::shape_t> &input_shapes,
+    const std::vector<std::string> &input_layouts,
+    const framework::NodeAttr &attrs,
+    const Target &target) {
+  CHECK_EQ(input_layouts.size(), 1U) << "The input's layouts size is not 1! Please check again.";
+  return {{""}, input_layouts};
+}
+
 std::shared_ptr<OpStrategy> StrategyForConv2dNCHWc(const framework::NodeAttr &attrs,
                                                    const std::vector<ir::Tensor> &inputs,
                                                    const std::vector<Type> &out_type,
@@ -1501,21 +1650,21 @@ std::vector<std::vector<std::string>> InferLayoutForPool(const std::vector<frame
   return {input_layouts, input_layouts};
 }
 
-std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
-                                               const std::vector<ir::Tensor> &inputs,
-                                               const std::vector<Type> &out_type,
-                                               const std::vector<std::vector<int>> &output_shapes,
-                                               const Target &target) {
-  int axis = -1;
+std::shared_ptr<OpStrategy> StrategyForSoftmaxImpl(const framework::NodeAttr &attrs,
+                                                   const std::vector<Type> &out_type,
+                                                   const Target &target,
+                                                   bool is_log) {
+  std::string op_name = is_log ? "log_softmax" : "softmax";
+  int axis            = -1;
   for (auto &iter : attrs.attr_store) {
     if (iter.first == "axis") {
       axis = absl::get<int>(iter.second);
     }
   }
   framework::CINNCompute softmax_compute([=](lang::Args args, lang::RetValue *ret) {
-    CHECK(!args.empty()) << "The input arguments of softmax compute is empty! Please check.";
+    CHECK(!args.empty()) << "The input arguments of " << op_name << " compute is empty! Please check.";
     CINNValuePack a = args[0];
-    CHECK(!a.empty()) << "The input tensors of softmax compute is empty! Please check.";
+    CHECK(!a.empty()) << "The input tensors of " << op_name << " compute is empty! Please check.";
     Expr A_expr = a[0];
     CHECK(A_expr.as_tensor());
     ir::Tensor A = A_expr.as_tensor_ref();
@@ -1526,7 +1675,9 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
     }
     std::vector<ir::Tensor> out;
     bool use_mkldnn = false;
-    if (use_mkldnn) {
+    if (is_log) {
+      out = pe::LogSoftmax(A, new_axis, UniqName("LogSoftmax_output"));
+    } else if (use_mkldnn) {
       out = pe::SoftmaxMKLDNN(A, new_axis, UniqName("Softmax_mkldnn_output"));
     } else {
       out = pe::Softmax(A, new_axis, UniqName("Softmax_output"));
@@ -1536,44 +1687,73 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
       stages->InsertLazily(t);
       res.push_back(CINNValue(t));
     }
-    CHECK_EQ(out.size(), 2U) << "The size of pe::Softmax's output should be 2.";
-    CHECK(!out_type.empty()) << "Output type of Softmax is empty! Please check.\n";
+    CHECK(out.size() == 2U || out.size() == 4U) << "The size of pe::Softmax's output should be 2 or 4.";
+    CHECK(!out_type.empty()) << "Output type of " << op_name << " is empty! Please check.\n";
     res.push_back(CINNValue(stages));
     *ret = CINNValuePack{res};
   });
 
   framework::CINNSchedule softmax_schedule([=](lang::Args args, lang::RetValue *ret) {
-    CHECK(!args.empty()) << "The input arguments of softmax schedule is empty! Please check.";
+    CHECK(!args.empty()) << "The input arguments of " << op_name << " schedule is empty! Please check.";
     CINNValuePack arg_pack = args[0];
-    CHECK_EQ(arg_pack.size(), 3UL) << "The input tensor's size of softmax schedule is " << arg_pack.size()
-                                   << "and it should be equal to 3! Please check.";
-    Expr out1             = arg_pack[0];
-    Expr out2             = arg_pack[1];
-    poly::StageMap stages = arg_pack[2];
-    CHECK(out1.as_tensor());
-    CHECK(out2.as_tensor());
-    ir::Tensor tensor_a = out1.as_tensor_ref();
-    ir::Tensor tensor_b = out2.as_tensor_ref();
+    if (arg_pack.size() == 3UL) {
+      // the extern call of mkldnn
+      *ret = arg_pack;
+      return;
+    }
+    CHECK_EQ(arg_pack.size(), 5UL) << "The input tensor's size of " << op_name << " schedule is " << arg_pack.size()
+                                   << "and it should be equal to 5! Please check.";
+    std::vector<ir::Tensor> tensors;
+    for (int i = 0; i < 4; i++) {
+      Expr t = arg_pack[i];
+      CHECK(t.as_tensor());
+      tensors.push_back(t.as_tensor_ref());
+    }
+    poly::StageMap stages = arg_pack[4];
+    ir::Tensor tensor_a   = tensors[0];
+    ir::Tensor tensor_b   = tensors[1];
+    ir::Tensor tensor_max = tensors[2];
+    ir::Tensor tensor_exp = tensors[3];
     if (target.arch == Target::Arch::NVGPU) {
+      stages[tensor_exp]->ComputeInline();
       if (tensor_a->shape.size() > 1) {
         stages[tensor_a]->Split(1, 2);
         stages[tensor_a]->Bind(0, "blockIdx.x");
         stages[tensor_a]->Bind(1, "threadIdx.x");
         int shape_size = tensor_a->shape.size();
+        stages[tensor_max]->ComputeAt(stages[tensor_a], shape_size);
         stages[tensor_b]->ComputeAt(stages[tensor_a], shape_size);
       }
     } else if (target.arch == Target::Arch::X86) {
-      pe::SoftmaxScheduleCPU(stages, tensor_a, tensor_b, axis);
+      // log_softmax only reads the exponents in the sum
+      if (is_log) stages[tensor_exp]->ComputeInline();
+      pe::SoftmaxScheduleCPU(stages, tensor_a, tensor_b, tensor_max, tensor_exp, axis, target);
     }
-    *ret = arg_pack;
+    *ret = CINNValuePack{{arg_pack[0], arg_pack[1], CINNValue(stages)}};
   });
 
   auto strategy = std::make_shared<framework::OpStrategy>();
-  strategy->AddImpl(softmax_compute, softmax_schedule, "strategy.softmax.x86", 1);
+  strategy->AddImpl(softmax_compute, softmax_schedule, "strategy." + op_name + ".x86", 1);
 
   return strategy;
 }
 
+std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
+                                               const std::vector<ir::Tensor> &inputs,
+                                               const std::vector<Type> &out_type,
+                                               const std::vector<std::vector<int>> &output_shapes,
+                                               const Target &target) {
+  return StrategyForSoftmaxImpl(attrs, out_type, target, false);
+}
+
+std::shared_ptr<OpStrategy> StrategyForLogSoftmax(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<Type> &out_type,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  const Target &target) {
+  return StrategyForSoftmaxImpl(attrs, out_type, target, true);
+}
+
 std::vector<std::vector<int>> InferShapeForSoftmax(const std::vector<std::vector<int>> &inputs_shape,
                                                    const framework::AttrMapType &attrs) {
   CHECK(!inputs_shape.empty() && !inputs_shape[0].empty()) << "The input's shape size is 0! Please check again.";
@@ -1963,6 +2143,20 @@ CINN_REGISTER_HELPER(nn_ops) {
 #endif
       .set_support_level(4);
 
+  CINN_REGISTER_OP(conv2d_winograd_weight_transform)
+      .describe("Transform the 3x3 weights of conv2d for the Winograd algorithm, which is run once before execution.")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>(
+          "CINNStrategy", cinn::hlir::op::StrategyForConv2dWinogradWeightTransform)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForConv2dWinogradWeightTransform))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForConv2dWinogradWeightTransform))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForConv2dWinogradWeightTransform))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(conv2d_NCHWc)
       .describe("Do a 2-D convolution with an NCHWc layout. Input is 5D tensor and weight is 6D tensor.")
       .set_num_inputs(2)  // here we consider filter as another input
@@ -2064,6 +2258,19 @@ CINN_REGISTER_HELPER(nn_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(log_softmax)
+      .describe("This operator implements the log_softmax layer, which computes log(softmax(x)) in one pass")
+      .set_num_inputs(1)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForLogSoftmax)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForSoftmax))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForSoftmax))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForSoftmax))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(slice)
       .describe("This operator implements the slice layer")
       .set_num_inputs(1)
@@ -92,6 +92,10 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
         stages[out]->Bind(0, "blockIdx.x");
         stages[out]->Bind(1, "threadIdx.x");
       }
+    } else if (target.arch == Target::Arch::X86) {
+      auto res = pe::ReduceScheduleCPU(stages, out, target);
+      *ret     = CINNValuePack{{CINNValue(res), CINNValue(stages)}};
+      return;
     }
     *ret = arg_pack;
   });
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <map>
+#include <unordered_set>
+
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -124,6 +127,364 @@ std::vector<framework::shape_t> UpdateInferInfos(Node* node,
   return infershapes;
 }
 
+int Gcd(int a, int b) { return b == 0 ? a : Gcd(b, a % b); }
+
+std::string GetConv2dAlgorithm(const Node* node) {
+  auto it = node->attrs.attr_store.find("algorithm");
+  return it == node->attrs.attr_store.end() ? "direct" : absl::get<std::string>(it->second);
+}
+
+// The ops computing NCHWxc outputs from NCHWxc inputs with the same channel block.
+bool IsLayoutAgnostic(const Node* node) {
+  static std::unordered_set<std::string> agnostic_ops = {"pool2d", "concat", "batchnorm"};
+  auto& op_pattern_dict                               = Operator::GetAttrs<framework::OpPatternKind>("OpPattern");
+  auto pattern                                        = op_pattern_dict[node->op()];
+  return pattern == framework::kElemWise || pattern == framework::kBroadcast ||
+         agnostic_ops.count(node->op()->name);
+}
+
+// The disjoint sets of the 4-D vars which should share the same channel block after altering layout.
+class ChannelBlockRegions {
+ public:
+  std::string Find(const std::string& var) {
+    auto it = parent_.find(var);
+    if (it == parent_.end()) {
+      parent_[var] = var;
+      return var;
+    }
+    if (it->second == var) return var;
+    auto root    = Find(it->second);
+    parent_[var] = root;
+    return root;
+  }
+
+  void Union(const std::string& a, const std::string& b) {
+    auto root_a = Find(a);
+    auto root_b = Find(b);
+    if (root_a != root_b) parent_[root_a] = root_b;
+  }
+
+  std::vector<std::string> Vars() const {
+    std::vector<std::string> res;
+    for (auto& item : parent_) res.push_back(item.first);
+    return res;
+  }
+
+ private:
+  absl::flat_hash_map<std::string, std::string> parent_;
+};
+
+/**
+ * Plan the channel blocks of all the NCHW conv2d ops in the graph before altering their layouts.
+ *
+ * The output of a conv2d_NCHWc flows through the layout agnostic ops into other convs, and the vars joined on this
+ * way form a region. All the vars in a region use the same channel block, so no layout_transform is needed inside the
+ * region, and the inputs of a broadcast (e.g. the residual add of two convs) never mismatch. The block of a region is
+ * voted by the favorite factors of its convs and must divide all the channels of the region. The grouped and depthwise
+ * convs keep their own factors and do not vote, a layout_transform is left at their inputs or outputs if the blocks of
+ * the regions differ.
+ * @return The factors(oc_bn, ic_bn, fc_bn) of each conv2d, keyed by the node id.
+ */
+absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, int>> PlanConv2dFactors(
+    Graph* graph,
+    const std::vector<GraphNode*>& store_nodes,
+    const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict,
+    const absl::flat_hash_map<std::string, Type>& type_dict) {
+  absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, int>> conv_factors;
+  ChannelBlockRegions regions;
+  // the blocks favored by the convs for each var: block -> votes
+  absl::flat_hash_map<std::string, std::map<int, int>> favorites;
+  auto is_4d = [&](GraphNode* var) { return shape_dict.count(var->id()) && shape_dict.at(var->id()).size() == 4; };
+
+  for (auto* graph_node : store_nodes) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node) continue;
+    if (node->op()->name == "conv2d") {
+      if (absl::get<std::string>(node->attrs.attr_store.at("data_format")) != "NCHW") continue;
+      // the convs with other algorithms compute on NCHW
+      if (GetConv2dAlgorithm(node) != "direct") continue;
+      auto& inlinks  = node->inlinks_in_order(true);
+      auto& outlinks = node->outlinks_in_order(true);
+      auto* input    = inlinks[0]->source();
+      auto* output   = outlinks[0]->sink();
+      auto& weight   = shape_dict.at(inlinks[1]->source()->id());
+      if (!is_4d(input) || weight.size() != 4) continue;
+      int oc = weight[0];
+      int fc = weight[1];
+      int ic = shape_dict.at(input->id())[1];
+      auto key = absl::get<std::string>(node->attrs.attr_store.at("key"));
+      auto& factors = conv_factors[node->id()];
+      pe::GetConv2dFactors(&factors, oc, ic, fc, -1, -1, type_dict.at(input->id()), graph->target_, key);
+      // the grouped and depthwise convs derive fc_bn from oc_bn, they keep their own blocks and do not vote
+      if (ic != fc) continue;
+      favorites[regions.Find(input->id())][factors["ic_bn"]]++;
+      favorites[regions.Find(output->id())][factors["oc_bn"]]++;
+    } else if (IsLayoutAgnostic(node)) {
+      auto& outlinks = node->outlinks_in_order(true);
+      if (outlinks.empty() || !is_4d(outlinks[0]->sink())) continue;
+      auto* output = outlinks[0]->sink();
+      int channel  = shape_dict.at(output->id())[1];
+      for (auto& link : node->inlinks_in_order(true)) {
+        auto* input = link->source();
+        // skip the broadcast operands like bias, the channels of concat's inputs are summed up
+        if (!is_4d(input) || (node->op()->name != "concat" && shape_dict.at(input->id())[1] != channel)) continue;
+        regions.Union(input->id(), output->id());
+      }
+    }
+  }
+
+  // vote the block of each region
+  absl::flat_hash_map<std::string, std::map<int, int>> region_votes;
+  absl::flat_hash_map<std::string, int> region_gcd;
+  for (auto& var : regions.Vars()) {
+    auto root = regions.Find(var);
+    if (favorites.count(var)) {
+      for (auto& item : favorites.at(var)) region_votes[root][item.first] += item.second;
+    }
+    int channel      = shape_dict.at(var)[1];
+    region_gcd[root] = region_gcd.count(root) ? Gcd(region_gcd[root], channel) : channel;
+  }
+  absl::flat_hash_map<std::string, int> region_block;
+  for (auto& item : region_votes) {
+    int gcd   = region_gcd.at(item.first);
+    int block = 1;
+    int votes = 0;
+    for (auto& vote : item.second) {
+      if (gcd % vote.first == 0 && (vote.second > votes || (vote.second == votes && vote.first > block))) {
+        block = vote.first;
+        votes = vote.second;
+      }
+    }
+    if (!votes) {
+      // no favorite block divides all the channels, take the largest common one under the favorites
+      int max_block = item.second.rbegin()->first;
+      for (int i = std::min(max_block, gcd); i > 1; i--) {
+        if (gcd % i == 0) {
+          block = i;
+          break;
+        }
+      }
+    }
+    region_block[item.first] = block;
+  }
+
+  int num_replanned = 0;
+  for (auto* graph_node : store_nodes) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node || !conv_factors.count(node->id())) continue;
+    auto& inlinks = node->inlinks_in_order(true);
+    auto& weight  = shape_dict.at(inlinks[1]->source()->id());
+    if (weight[1] != shape_dict.at(inlinks[0]->source()->id())[1]) continue;
+    auto& factors = conv_factors[node->id()];
+    int ic_bn     = region_block.at(regions.Find(inlinks[0]->source()->id()));
+    int oc_bn     = region_block.at(regions.Find(node->outlinks_in_order(true)[0]->sink()->id()));
+    if (ic_bn != factors["ic_bn"] || oc_bn != factors["oc_bn"]) num_replanned++;
+    factors["ic_bn"] = ic_bn;
+    factors["oc_bn"] = oc_bn;
+    factors["fc_bn"] = ic_bn;
+  }
+  VLOG(2) << "Plan the channel blocks of " << region_block.size() << " regions, " << num_replanned << " of "
+          << conv_factors.size() << " convs change their blocks to share with the neighbors";
+  return conv_factors;
+}
+
+// Let the consumer read new_var instead of old_var, the order of its inputs is kept.
+void ReplaceInputOf(Node* consumer, GraphNode* old_var, GraphNode* new_var) {
+  std::vector<GraphNode*> inputs;
+  for (auto& link : consumer->inlinks_in_order(true)) {
+    inputs.push_back(link->source());
+  }
+  for (auto* input : inputs) {
+    input->UnLinkTo(consumer);
+  }
+  for (auto* input : inputs) {
+    (input == old_var ? new_var : input)->LinkTo(consumer);
+  }
+  consumer->inlinks_in_order(true);
+}
+
+// Let all the consumers of old_var read new_var.
+void ReplaceAllUsesOf(GraphNode* old_var, GraphNode* new_var) {
+  std::vector<Node*> consumers;
+  for (auto& link : old_var->outlinks()) {
+    consumers.push_back(link->sink()->safe_as<Node>());
+  }
+  for (auto* consumer : consumers) {
+    CHECK(consumer);
+    ReplaceInputOf(consumer, old_var, new_var);
+  }
+}
+
+std::string GetLayoutAttr(const Node* node, const std::string& attr) {
+  return absl::get<std::string>(node->attrs.attr_store.at(attr));
+}
+
+/**
+ * Remove the redundant layout_transforms inserted by altering the layouts op by op:
+ * 1. the transforms of the same var to the same layout are merged into one.
+ * 2. the transform converting the layout back right after another transform is cancelled.
+ * The final outputs of the graph are kept.
+ * @return The number of removed layout_transforms.
+ */
+int RemoveRedundantLayoutTransforms(Graph* graph) {
+  int num_removed  = 0;
+  auto is_transform = [](GraphNode* graph_node) {
+    auto* node = graph_node ? graph_node->safe_as<Node>() : nullptr;
+    return node && node->op()->name == "layout_transform" ? node : nullptr;
+  };
+  auto drop = [&](Node* trans_node) {
+    auto& inlinks  = trans_node->inlinks_in_order(true);
+    auto& outlinks = trans_node->outlinks_in_order(true);
+    auto* input    = inlinks[0]->source();
+    auto* output   = outlinks[0]->sink();
+    input->UnLinkTo(trans_node);
+    trans_node->UnLinkTo(output);
+    num_removed++;
+  };
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto* graph_node : std::get<0>(graph->topological_order())) {
+      auto* var = graph_node->safe_as<NodeData>();
+      if (!var) continue;
+      std::vector<Node*> transforms;
+      for (auto& link : var->outlinks()) {
+        auto* trans_node = is_transform(link->sink());
+        if (trans_node) transforms.push_back(trans_node);
+      }
+      // 1. merge the same transforms
+      absl::flat_hash_map<std::string, Node*> kept;
+      for (auto* trans_node : transforms) {
+        auto* output = trans_node->outlinks_in_order(true)[0]->sink();
+        auto dst     = GetLayoutAttr(trans_node, "dst_layout");
+        if (!kept.count(dst)) {
+          kept[dst] = trans_node;
+          continue;
+        }
+        if (output->outlinks().empty()) continue;
+        VLOG(3) << "merge " << trans_node->id() << " into " << kept[dst]->id();
+        ReplaceAllUsesOf(output, kept[dst]->outlinks_in_order(true)[0]->sink());
+        drop(trans_node);
+        changed = true;
+      }
+      if (changed) break;
+      // 2. cancel the transforms back to the source layout
+      auto* producer = var->inlinks().empty() ? nullptr : is_transform((*var->inlinks().begin())->source());
+      if (!producer) continue;
+      auto* source = producer->inlinks_in_order(true)[0]->source();
+      for (auto* trans_node : transforms) {
+        auto* output = trans_node->outlinks_in_order(true)[0]->sink();
+        if (output->outlinks().empty()) continue;
+        if (GetLayoutAttr(trans_node, "dst_layout") != GetLayoutAttr(producer, "src_layout")) continue;
+        VLOG(3) << "cancel " << producer->id() << " with " << trans_node->id();
+        ReplaceAllUsesOf(output, source);
+        drop(trans_node);
+        changed = true;
+      }
+      if (changed) {
+        if (var->outlinks().empty()) drop(producer);
+        break;
+      }
+    }
+  }
+  return num_removed;
+}
+
+/**
+ * Prepare the inputs of a conv2d computed by the algorithm other than direct on NCHW: transform the input back to
+ * NCHW if it is blocked, and transform the weights once before execution for the Winograd algorithm.
+ */
+void PrepareConv2dAlgorithm(Graph* graph,
+                            Node* node,
+                            const OpValueType<InferShapeFunc>& op_infershape,
+                            const OpValueType<InferTypeFunc>& op_inferdtype,
+                            const OpValueType<InferLayoutFunc>& op_inferlayout,
+                            absl::flat_hash_map<std::string, framework::shape_t>* shape_dict,
+                            absl::flat_hash_map<std::string, Type>* type_dict,
+                            absl::flat_hash_map<std::string, std::string>* layout_dict) {
+  auto algorithm     = GetConv2dAlgorithm(node);
+  auto& conv_inlinks = node->inlinks_in_order(true);
+  CHECK_EQ(conv_inlinks.size(), 2U) << "conv2d should have 2 inputs";
+  auto* input_data  = conv_inlinks[0]->source()->safe_as<NodeData>();
+  auto* weight_data = conv_inlinks[1]->source()->safe_as<NodeData>();
+  CHECK(input_data);
+  CHECK(weight_data);
+  auto input_shape          = shape_dict->at(input_data->id());
+  auto weight_shape         = shape_dict->at(weight_data->id());
+  auto input_type           = type_dict->at(input_data->id());
+  auto weight_type          = type_dict->at(weight_data->id());
+  std::string weight_layout = "OIHW";
+
+  if (input_shape.size() == 5) {
+    CHECK(layout_dict->count(input_data->id())) << input_data->id() << " should have out_layout attr";
+    std::string src_input_layout = layout_dict->at(input_data->id());
+    Node* trans_node;
+    NodeData* output_data;
+    std::tie(trans_node, output_data) =
+        InsertLayoutTransformNodeAfter(graph,
+                                       input_data,
+                                       node,
+                                       0,
+                                       src_input_layout,
+                                       "NCHW",
+                                       common::UniqName(node->op()->name + "_input_layout_tranform"));
+    UpdateInferInfos(trans_node,
+                     {input_shape},
+                     {input_type},
+                     {src_input_layout},
+                     graph->target_,
+                     op_infershape,
+                     op_inferdtype,
+                     op_inferlayout,
+                     shape_dict,
+                     type_dict,
+                     layout_dict);
+    input_shape = shape_dict->at(output_data->id());
+  }
+  if (algorithm == "winograd") {
+    CHECK_EQ(weight_shape.size(), 4U) << weight_data->id() << " shape dim should be 4";
+    CHECK(weight_shape[2] == 3 && weight_shape[3] == 3)
+        << "winograd conv2d only supports the 3x3 filter, but " << node->id() << " has a " << weight_shape[2] << "x"
+        << weight_shape[3] << " one";
+    std::string op_type = "conv2d_winograd_weight_transform";
+    auto trans_node     = new Node(Operator::Get(op_type), op_type, common::UniqName(op_type));
+    trans_node->attrs.attr_store["tile_size"] = node->attrs.attr_store.at("tile_size");
+    auto output_data                          = InsertGraphOpNodeAfter(graph, trans_node, weight_data, node, 1);
+    // the weights fed as params or computed only from params, e.g. folded with a batchnorm, are transformed only once
+    auto* weight_source = weight_data->source_node.get();
+    if (!weight_source || (weight_source->attrs.attr_store.count("pre_run") &&
+                           absl::get<bool>(weight_source->attrs.attr_store.at("pre_run")))) {
+      trans_node->attrs.attr_store["pre_run"] = true;
+    }
+    UpdateInferInfos(trans_node,
+                     {weight_shape},
+                     {weight_type},
+                     {weight_layout},
+                     graph->target_,
+                     op_infershape,
+                     op_inferdtype,
+                     op_inferlayout,
+                     shape_dict,
+                     type_dict,
+                     layout_dict);
+    weight_shape  = shape_dict->at(output_data->id());
+    weight_layout = "";
+  }
+  UpdateInferInfos(node,
+                   {input_shape, weight_shape},
+                   {input_type, weight_type},
+                   {"NCHW", weight_layout},
+                   graph->target_,
+                   op_infershape,
+                   op_inferdtype,
+                   op_inferlayout,
+                   shape_dict,
+                   type_dict,
+                   layout_dict);
+  VLOG(3) << "conv2d " << node->id() << " uses the " << algorithm << " algorithm";
+}
+
 void AlterLayoutPass(Graph* graph) {
   // alterlayout only in X86 for it's specific layout requirements
   if (graph->target_.arch == Target::Arch::X86) {
@@ -161,10 +522,32 @@ void AlterLayoutPass(Graph* graph) {
         std::string key = pe::GenerateX86ConvKey(inputs_shape[0], inputs_shape[1], stride, padding, dilation);
         VLOG(3) << "key: " << key;
         node->attrs.attr_store["key"] = key;
+        // select the conv algorithm unless it is specified
+        bool is_nchw = !node->attrs.attr_store.count("data_format") ||
+                       absl::get<std::string>(node->attrs.attr_store.at("data_format")) == "NCHW";
+        if (!node->attrs.attr_store.count("algorithm") && is_nchw && inputs_shape[0].size() == 4 &&
+            inputs_shape[1].size() == 4) {
+          auto* input_data = conv_inlinks[0]->source()->safe_as<NodeData>();
+          // an input produced by other ops is likely blocked by the NCHWc convs before, and has to be transformed
+          // back to NCHW for the algorithms other than direct
+          double extra_bytes = 0;
+          if (input_data && input_data->source_node.get()) {
+            extra_bytes = 2.0 * type_dict.at(input_data->id()).bits() / 8;
+            for (int dim : inputs_shape[0]) extra_bytes *= dim;
+          }
+          int tile_size  = 0;
+          auto algorithm = pe::SelectConv2dAlgorithm(
+              inputs_shape[0], inputs_shape[1], stride, padding, dilation, extra_bytes, graph->target_, &tile_size);
+          node->attrs.attr_store["algorithm"] = algorithm;
+          if (algorithm == "winograd") {
+            node->attrs.attr_store["tile_size"] = tile_size;
+          }
+        }
       }
     }
 
-    bool has_altered = false;
+    auto conv_factors = PlanConv2dFactors(graph, store_nodes, shape_dict, type_dict);
+    bool has_altered  = false;
     for (int i = 0; i < store_nodes.size(); i++) {
       auto node = store_nodes[i]->safe_as<Node>();
       if (node) {
@@ -175,7 +558,19 @@ void AlterLayoutPass(Graph* graph) {
             // not NCHW such as NHWC or has already been altered layout
             continue;
           }
-          has_altered             = true;
+          has_altered = true;
+          if (GetConv2dAlgorithm(node) != "direct") {
+            // keep the conv2d op on NCHW with its selected algorithm
+            PrepareConv2dAlgorithm(graph,
+                                   node,
+                                   op_infershape,
+                                   op_inferdtype,
+                                   op_inferlayout,
+                                   &shape_dict,
+                                   &type_dict,
+                                   &layout_dict);
+            continue;
+          }
           std::string new_op_type = node->op()->name + "_NCHWc";
           // alter conv2d op to conv2d_NCHWc
           Node* new_node             = new Node(Operator::Get(new_op_type), new_op_type, common::UniqName(new_op_type));
@@ -210,19 +605,28 @@ void AlterLayoutPass(Graph* graph) {
           absl::flat_hash_map<std::string, int> conv2d_factors;
           int oc = weight_shape[0];
           int fc = weight_shape[1];
-          int ic = input_shape[1];
+          int ic = input_shape.size() == 5 ? input_shape[1] * input_shape[4] : input_shape[1];
 
-          // get the original conv config stored in the key attr
-          CHECK(new_node->attrs.attr_store.count("key")) << "conv2d finds no key attr";
-          std::string key = absl::get<std::string>(new_node->attrs.attr_store.at("key"));
-          VLOG(3) << "key: " << key;
-          pe::GetConv2dFactors(&conv2d_factors, oc, ic, fc, -1, -1, input_type, graph->target_, key);
+          if (conv_factors.count(node->id())) {
+            conv2d_factors = conv_factors.at(node->id());
+          } else {
+            // get the original conv config stored in the key attr
+            CHECK(new_node->attrs.attr_store.count("key")) << "conv2d finds no key attr";
+            std::string key = absl::get<std::string>(new_node->attrs.attr_store.at("key"));
+            VLOG(3) << "key: " << key;
+            pe::GetConv2dFactors(&conv2d_factors, oc, ic, fc, -1, -1, input_type, graph->target_, key);
+          }
           CHECK(conv2d_factors.count("oc_bn"));
           CHECK(conv2d_factors.count("ic_bn"));
           CHECK(conv2d_factors.count("fc_bn"));
           int oc_bn = conv2d_factors["oc_bn"];
           int ic_bn = conv2d_factors["ic_bn"];
           int fc_bn = conv2d_factors["fc_bn"];
+          if (input_shape.size() == 5 && input_shape[4] != ic_bn && ic == fc) {
+            // the input has been blocked by another region plan, follow it
+            ic_bn = input_shape[4];
+            fc_bn = ic_bn;
+          }
           VLOG(3) << "oc_bn: " << oc_bn;
           VLOG(3) << "ic_bn: " << ic_bn;
           VLOG(3) << "fc_bn: " << fc_bn;
@@ -577,6 +981,13 @@ void AlterLayoutPass(Graph* graph) {
           break;
         }
       }
+      int num_removed = RemoveRedundantLayoutTransforms(graph);
+      int num_left    = 0;
+      for (auto* graph_node : std::get<0>(graph->topological_order())) {
+        auto* node = graph_node->safe_as<Node>();
+        if (node && node->op()->name == "layout_transform" && !node->inlinks().empty()) num_left++;
+      }
+      VLOG(1) << "AlterLayout removes " << num_removed << " redundant layout_transforms, " << num_left << " left";
       graph->ClearUnlinkedNodes(&shape_dict, &type_dict, &layout_dict);
       graph->attrs["infershape"]  = std::make_shared<absl::any>(shape_dict);
       graph->attrs["inferdtype"]  = std::make_shared<absl::any>(type_dict);
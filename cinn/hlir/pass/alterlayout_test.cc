@@ -12,16 +12,29 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <dirent.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
 #include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "cinn/cinn.h"
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/param_transform.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pe/nn.h"
+#include "cinn/hlir/pe/schedule.h"
 #include "cinn/hlir/pass/use_pass.h"
 
 DEFINE_string(model_dir, "", "");
@@ -460,5 +473,404 @@ TEST(conv_mul_conv, conv_mul_conv) {
   runtime_program->Execute();
 }
 
+TEST(conv_residual_add, conv_residual_add) {
+  Placeholder A(Float(32), {1, 16, 28, 28}, "A");
+  Placeholder B(Float(32), {48, 16, 3, 3}, "B");
+  Placeholder D(Float(32), {48, 16, 1, 1}, "D");
+  Placeholder E(Float(32), {48, 48, 3, 3}, "E");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({1, 1});
+  attrs["data_format"] = std::string("NCHW");
+  attrs["algorithm"]   = std::string("direct");
+  absl::flat_hash_map<std::string, Program::attr_t> attrs_1x1 = attrs;
+  attrs_1x1["padding"]                                        = std::vector<int>({0, 0});
+
+  // two branches read A, and their outputs are added
+  auto c = program.conv2d(A, B, attrs);
+  auto d = program.relu(c);
+  auto e = program.conv2d(d, E, attrs);
+  auto f = program.conv2d(A, D, attrs_1x1);
+  auto g = program.add(e, f);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B, D, E});
+  program.Validate();
+  LOG(INFO) << "Program:\n" << program;
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+
+  // A is transformed once for both convs, and the add reads the outputs of the convs directly.
+  int num_input_transforms = 0;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (!node) continue;
+    auto& inlinks = node->inlinks_in_order(true);
+    if (node->op()->name == "layout_transform" && inlinks[0]->source()->id() == "A") num_input_transforms++;
+    if (node->op()->name == "elementwise_add") {
+      for (auto& link : inlinks) {
+        auto* producer = (*link->source()->inlinks().begin())->source()->safe_as<hlir::framework::Node>();
+        ASSERT_EQ(producer->op()->name, "conv2d_NCHWc");
+      }
+    }
+  }
+  ASSERT_EQ(num_input_transforms, 1);
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  for (auto& name : {"A", "B", "D", "E"}) {
+    SetRandData(scope->GetTensor(name), target);
+  }
+  runtime_program->PreRun();
+  runtime_program->Execute();
+}
+
+// The NCHW conv of stride 1 on the host as the reference, the input and the output are of batch 1.
+std::vector<float> NaiveConv2d(const std::vector<float>& input,
+                               int ic,
+                               int h,
+                               int w,
+                               const std::vector<float>& weight,
+                               int oc,
+                               int k,
+                               int pad,
+                               int groups) {
+  int oh = h + 2 * pad - k + 1;
+  int ow = w + 2 * pad - k + 1;
+  int fc = ic / groups;
+  std::vector<float> res(oc * oh * ow, 0.f);
+  for (int o = 0; o < oc; o++) {
+    int g = o / (oc / groups);
+    for (int y = 0; y < oh; y++) {
+      for (int x = 0; x < ow; x++) {
+        float sum = 0.f;
+        for (int c = 0; c < fc; c++) {
+          for (int i = 0; i < k; i++) {
+            for (int j = 0; j < k; j++) {
+              int iy = y + i - pad;
+              int ix = x + j - pad;
+              if (iy < 0 || iy >= h || ix < 0 || ix >= w) continue;
+              sum += input[((g * fc + c) * h + iy) * w + ix] * weight[((o * fc + c) * k + i) * k + j];
+            }
+          }
+        }
+        res[(o * oh + y) * ow + x] = sum;
+      }
+    }
+  }
+  return res;
+}
+
+TEST(conv_depthwise_conv, conv_depthwise_conv) {
+  Placeholder A(Float(32), {1, 16, 14, 14}, "A");
+  Placeholder B(Float(32), {32, 16, 1, 1}, "B");
+  Placeholder D(Float(32), {32, 1, 3, 3}, "D");
+  Placeholder E(Float(32), {48, 32, 1, 1}, "E");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({0, 0});
+  attrs["data_format"] = std::string("NCHW");
+  absl::flat_hash_map<std::string, Program::attr_t> attrs_depthwise = attrs;
+  attrs_depthwise["padding"]                                        = std::vector<int>({1, 1});
+  attrs_depthwise["groups"]                                         = 32;
+
+  // the depthwise conv keeps its own blocks between the regions planned by the other convs
+  auto c = program.conv2d(A, B, attrs);
+  auto d = program.conv2d(c, D, attrs_depthwise);
+  auto e = program.conv2d(d, E, attrs);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B, D, E});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  std::vector<std::vector<float>> inputs;
+  int seed = 0;
+  for (auto& name : {"A", "B", "D", "E"}) {
+    auto tensor = scope->GetTensor(name);
+    auto* data  = tensor->mutable_data<float>(target);
+    for (size_t j = 0; j < tensor->shape().numel(); j++) {
+      data[j] = static_cast<float>((j * 7 + seed) % 17) / 17.f - 0.5f;
+    }
+    inputs.emplace_back(data, data + tensor->shape().numel());
+    seed++;
+  }
+  runtime_program->PreRun();
+  runtime_program->Execute();
+
+  auto expected = NaiveConv2d(inputs[0], 16, 14, 14, inputs[1], 32, 1, 0, 1);
+  expected      = NaiveConv2d(expected, 32, 14, 14, inputs[2], 32, 3, 1, 32);
+  expected      = NaiveConv2d(expected, 32, 14, 14, inputs[3], 48, 1, 0, 1);
+  auto out      = scope->GetTensor(e->id);
+  auto* data    = out->data<float>();
+  ASSERT_EQ(out->shape().numel(), static_cast<uint32_t>(expected.size()));
+  for (int i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(data[i], expected[i], 1e-3) << "The result differs from the reference at " << i;
+  }
+}
+
+std::vector<float> RunConvWithAlgorithm(const std::string& algorithm,
+                                        int tile_size,
+                                        const std::vector<int>& input_shape  = {1, 16, 14, 14},
+                                        const std::vector<int>& weight_shape = {32, 16, 3, 3},
+                                        int pad                              = 1) {
+  Placeholder A(Float(32), input_shape, "A");
+  Placeholder B(Float(32), weight_shape, "B");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({pad, pad});
+  attrs["data_format"] = std::string("NCHW");
+  // the algorithm is selected by AlterLayout if it is empty
+  if (!algorithm.empty()) attrs["algorithm"] = algorithm;
+  if (tile_size) attrs["tile_size"] = tile_size;
+  auto c = program.conv2d(A, B, attrs);
+  auto d = program.relu(c);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  // the outputs of the conv computed on NCHW have the shapes of the tensors of its algorithm
+  auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (!node || node->op()->name != "conv2d") continue;
+    auto& outlinks = node->outlinks_in_order(true);
+    EXPECT_EQ(outlinks.size(), 4U);
+    for (int i = 1; i < outlinks.size(); i++) {
+      auto& shape = shape_dict.at(outlinks[i]->sink()->id());
+      EXPECT_GT(std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>()), 1)
+          << "the output " << i << " of the " << algorithm << " conv is a placeholder";
+    }
+  }
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  int seed             = 0;
+  for (auto& name : {"A", "B"}) {
+    auto tensor = scope->GetTensor(name);
+    auto* data  = tensor->mutable_data<float>(target);
+    for (size_t j = 0; j < tensor->shape().numel(); j++) {
+      data[j] = static_cast<float>((j * 7 + seed) % 17) / 17.f - 0.5f;
+    }
+    seed++;
+  }
+  runtime_program->PreRun();
+  runtime_program->Execute();
+
+  auto out   = scope->GetTensor(d->id);
+  auto* data = out->data<float>();
+  return std::vector<float>(data, data + out->shape().numel());
+}
+
+TEST(conv_algorithm, conv_algorithm) {
+  auto expected = RunConvWithAlgorithm("direct", 0);
+  for (auto& algorithm : std::vector<std::pair<std::string, int>>{{"winograd", 2}, {"winograd", 4}, {"im2col", 0}}) {
+    auto res = RunConvWithAlgorithm(algorithm.first, algorithm.second);
+    ASSERT_EQ(res.size(), expected.size());
+    for (int i = 0; i < res.size(); i++) {
+      ASSERT_NEAR(res[i], expected[i], 1e-3) << algorithm.first << " differs from direct at " << i;
+    }
+  }
+}
+
+TEST(conv_algorithm, select_winograd) {
+  std::vector<int> ones({1, 1});
+  Target target = common::DefaultHostTarget();
+  int tile_size = 0;
+  // the 3x3 stride-1 conv of many channels takes winograd by the cost model
+  ASSERT_EQ(hlir::pe::SelectConv2dAlgorithm({1, 64, 56, 56}, {64, 64, 3, 3}, ones, ones, ones, 0, target, &tile_size),
+            "winograd");
+  ASSERT_EQ(tile_size, 4);
+  // but not the one of few channels, whose transforms cost more than the multiplications they save
+  ASSERT_EQ(hlir::pe::SelectConv2dAlgorithm({1, 3, 16, 16}, {8, 3, 3, 3}, ones, ones, ones, 0, target, &tile_size),
+            "direct");
+
+  // the tuned params override the choice
+  std::vector<int> input_shape({1, 16, 14, 14});
+  std::vector<int> weight_shape({32, 16, 3, 3});
+  auto key     = hlir::pe::GenerateX86ConvKey(input_shape, weight_shape, ones, ones, ones);
+  auto& params = hlir::pe::ScheduleParam::get_x86_instance().GetOrLoadParam(hlir::pe::CreateX86SerialData);
+  ASSERT_FALSE(params.count(key));
+  auto expected = RunConvWithAlgorithm("direct", 0);
+
+  params[key]["winograd_tile"] = {2};
+  ASSERT_EQ(hlir::pe::SelectConv2dAlgorithm(input_shape, weight_shape, ones, ones, ones, 0, target, &tile_size),
+            "winograd");
+  ASSERT_EQ(tile_size, 2);
+  auto res = RunConvWithAlgorithm("", 0);
+
+  params[key]["winograd_tile"] = {0};
+  ASSERT_NE(hlir::pe::SelectConv2dAlgorithm(input_shape, weight_shape, ones, ones, ones, 0, target, &tile_size),
+            "winograd");
+  params.erase(key);
+  ASSERT_EQ(res.size(), expected.size());
+  for (int i = 0; i < res.size(); i++) {
+    ASSERT_NEAR(res[i], expected[i], 1e-3) << "winograd differs from direct at " << i;
+  }
+}
+
+TEST(conv_algorithm, select_im2col) {
+  // the 1x1 conv of many channels takes im2col by the cost model, and computes the same results as direct
+  std::vector<int> input_shape({1, 512, 7, 7});
+  std::vector<int> weight_shape({256, 512, 1, 1});
+  std::vector<int> ones({1, 1});
+  std::vector<int> zeros({0, 0});
+  int tile_size = 0;
+  ASSERT_EQ(hlir::pe::SelectConv2dAlgorithm(
+                input_shape, weight_shape, ones, zeros, ones, 0, common::DefaultHostTarget(), &tile_size),
+            "im2col");
+  auto expected = RunConvWithAlgorithm("direct", 0, input_shape, weight_shape, 0);
+  auto res      = RunConvWithAlgorithm("", 0, input_shape, weight_shape, 0);
+  ASSERT_EQ(res.size(), expected.size());
+  for (int i = 0; i < res.size(); i++) {
+    ASSERT_NEAR(res[i], expected[i], 1e-3 * std::max(1.f, std::abs(expected[i])))
+        << "im2col differs from direct at " << i;
+  }
+}
+
+std::vector<float> RunConvWithParams(bool transform_at_load,
+                                     int weight_seed                                                  = 1,
+                                     const std::string& cache_dir                                     = "",
+                                     const absl::flat_hash_map<std::string, std::string>& param_files = {}) {
+  Placeholder A(Float(32), {1, 16, 14, 14}, "A");
+  Placeholder B(Float(32), {32, 16, 3, 3}, "B");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({1, 1});
+  attrs["data_format"] = std::string("NCHW");
+  attrs["algorithm"]   = std::string("direct");
+  auto c               = program.conv2d(A, B, attrs);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+
+  auto fill = [](hlir::framework::Tensor tensor, int seed) {
+    auto* data = tensor->mutable_data<float>(common::DefaultHostTarget());
+    for (size_t j = 0; j < tensor->shape().numel(); j++) {
+      data[j] = static_cast<float>((j * 7 + seed) % 17) / 17.f - 0.5f;
+    }
+  };
+  // the params are loaded before building the program
+  auto scope   = std::make_shared<hlir::framework::Scope>();
+  auto weights = absl::get<hlir::framework::Tensor>(*scope->Var<hlir::framework::Tensor>("B"));
+  weights->Resize(hlir::framework::Shape({32, 16, 3, 3}));
+  fill(weights, weight_seed);
+  if (transform_at_load) {
+    CHECK_EQ(hlir::framework::TransformParamsAtLoad(graph.get(), scope.get(), target, cache_dir, param_files), 1);
+    CHECK(!scope->FindVar("B")) << "The unpacked weights should be erased";
+  }
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+
+  scope = BuildScope(target, graph, scope);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  fill(scope->GetTensor("A"), 0);
+  runtime_program->PreRun();
+  runtime_program->Execute();
+
+  auto out   = scope->GetTensor(c->id);
+  auto* data = out->data<float>();
+  return std::vector<float>(data, data + out->shape().numel());
+}
+
+TEST(TransformParamsAtLoad, conv2d_NCHWc) {
+  auto expected = RunConvWithParams(false);
+  auto res      = RunConvWithParams(true);
+  ASSERT_EQ(res.size(), expected.size());
+  for (int i = 0; i < res.size(); i++) {
+    ASSERT_NEAR(res[i], expected[i], 1e-5);
+  }
+}
+
+TEST(TransformParamsAtLoad, cache) {
+  char dir_template[] = "/tmp/cinn_param_cache_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir_template));
+  std::string cache_dir(dir_template);
+  for (int seed : {1, 1, 2}) {
+    // the second run maps the cached file, and the changed weights of the third run never reuse it
+    auto expected = RunConvWithParams(false, seed);
+    auto res      = RunConvWithParams(true, seed, cache_dir);
+    ASSERT_EQ(res.size(), expected.size());
+    for (int i = 0; i < res.size(); i++) {
+      ASSERT_NEAR(res[i], expected[i], 1e-5) << "seed " << seed << " differs at " << i;
+    }
+  }
+}
+
+TEST(TransformParamsAtLoad, cache_keyed_by_param_file) {
+  char dir_template[] = "/tmp/cinn_param_cache_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir_template));
+  std::string cache_dir(dir_template);
+  std::string param_file = cache_dir + "/weights";
+  auto num_cached        = [&] {
+    int count = 0;
+    DIR* dir  = opendir(cache_dir.c_str());
+    while (auto* entry = readdir(dir)) {
+      if (std::string(entry->d_name).rfind("B.", 0) == 0) count++;
+    }
+    closedir(dir);
+    return count;
+  };
+  auto write_param_file = [&](const std::string& contents) {
+    std::ofstream os(param_file, std::ios::binary);
+    os << contents;
+  };
+
+  write_param_file("v1");
+  for (int seed : {1, 1}) {
+    // the second run hits the cache keyed by the unchanged file
+    auto expected = RunConvWithParams(false, seed);
+    auto res      = RunConvWithParams(true, seed, cache_dir, {{"B", param_file}});
+    ASSERT_EQ(res.size(), expected.size());
+    for (int i = 0; i < res.size(); i++) {
+      ASSERT_NEAR(res[i], expected[i], 1e-5) << "seed " << seed << " differs at " << i;
+    }
+    ASSERT_EQ(num_cached(), 1);
+  }
+
+  // rewriting the file changes its identity, so the new weights are transformed again
+  write_param_file("v2 with a new size");
+  auto expected = RunConvWithParams(false, 2);
+  auto res      = RunConvWithParams(true, 2, cache_dir, {{"B", param_file}});
+  ASSERT_EQ(res.size(), expected.size());
+  for (int i = 0; i < res.size(); i++) {
+    ASSERT_NEAR(res[i], expected[i], 1e-5) << "the stale cache is used at " << i;
+  }
+  ASSERT_EQ(num_cached(), 2);
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -0,0 +1,401 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unordered_set>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::GraphNode;
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Operator;
+
+using InferShapeFunc = std::function<std::vector<framework::shape_t>(const std::vector<framework::shape_t>&,
+                                                                    const framework::AttrMapType&)>;
+using InferTypeFunc  = std::function<std::vector<Type>(const std::vector<Type>&, const framework::AttrMapType&)>;
+
+/**
+ * Simplify the algebra of the graph and fold the subgraphs computed only from parameters.
+ *
+ * The parameters are the input vars of the graph which are not fed by the user. The op nodes whose inputs are all
+ * parameters or constants are marked as "pre_run", so they are executed only once by Program::PreRun and their
+ * results stay in the Scope. The vars fetched by the user, listed by the "fetch_names" attr of the graph, are kept
+ * computed as they are like the final outputs of the graph, so the ops producing or reading them are not rewritten.
+ */
+class ConstantFolder {
+ public:
+  explicit ConstantFolder(Graph* graph)
+      : graph_(graph),
+        shape_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape")),
+        dtype_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype")),
+        op_infershape_(Operator::GetAttrs<InferShapeFunc>("infershape")),
+        op_inferdtype_(Operator::GetAttrs<InferTypeFunc>("inferdtype")) {
+    if (graph->HasAttr("fetch_names")) {
+      auto& fetch_names = graph->GetAttrs<std::vector<std::string>>("fetch_names");
+      fetches_.insert(fetch_names.begin(), fetch_names.end());
+    }
+  }
+
+  void operator()() {
+    if (!graph_->HasAttr("feed_names") || graph_->GetAttrs<std::vector<std::string>>("feed_names").empty()) {
+      // all the input vars might be fed at runtime
+      VLOG(3) << "The graph declares no feed var, skip constant folding";
+      return;
+    }
+    CollectConstants();
+
+    int num_folded = 0;
+    for (auto* node : OpNodes()) {
+      if (node->op()->name == "batchnorm" && FoldBatchNorm(node)) {
+        num_folded++;
+      } else if (node->op()->name == "scale" && FoldScale(node)) {
+        num_folded++;
+      }
+    }
+    int num_removed = 0;
+    for (auto* node : OpNodes()) {
+      if (IsIdentity(node) && RemoveIdentity(node)) {
+        num_removed++;
+      } else if (node->op()->name == "transpose" && MergeTranspose(node)) {
+        num_removed++;
+      } else if (node->op()->name == "reshape" && MergeReshape(node)) {
+        num_removed++;
+      }
+    }
+    absl::flat_hash_map<std::string, std::string> layout_dict;
+    graph_->ClearUnlinkedNodes(&shape_dict_, &dtype_dict_, &layout_dict);
+
+    // the rewritten graph might introduce new constant subgraphs
+    CollectConstants();
+    int num_pre_run = 0;
+    for (auto* node : OpNodes()) {
+      if (IsConstant(node)) {
+        node->attrs.attr_store["pre_run"] = true;
+        num_pre_run++;
+      }
+    }
+    VLOG(2) << "ConstantFolding folds " << num_folded << " ops into convs, removes " << num_removed
+            << " identity ops and marks " << num_pre_run << " ops computed only from parameters as pre_run";
+  }
+
+ private:
+  std::vector<Node*> OpNodes() {
+    std::vector<Node*> res;
+    for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node) res.push_back(node);
+    }
+    return res;
+  }
+
+  void CollectConstants() {
+    auto& feed_names = graph_->GetAttrs<std::vector<std::string>>("feed_names");
+    std::unordered_set<std::string> feeds(feed_names.begin(), feed_names.end());
+    constants_.clear();
+    for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node) {
+        if (!IsConstant(node)) continue;
+        for (auto& link : node->outlinks()) {
+          constants_.insert(link->sink()->id());
+        }
+      } else if (graph_node->inlinks().empty() && !feeds.count(graph_node->id())) {
+        constants_.insert(graph_node->id());
+      }
+    }
+  }
+
+  bool IsConstant(Node* node) const {
+    for (auto& link : node->inlinks()) {
+      if (!constants_.count(link->source()->id())) return false;
+    }
+    return true;
+  }
+
+  bool IsConstant(NodeData* var) const { return constants_.count(var->id()); }
+
+  static Node* ProducerOf(NodeData* var) {
+    if (var->inlinks().empty()) return nullptr;
+    return (*var->inlinks().begin())->source()->safe_as<Node>();
+  }
+
+  static NodeData* InputOf(Node* node, int i) {
+    auto& inlinks = node->inlinks_in_order(true);
+    CHECK_LT(i, inlinks.size());
+    return inlinks[i]->source()->safe_as<NodeData>();
+  }
+
+  static NodeData* OutputOf(Node* node) {
+    auto& outlinks = node->outlinks_in_order(true);
+    CHECK(!outlinks.empty());
+    return outlinks[0]->sink()->safe_as<NodeData>();
+  }
+
+  bool IsFetched(NodeData* var) const { return fetches_.count(var->id()); }
+
+  // Whether the var only feeds the node and is neither a final output of the graph nor fetched by the user.
+  bool HasSingleUse(NodeData* var) const { return var->outlinks().size() == 1 && !IsFetched(var); }
+
+  template <typename T>
+  static T GetAttr(const Node* node, const std::string& attr, T default_value) {
+    auto& attr_store = node->attrs.attr_store;
+    auto it          = attr_store.find(attr);
+    return it == attr_store.end() ? default_value : absl::get<T>(it->second);
+  }
+
+  // Replace the inputs of the node and keep their order.
+  static void ResetInputs(Node* node, const std::vector<NodeData*>& inputs) {
+    std::vector<GraphNode*> old_inputs;
+    for (auto& link : node->inlinks_in_order(true)) {
+      old_inputs.push_back(link->source());
+    }
+    for (auto* source : old_inputs) {
+      source->UnLinkTo(node);
+    }
+    for (auto* input : inputs) {
+      input->LinkTo(node);
+    }
+    node->inlinks_in_order(true);
+  }
+
+  static void ReplaceInput(Node* node, NodeData* old_var, NodeData* new_var) {
+    std::vector<NodeData*> inputs;
+    for (auto& link : node->inlinks_in_order(true)) {
+      auto* source = link->source()->safe_as<NodeData>();
+      inputs.push_back(source == old_var ? new_var : source);
+    }
+    ResetInputs(node, inputs);
+  }
+
+  void InferShapeAndType(Node* node) {
+    std::vector<framework::shape_t> input_shapes;
+    std::vector<Type> input_types;
+    for (auto& link : node->inlinks_in_order(true)) {
+      input_shapes.push_back(shape_dict_.at(link->source()->id()));
+      input_types.push_back(dtype_dict_.at(link->source()->id()));
+    }
+    auto out_shapes = op_infershape_[node->op()](input_shapes, node->attrs.attr_store);
+    auto out_types  = op_inferdtype_[node->op()](input_types, node->attrs.attr_store);
+    auto& outlinks  = node->outlinks_in_order(true);
+    CHECK_GE(out_shapes.size(), outlinks.size());
+    for (int i = 0; i < outlinks.size(); i++) {
+      shape_dict_[outlinks[i]->sink()->id()] = out_shapes[i];
+      dtype_dict_[outlinks[i]->sink()->id()] = out_types[i];
+    }
+  }
+
+  // Add a single output op node computing from the inputs, and return its output var.
+  NodeData* AddOpNode(const std::string& op_type,
+                      const std::vector<NodeData*>& inputs,
+                      const framework::AttrMapType& attrs) {
+    auto* node             = new Node(Operator::Get(op_type), op_type, common::UniqName(op_type + "_folded"));
+    node->attrs.attr_store = attrs;
+    for (auto* input : inputs) {
+      input->LinkTo(node);
+    }
+    std::shared_ptr<Node> node_ptr(node);
+    auto* output = new NodeData(node_ptr, 0, 0, common::UniqName(node->id() + "_out"));
+    node->LinkTo(output);
+    graph_->RegisterNode(node->id(), node);
+    graph_->RegisterNode(output->id(), output);
+    InferShapeAndType(node);
+    return output;
+  }
+
+  // Get the conv2d producing the var if its weight can absorb a per output channel affine transform.
+  Node* GetFoldableConv(NodeData* var) {
+    auto* conv = ProducerOf(var);
+    if (!conv || !HasSingleUse(var)) return nullptr;
+    if (conv->op()->name != "conv2d" && conv->op()->name != "depthwise_conv2d") return nullptr;
+    if (GetAttr<std::string>(conv, "data_format", "NCHW") != "NCHW") return nullptr;
+    if (GetAttr<std::string>(conv, "conv_type", "forward") != "forward") return nullptr;
+    if (var != OutputOf(conv)) return nullptr;
+    auto* weight = InputOf(conv, 1);
+    if (!IsConstant(weight) || shape_dict_.at(weight->id()).size() != 4) return nullptr;
+    return conv;
+  }
+
+  /**
+   * conv2d(x, w) -> batchnorm(scale, bias, mean, variance) is rewritten to conv2d(x, w * alpha) + beta, where
+   * alpha = scale / sqrt(variance + epsilon) and beta = bias - mean * alpha are computed from parameters only.
+   */
+  bool FoldBatchNorm(Node* bn) {
+    if (bn->inlinks().size() != 5 || bn->outlinks().size() != 1) return false;
+    auto* conv_out = InputOf(bn, 0);
+    auto* conv     = GetFoldableConv(conv_out);
+    if (!conv) return false;
+    auto* weight       = InputOf(conv, 1);
+    int out_channels   = shape_dict_.at(weight->id())[0];
+    NodeData* scale    = InputOf(bn, 1);
+    NodeData* bias     = InputOf(bn, 2);
+    NodeData* mean     = InputOf(bn, 3);
+    NodeData* variance = InputOf(bn, 4);
+    for (auto* param : {scale, bias, mean, variance}) {
+      if (!IsConstant(param) || shape_dict_.at(param->id()) != framework::shape_t{out_channels}) return false;
+    }
+    float epsilon = GetAttr<float>(bn, "epsilon", 0.00001f);
+    VLOG(3) << "fold " << bn->id() << " into " << conv->id();
+
+    auto* std_var    = AddOpNode("sqrt", {AddOpNode("scale", {variance}, {{"bias", epsilon}})}, {});
+    auto* alpha      = AddOpNode("divide", {scale, std_var}, {});
+    auto* new_weight = AddOpNode("elementwise_mul", {weight, alpha}, {{"axis", 0}});
+    auto* beta       = AddOpNode("substract", {bias, AddOpNode("elementwise_mul", {mean, alpha}, {})}, {});
+    ReplaceInput(conv, weight, new_weight);
+    InferShapeAndType(conv);
+
+    // rewrite the batchnorm in place to a bias add, so its output var is kept.
+    bn->attrs.op         = Operator::Get("elementwise_add");
+    bn->attrs.node_name  = "elementwise_add";
+    bn->attrs.attr_store = {{"axis", 1}};
+    ResetInputs(bn, {conv_out, beta});
+    InferShapeAndType(bn);
+    return true;
+  }
+
+  /**
+   * conv2d(x, w) -> scale(s, b) is rewritten to conv2d(x, w * s) -> scale(1, b'), the latter is removed as an
+   * identity when b' is zero.
+   */
+  bool FoldScale(Node* node) {
+    if (node->inlinks().size() != 1) return false;
+    auto* conv_out = InputOf(node, 0);
+    auto* conv     = GetFoldableConv(conv_out);
+    if (!conv) return false;
+    float scale = GetAttr<float>(node, "scale", 1.f);
+    float bias  = GetAttr<float>(node, "bias", 0.f);
+    if (scale == 1.f) return false;
+    if (!GetAttr<bool>(node, "bias_after_scale", true)) bias *= scale;
+    VLOG(3) << "fold " << node->id() << " into " << conv->id();
+
+    auto* weight     = InputOf(conv, 1);
+    auto* new_weight = AddOpNode("scale", {weight}, {{"scale", scale}});
+    ReplaceInput(conv, weight, new_weight);
+    InferShapeAndType(conv);
+
+    node->attrs.attr_store = {{"scale", 1.f}, {"bias", bias}, {"bias_after_scale", true}};
+    return true;
+  }
+
+  bool IsIdentity(Node* node) {
+    if (node->inlinks().size() != 1 || node->outlinks().size() != 1) return false;
+    auto& op_name = node->op()->name;
+    if (op_name == "identity") return true;
+    if (op_name == "scale") {
+      return GetAttr<float>(node, "scale", 1.f) == 1.f && GetAttr<float>(node, "bias", 0.f) == 0.f;
+    }
+    if (op_name == "reshape") {
+      return shape_dict_.at(InputOf(node, 0)->id()) == shape_dict_.at(OutputOf(node)->id());
+    }
+    if (op_name == "transpose") {
+      auto axis = GetAttr<std::vector<int>>(node, "axis", {});
+      for (int i = 0; i < axis.size(); i++) {
+        if (axis[i] != i) return false;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  // Let the consumers of the node's output read its input directly, the final and the fetched outputs are kept.
+  bool RemoveIdentity(Node* node) {
+    auto* input  = InputOf(node, 0);
+    auto* output = OutputOf(node);
+    if (output->outlinks().empty() || IsFetched(output)) return false;
+    VLOG(3) << "remove identity " << node->id();
+    std::vector<Node*> consumers;
+    for (auto& link : output->outlinks()) {
+      consumers.push_back(link->sink()->safe_as<Node>());
+    }
+    for (auto* consumer : consumers) {
+      ReplaceInput(consumer, output, input);
+    }
+    input->UnLinkTo(node);
+    node->UnLinkTo(output);
+    return true;
+  }
+
+  // transpose(transpose(x, axis0), axis1) = transpose(x, axis0[axis1])
+  bool MergeTranspose(Node* node) {
+    auto* input    = InputOf(node, 0);
+    auto* producer = ProducerOf(input);
+    if (!producer || producer->op()->name != "transpose" || !HasSingleUse(input)) return false;
+    auto axis0 = GetAttr<std::vector<int>>(producer, "axis", {});
+    auto axis1 = GetAttr<std::vector<int>>(node, "axis", {});
+    if (axis0.size() != axis1.size()) return false;
+    std::vector<int> axis;
+    for (int i : axis1) axis.push_back(axis0[i]);
+    VLOG(3) << "merge " << producer->id() << " into " << node->id();
+    node->attrs.attr_store["axis"] = axis;
+    RemoveProducer(node, producer);
+    if (IsIdentity(node)) RemoveIdentity(node);
+    return true;
+  }
+
+  // reshape(reshape(x, shape0), shape1) = reshape(x, shape1)
+  bool MergeReshape(Node* node) {
+    auto* input    = InputOf(node, 0);
+    auto* producer = ProducerOf(input);
+    if (!producer || producer->op()->name != "reshape" || !HasSingleUse(input)) return false;
+    VLOG(3) << "merge " << producer->id() << " into " << node->id();
+    RemoveProducer(node, producer);
+    if (IsIdentity(node)) RemoveIdentity(node);
+    return true;
+  }
+
+  // Let the node read the input of its single input producer, and drop the producer.
+  void RemoveProducer(Node* node, Node* producer) {
+    auto* input      = InputOf(node, 0);
+    auto* prev_input = InputOf(producer, 0);
+    ReplaceInput(node, input, prev_input);
+    prev_input->UnLinkTo(producer);
+    producer->UnLinkTo(input);
+  }
+
+  Graph* graph_;
+  absl::flat_hash_map<std::string, framework::shape_t>& shape_dict_;
+  absl::flat_hash_map<std::string, Type>& dtype_dict_;
+  const framework::OpValueType<InferShapeFunc>& op_infershape_;
+  const framework::OpValueType<InferTypeFunc>& op_inferdtype_;
+  std::unordered_set<std::string> constants_;
+  std::unordered_set<std::string> fetches_;
+};
+
+void ConstantFoldingPass(Graph* graph) { ConstantFolder(graph)(); }
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(ConstantFolding) {
+  CINN_REGISTER_PASS(ConstantFolding)
+      .describe(
+          "This pass folds batchnorm and scale into the weights of the preceding conv2d, removes identity ops and "
+          "marks the ops computed only from parameters as pre_run.")
+      .set_change_structure(true)
+      .depend_graph_attr("infershape")
+      .depend_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::ConstantFoldingPass);
+  return true;
+}
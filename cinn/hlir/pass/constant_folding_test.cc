@@ -0,0 +1,232 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace frontend {
+
+using hlir::framework::Graph;
+using hlir::framework::Scope;
+
+// Fill the tensor with deterministic positive data, so the graphs compiled separately read the same values.
+void SetFixedData(const hlir::framework::Tensor& tensor, Target target, int seed) {
+  auto* data = tensor->mutable_data<float>(target);
+  for (size_t j = 0; j < tensor->shape().numel(); j++) {
+    data[j] = 0.1f + ((j * 7 + seed * 13) % 17) / 17.f;
+  }
+}
+
+int CountOps(const Graph& graph, const std::string& op_name) {
+  int num = 0;
+  for (auto* graph_node : graph.nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == op_name) num++;
+  }
+  return num;
+}
+
+std::vector<float> RunGraph(const Program& program,
+                            const std::string& output,
+                            bool fold,
+                            const std::unordered_set<std::string>& fetch_ids = {}) {
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(program, fetch_ids, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  if (fold) {
+    hlir::framework::ApplyPass(graph.get(), "ConstantFolding");
+    // the batchnorm reading a fetched conv output is kept
+    if (fetch_ids.empty()) EXPECT_EQ(CountOps(*graph, "batchnorm"), 0);
+  }
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  auto scope = BuildScope(target, graph);
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  int seed = 0;
+  for (auto& name : {"A", "W", "Scale", "Bias", "Mean", "Variance"}) {
+    if (scope->FindVar(name)) SetFixedData(scope->GetTensor(name), target, seed);
+    seed++;
+  }
+  runtime_program->PreRun();
+  runtime_program->Execute();
+
+  auto out = scope->GetTensor(output);
+  auto* data = out->data<float>();
+  return std::vector<float>(data, data + out->shape().numel());
+}
+
+TEST(ConstantFolding, conv_batchnorm) {
+  Placeholder A(Float(32), {1, 3, 16, 16}, "A");
+  Placeholder W(Float(32), {8, 3, 3, 3}, "W");
+  Placeholder Scale(Float(32), {8}, "Scale");
+  Placeholder Bias(Float(32), {8}, "Bias");
+  Placeholder Mean(Float(32), {8}, "Mean");
+  Placeholder Variance(Float(32), {8}, "Variance");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({1, 1});
+  attrs["data_format"] = std::string("NCHW");
+  auto c               = program.conv2d(A, W, attrs);
+
+  absl::flat_hash_map<std::string, Program::attr_t> bn_attrs;
+  bn_attrs["epsilon"] = 0.00001f;
+  auto d              = program.batchnorm(c, Scale, Bias, Mean, Variance, bn_attrs);
+  auto e              = program.relu(d);
+
+  // only A is fed by the user, the others are parameters
+  program.SetInputs({A});
+  program.Validate();
+  LOG(INFO) << "Program:\n" << program;
+
+  auto expected = RunGraph(program, e->id, false);
+  auto actual   = RunGraph(program, e->id, true);
+  ASSERT_EQ(expected.size(), actual.size());
+  for (int i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(expected[i], actual[i], 1e-4);
+  }
+}
+
+TEST(ConstantFolding, fetched_conv_output) {
+  Placeholder A(Float(32), {1, 3, 16, 16}, "A");
+  Placeholder W(Float(32), {8, 3, 3, 3}, "W");
+  Placeholder Scale(Float(32), {8}, "Scale");
+  Placeholder Bias(Float(32), {8}, "Bias");
+  Placeholder Mean(Float(32), {8}, "Mean");
+  Placeholder Variance(Float(32), {8}, "Variance");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({1, 1});
+  attrs["data_format"] = std::string("NCHW");
+  auto c               = program.conv2d(A, W, attrs);
+  auto d               = program.batchnorm(c, Scale, Bias, Mean, Variance, {{"epsilon", 0.00001f}});
+  auto e               = program.conv2d(A, W, attrs);
+  auto f               = program.scale(e, {{"scale", 2.f}});
+  program.SetInputs({A});
+  program.Validate();
+
+  // the outputs of both convs are fetched, so their weights are not rewritten
+  std::unordered_set<std::string> fetch_ids{c->id, d->id, e->id, f->id};
+  Target target = common::DefaultHostTarget();
+  Graph graph(program, fetch_ids, target);
+  hlir::framework::ApplyPass(&graph, "InferShape");
+  hlir::framework::ApplyPass(&graph, "ConstantFolding");
+  ASSERT_EQ(CountOps(graph, "batchnorm"), 1);
+  ASSERT_EQ(CountOps(graph, "elementwise_mul"), 0);
+
+  // the final outputs are still computed the same, OpFusion might not write the fetched intermediates
+  for (auto& output : {d->id, f->id}) {
+    auto expected = RunGraph(program, output, false, fetch_ids);
+    auto actual   = RunGraph(program, output, true, fetch_ids);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (int i = 0; i < expected.size(); i++) {
+      ASSERT_NEAR(expected[i], actual[i], 1e-4) << output << " differs at " << i;
+    }
+  }
+}
+
+TEST(ConstantFolding, fetched_reshape) {
+  Placeholder A(Float(32), {4, 6}, "A");
+
+  Program program;
+  auto b = program.reshape(A, {2, 12});
+  auto c = program.reshape(b, {24});
+  auto d = program.scale(c, {{"scale", 1.f}, {"bias", 0.f}});
+  auto e = program.relu(d);
+  program.SetInputs({A});
+  program.Validate();
+
+  // the intermediate reshape and the identity scale are kept as their outputs are fetched
+  std::unordered_set<std::string> fetch_ids{b->id, d->id, e->id};
+  Target target = common::DefaultHostTarget();
+  Graph graph(program, fetch_ids, target);
+  hlir::framework::ApplyPass(&graph, "InferShape");
+  hlir::framework::ApplyPass(&graph, "ConstantFolding");
+  ASSERT_EQ(CountOps(graph, "reshape"), 2);
+  ASSERT_EQ(CountOps(graph, "scale"), 1);
+
+  auto expected = RunGraph(program, e->id, false, fetch_ids);
+  auto actual   = RunGraph(program, e->id, true, fetch_ids);
+  ASSERT_EQ(expected.size(), actual.size());
+  for (int i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(expected[i], actual[i], 1e-5) << "differs at " << i;
+  }
+}
+
+TEST(ConstantFolding, conv_batchnorm_winograd) {
+  Placeholder A(Float(32), {1, 8, 16, 16}, "A");
+  Placeholder W(Float(32), {8, 8, 3, 3}, "W");
+  Placeholder Scale(Float(32), {8}, "Scale");
+  Placeholder Bias(Float(32), {8}, "Bias");
+  Placeholder Mean(Float(32), {8}, "Mean");
+  Placeholder Variance(Float(32), {8}, "Variance");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({1, 1});
+  attrs["data_format"] = std::string("NCHW");
+  attrs["algorithm"]   = std::string("winograd");
+  attrs["tile_size"]   = 2;
+  auto c               = program.conv2d(A, W, attrs);
+
+  absl::flat_hash_map<std::string, Program::attr_t> bn_attrs;
+  bn_attrs["epsilon"] = 0.00001f;
+  auto d              = program.batchnorm(c, Scale, Bias, Mean, Variance, bn_attrs);
+  program.SetInputs({A});
+  program.Validate();
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "ConstantFolding");
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+
+  // the weights folded with the batchnorm are computed by pre_run ops, so is their winograd transform
+  int num_transforms = 0;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (!node || node->op()->name != "conv2d_winograd_weight_transform") continue;
+    num_transforms++;
+    ASSERT_TRUE(node->attrs.attr_store.count("pre_run"));
+    ASSERT_TRUE(absl::get<bool>(node->attrs.attr_store.at("pre_run")));
+  }
+  ASSERT_EQ(num_transforms, 1);
+}
+
+}  // namespace frontend
+}  // namespace cinn
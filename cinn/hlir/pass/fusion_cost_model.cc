@@ -0,0 +1,217 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/pass/fusion_cost_model.h"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+#include "cinn/hlir/framework/op.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Node;
+using framework::NodeData;
+using framework::Operator;
+using framework::OpPatternKind;
+
+namespace {
+
+// Only float32 and bool tensors are compiled by the GraphCompiler now, take the larger one.
+constexpr double kBytesPerElement = 4.;
+// The cost of one transcendental function relative to an add.
+constexpr double kTranscendentalFlops = 8.;
+
+const std::unordered_set<std::string>& TranscendentalOps() {
+  static std::unordered_set<std::string> ops = {"exp",  "erf",   "sqrt", "log",   "tanh",  "log2",    "log10",
+                                                "cos",  "cosh",  "tan",  "sin",   "sinh",  "acos",    "acosh",
+                                                "asin", "asinh", "atan", "atanh", "rsqrt", "sigmoid", "power"};
+  return ops;
+}
+
+double Numel(const framework::shape_t& shape) {
+  double res = 1.;
+  for (auto i : shape) res *= i;
+  return res;
+}
+
+OpPatternKind GetPattern(const Node* node) {
+  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  return op_pattern_dict[node->op()];
+}
+
+const framework::shape_t& GetShape(const std::string& id, const ShapeDict& shape_dict) {
+  CHECK(shape_dict.count(id)) << "Cannot find the shape of " << id;
+  return shape_dict.at(id);
+}
+
+double OutputNumel(const Node* node, const ShapeDict& shape_dict) {
+  auto& outlinks = node->outlinks_in_order();
+  CHECK(!outlinks.empty());
+  return Numel(GetShape(outlinks.front()->sink()->id(), shape_dict));
+}
+
+// The number of multiply-adds to compute one output element of a complex op like conv2d or mulbias.
+double ReductionExtent(const Node* node, const ShapeDict& shape_dict) {
+  auto& inlinks = node->inlinks_in_order();
+  if (inlinks.size() < 2) return 1.;
+  auto& weight = GetShape(inlinks[1]->source()->id(), shape_dict);
+  if (weight.empty()) return 1.;
+  const std::string& op_name = node->op()->name;
+  if (op_name == "conv2d" || op_name == "depthwise_conv2d" || op_name == "conv2d_NCHWc") {
+    // OIHW weight or the OIHWio weight of conv2d_NCHWc
+    double out_channels = weight.size() == 6 ? weight[0] * weight[5] : weight[0];
+    return std::max(1., Numel(weight) / out_channels);
+  }
+  auto& x = GetShape(inlinks[0]->source()->id(), shape_dict);
+  return x.empty() ? 1. : std::max(1, x.back());
+}
+
+// The FLOPs to compute one element of the first output of \p node.
+double FlopsPerElement(const Node* node, const ShapeDict& shape_dict) {
+  switch (GetPattern(node)) {
+    case framework::kElemWise:
+    case framework::kBroadcast:
+      return TranscendentalOps().count(node->op()->name) ? kTranscendentalFlops : 1.;
+    case framework::kInjective:
+      return 0.;
+    case framework::kOutEWiseFusable:
+      return 2. * ReductionExtent(node, shape_dict);
+    default:
+      return 1.;
+  }
+}
+
+// The number of times \p consumer reads the elements of its input \p var.
+double ReadsOf(const NodeData* var, const Node* consumer, const ShapeDict& shape_dict) {
+  switch (GetPattern(consumer)) {
+    case framework::kElemWise:
+    case framework::kBroadcast:
+    case framework::kInjective:
+      return OutputNumel(consumer, shape_dict);
+    case framework::kOutEWiseFusable:
+      return OutputNumel(consumer, shape_dict) * ReductionExtent(consumer, shape_dict);
+    default:
+      return Numel(GetShape(var->id(), shape_dict));
+  }
+}
+
+std::string PairKey(const std::string& producer, const std::string& consumer) { return producer + "->" + consumer; }
+
+}  // namespace
+
+std::string FusionCost::DebugString() const {
+  std::stringstream ss;
+  ss << "bytes_saved: " << bytes_saved << ", recompute_flops: " << recompute_flops
+     << ", schedule_penalty: " << schedule_penalty << ", schedule_compatible: " << schedule_compatible;
+  if (decision == FusionDecision::kAlways) ss << ", overridden: always";
+  if (decision == FusionDecision::kNever) ss << ", overridden: never";
+  return ss.str();
+}
+
+FusionCostModel& FusionCostModel::Global() {
+  static FusionCostModel x;
+  return x;
+}
+
+void FusionCostModel::SetOverride(const std::string& producer, const std::string& consumer, FusionDecision decision) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (decision == FusionDecision::kDefault) {
+    overrides_.erase(PairKey(producer, consumer));
+  } else {
+    overrides_[PairKey(producer, consumer)] = decision;
+  }
+}
+
+void FusionCostModel::ClearOverrides() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  overrides_.clear();
+}
+
+FusionDecision FusionCostModel::GetOverride(const std::string& producer, const std::string& consumer) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (overrides_.empty()) return FusionDecision::kDefault;
+  for (auto& key : {PairKey(producer, consumer), PairKey(producer, "*"), PairKey("*", consumer), PairKey("*", "*")}) {
+    auto it = overrides_.find(key);
+    if (it != overrides_.end()) return it->second;
+  }
+  return FusionDecision::kDefault;
+}
+
+FusionCost FusionCostModel::Evaluate(const std::vector<NodeData*>& vars, const ShapeDict& shape_dict) const {
+  FusionCost cost;
+  for (auto* var : vars) {
+    CHECK(var);
+    if (var->inlinks().empty()) continue;
+    auto* producer = (*var->inlinks().begin())->source()->safe_as<Node>();
+    CHECK(producer);
+    double numel          = Numel(GetShape(var->id(), shape_dict));
+    auto producer_pattern = GetPattern(producer);
+    double producer_flops = FlopsPerElement(producer, shape_dict);
+    double total_reads    = 0.;
+    int num_consumers     = 0;
+    for (auto& link : var->outlinks()) {
+      auto* consumer = link->sink()->safe_as<Node>();
+      CHECK(consumer);
+      num_consumers++;
+      total_reads += ReadsOf(var, consumer, shape_dict);
+
+      auto decision = GetOverride(producer->op()->name, consumer->op()->name);
+      if (decision == FusionDecision::kNever) {
+        cost.decision = FusionDecision::kNever;
+      } else if (decision == FusionDecision::kAlways && cost.decision == FusionDecision::kDefault) {
+        cost.decision = FusionDecision::kAlways;
+      }
+
+      // The final output of a fused group copies the schedule of the master op, which only fits the loop nest of
+      // the master's output.
+      if (producer_pattern == framework::kOutEWiseFusable && OutputNumel(consumer, shape_dict) != numel) {
+        cost.schedule_compatible = false;
+        cost.schedule_penalty += schedule_mismatch_ratio_ * producer_flops * numel;
+      }
+    }
+    // the var is neither written nor read back from memory.
+    cost.bytes_saved += numel * kBytesPerElement * (1 + num_consumers);
+    // the master op and reductions are materialized in the fused function, others are computed inline.
+    if (producer_pattern <= framework::kInjective) {
+      cost.recompute_flops += producer_flops * std::max(0., total_reads - numel);
+    }
+  }
+  return cost;
+}
+
+bool FusionCostModel::ShouldFuse(const std::vector<NodeData*>& vars, const ShapeDict& shape_dict) const {
+  auto cost = Evaluate(vars, shape_dict);
+  bool res  = false;
+  if (cost.decision != FusionDecision::kDefault) {
+    res = cost.decision == FusionDecision::kAlways;
+  } else {
+    res = cost.bytes_saved * flops_per_byte_ >= cost.recompute_flops + cost.schedule_penalty;
+  }
+  if (VLOG_IS_ON(2)) {
+    std::vector<std::string> names;
+    for (auto* var : vars) names.push_back(var->id());
+    VLOG(2) << (res ? "fuse" : "not fuse") << " through vars [" << utils::Join(names, ", ")
+            << "], cost: " << cost.DebugString();
+  }
+  return res;
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
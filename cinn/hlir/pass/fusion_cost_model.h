@@ -0,0 +1,122 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <absl/container/flat_hash_map.h>
+
+#include <mutex>  //NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using ShapeDict = absl::flat_hash_map<std::string, framework::shape_t>;
+
+/**
+ * \brief The user override of the fusion decision between a producer op and a consumer op.
+ */
+enum class FusionDecision {
+  // Let the cost model decide.
+  kDefault = 0,
+  // Always fuse the pair as long as the pattern rules of OpFusion allow it.
+  kAlways,
+  // Never fuse the pair.
+  kNever
+};
+
+/**
+ * \brief The estimated cost of eliminating some intermediate variables by fusing their producers into consumers.
+ * All the members are measured in FLOPs, the bytes are converted by the machine balance of the cost model.
+ */
+struct FusionCost {
+  //! the memory traffic saved by not materializing the intermediate variables.
+  double bytes_saved{0};
+  //! the extra computation of the inlined producers which are evaluated more than once by their consumers.
+  double recompute_flops{0};
+  //! the estimated slowdown of the master op whose schedule is forced onto a mismatched loop nest.
+  double schedule_penalty{0};
+  //! whether the fused loop nest is compatible with the schedule of the master op.
+  bool schedule_compatible{true};
+  FusionDecision decision{FusionDecision::kDefault};
+
+  std::string DebugString() const;
+};
+
+/**
+ * \brief An analytical cost model used by the OpFusion pass to decide whether a legal fusion is profitable.
+ *
+ * A fusion step of OpFusion eliminates a set of intermediate variables. For each of them the model compares the
+ * bytes no longer written and read back against the FLOPs recomputed because the producer is inlined into consumers
+ * reading each element more than once (e.g. a broadcast or the input of a conv), and it penalizes the steps that
+ * force the schedule of a complex op (conv2d, matmul) onto an incompatible loop nest.
+ *
+ * The decision can be overridden for a (producer op, consumer op) pair, "*" matches any op.
+ */
+class FusionCostModel {
+ public:
+  static FusionCostModel& Global();
+
+  /**
+   * \brief Evaluate the fusion step that eliminates the intermediate variables \p vars.
+   * @param vars The variables which will be computed inline after fusion.
+   * @param shape_dict The shapes inferred by the InferShape pass.
+   * @return The estimated cost.
+   */
+  FusionCost Evaluate(const std::vector<framework::NodeData*>& vars, const ShapeDict& shape_dict) const;
+
+  /**
+   * \brief Decide whether the fusion step that eliminates \p vars should be applied, and log the decision.
+   */
+  bool ShouldFuse(const std::vector<framework::NodeData*>& vars, const ShapeDict& shape_dict) const;
+
+  /**
+   * \brief Override the decision of fusing \p producer into \p consumer.
+   * @param producer The name of the producer op or "*".
+   * @param consumer The name of the consumer op or "*".
+   * @param decision The decision, kDefault removes the override.
+   */
+  void SetOverride(const std::string& producer, const std::string& consumer, FusionDecision decision);
+
+  void ClearOverrides();
+
+  FusionDecision GetOverride(const std::string& producer, const std::string& consumer) const;
+
+  //! The FLOPs the target can execute in the time of loading one byte from memory.
+  void set_flops_per_byte(double x) { flops_per_byte_ = x; }
+  double flops_per_byte() const { return flops_per_byte_; }
+
+  //! The fraction of the master op's FLOPs lost when its schedule is copied onto a mismatched loop nest.
+  void set_schedule_mismatch_ratio(double x) { schedule_mismatch_ratio_ = x; }
+  double schedule_mismatch_ratio() const { return schedule_mismatch_ratio_; }
+
+ private:
+  FusionCostModel() = default;
+
+  mutable std::mutex mutex_;
+  absl::flat_hash_map<std::string, FusionDecision> overrides_;
+  double flops_per_byte_{8.};
+  double schedule_mismatch_ratio_{0.5};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(FusionCostModel);
+};
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
@@ -19,6 +19,7 @@
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
 #include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/fusion_cost_model.h"
 #include "cinn/hlir/pass/use_pass.h"
 #include "cinn/utils/string.h"
 
@@ -35,7 +36,6 @@ using framework::Operator;
 using framework::OpPatternKind;
 
 auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
-absl::flat_hash_map<std::string, framework::shape_t> shape_dict;
 
 struct DomNode {
   GraphNode* ref_node{nullptr};
@@ -214,6 +214,8 @@ struct GroupNode {
 };
 class GraphPartition {
  public:
+  explicit GraphPartition(const ShapeDict& shape_dict) : shape_dict_(shape_dict) {}
+
   std::vector<std::vector<Node*>> Partition(const std::vector<GraphNode*>& graph_nodes,
                                             const std::vector<DomNode*>& dom_nodes) {
     CHECK_EQ(graph_nodes.size(), dom_nodes.size());
@@ -227,6 +229,8 @@ class GraphPartition {
   }
 
  private:
+  //! The shapes inferred by the InferShape pass of the graph partitioned.
+  const ShapeDict& shape_dict_;
   std::vector<GroupNode*> group_nodes_;
   std::vector<std::vector<Node*>> groups_;
   std::unordered_set<GraphNode*> visited_nodes_;
@@ -245,6 +249,10 @@ class GraphPartition {
         if (pattern == framework::kOutEWiseFusable) {
           group_node->master_node = graph_node;
         }
+        // the ops computed only from parameters are executed once by Program::PreRun, keep them unfused.
+        if (op_node->attrs.attr_store.count("pre_run") && absl::get<bool>(op_node->attrs.attr_store.at("pre_run"))) {
+          group_node->pattern = framework::kOpaque;
+        }
       } else {
         // var nodes
         if (graph_node->inlinks().empty()) {
@@ -271,11 +279,11 @@ class GraphPartition {
       // first out var shape
       CHECK(!op_node->outlinks_in_order().empty());
       auto out_var = op_node->outlinks_in_order().front()->sink();
-      CHECK(shape_dict.count(out_var->id()));
-      out_shapes = shape_dict[out_var->id()];
+      CHECK(shape_dict_.count(out_var->id()));
+      out_shapes = shape_dict_.at(out_var->id());
     } else {
-      CHECK(shape_dict.count(node->id()));
-      out_shapes = shape_dict[node->id()];
+      CHECK(shape_dict_.count(node->id()));
+      out_shapes = shape_dict_.at(node->id());
     }
     return out_shapes;
   }
@@ -350,6 +358,30 @@ class GraphPartition {
     }
     return true;
   }
+  // collect the vars between source and sink which will be computed inline after fusion.
+  void CollectFusedVars(GraphNode* source, GraphNode* sink, std::vector<NodeData*>* vars) {
+    if (source == sink) return;
+    if (visited_nodes_.count(source)) return;
+    visited_nodes_.insert(source);
+    auto op_node = source->safe_as<Node>();
+    if (op_node) {
+      // only the first out var of the op node links to other op nodes
+      auto& outlinks = op_node->outlinks_in_order(true);
+      if (!outlinks.empty()) CollectFusedVars(outlinks[0]->sink(), sink, vars);
+    } else {
+      vars->push_back(source->safe_as<NodeData>());
+      for (auto link : source->outlinks()) {
+        CollectFusedVars(link->sink(), sink, vars);
+      }
+    }
+  }
+  // check the fusion between source and sink is profitable according to the cost model.
+  bool VerifyCost(GraphNode* source, GraphNode* sink) {
+    visited_nodes_.clear();
+    std::vector<NodeData*> vars;
+    CollectFusedVars(source, sink, &vars);
+    return FusionCostModel::Global().ShouldFuse(vars, shape_dict_);
+  }
   void MergeNodes(GroupNode* child, GroupNode* parent) {
     child  = child->GetRootNode();
     parent = parent->GetRootNode();
@@ -422,7 +454,7 @@ class GraphPartition {
         if (dom_node->pattern <= framework::kBroadcast) {
           auto fn       = [](OpPatternKind pattern, bool is_sink) { return pattern <= framework::kBroadcast; };
           auto lca_node = dom_node->parent->ref_node;
-          if (VerifyFuse(graph_node, lca_node, fn)) {
+          if (VerifyFuse(graph_node, lca_node, fn) && VerifyCost(graph_node, lca_node)) {
             VLOG(2) << "fuse between " << graph_node->id() << " and " << lca_node->id();
             DoFuse(graph_node, lca_node);
           }
@@ -437,7 +469,7 @@ class GraphPartition {
             }
           };
           auto lca_node = dom_node->parent->ref_node;
-          if (VerifyFuse(graph_node, lca_node, fn)) {
+          if (VerifyFuse(graph_node, lca_node, fn) && VerifyCost(graph_node, lca_node)) {
             VLOG(2) << "fuse between " << graph_node->id() << " and " << lca_node->id();
             DoFuse(graph_node, lca_node);
           }
@@ -474,14 +506,14 @@ class GraphPartition {
 };
 
 void OpFusionPass(Graph* graph) {
-  shape_dict       = graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
-  auto store_nodes = std::get<0>(graph->topological_order());
-  int node_size    = store_nodes.size();
+  auto& shape_dict = graph->GetAttrs<ShapeDict>("infershape");
+  auto store_nodes  = std::get<0>(graph->topological_order());
+  int node_size     = store_nodes.size();
   // construct postdom tree, reverse topological_order
   DomTree tree;
   auto& dom_nodes = tree.CreatePostDomTree(store_nodes);
   // graph partition
-  GraphPartition partition;
+  GraphPartition partition(shape_dict);
   graph->groups = partition.Partition(store_nodes, dom_nodes);
 }
 
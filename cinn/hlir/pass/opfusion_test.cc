@@ -22,6 +22,7 @@
 #include "cinn/hlir/framework/graph_compiler.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/fusion_cost_model.h"
 #include "cinn/hlir/pass/use_pass.h"
 
 DEFINE_string(model_dir, "", "");
@@ -423,5 +424,131 @@ TEST(conv_add_mul, conv_add_mul) {
   runtime_program->Execute();
 }
 
+// the fusion of add+relu is disabled by overriding the cost model
+TEST(fusion_cost_model, override) {
+  Placeholder A(Float(32), {1, 64, 112, 112}, "A");
+  Placeholder B(Float(32), {64}, "B");
+
+  Program program;
+  auto c = program.elementwise_add(A, B, 1);
+  auto d = program.relu(c);
+
+  Target target = GetTarget();
+  program.SetInputs({A, B});
+  program.Validate();
+
+  auto& cost_model = hlir::pass::FusionCostModel::Global();
+  cost_model.SetOverride("elementwise_add", "relu", hlir::pass::FusionDecision::kNever);
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  ASSERT_EQ(graph->groups.size(), 2UL);
+
+  cost_model.ClearOverrides();
+  auto graph1 = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph1.get(), "InferShape");
+  hlir::framework::ApplyPass(graph1.get(), "OpFusion");
+  ASSERT_EQ(graph1->groups.size(), 1UL);
+}
+
+// conv2d is a master op unless it is computed by cudnn
+#ifndef CINN_WITH_CUDNN
+using ShapeDict = absl::flat_hash_map<std::string, hlir::framework::shape_t>;
+
+absl::flat_hash_map<std::string, Program::attr_t> Conv2dAttrs() {
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({1, 1});
+  attrs["data_format"] = std::string("NCHW");
+  attrs["algorithm"]   = std::string("direct");
+  return attrs;
+}
+
+hlir::framework::NodeData* GetNodeData(const hlir::framework::Graph& graph, const std::string& id) {
+  auto* node = graph.RetrieveNode(id);
+  CHECK(node) << "Cannot find " << id;
+  return node->safe_as<hlir::framework::NodeData>();
+}
+
+// a broadcast add inlined into a conv is recomputed for each multiply-add of the conv, it is not worth the bytes saved
+TEST(fusion_cost_model, broadcast_into_conv) {
+  Placeholder A(Float(32), {1, 16, 28, 28}, "A");
+  Placeholder B(Float(32), {16}, "B");
+  Placeholder W(Float(32), {32, 16, 3, 3}, "W");
+
+  Program program;
+  auto c = program.elementwise_add(A, B, 1);
+  auto d = program.conv2d(c, W, Conv2dAttrs());
+  auto e = program.relu(c);
+  program.SetInputs({A, B, W});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, GetTarget());
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  auto& shape_dict = graph->GetAttrs<ShapeDict>("infershape");
+
+  auto& cost_model = hlir::pass::FusionCostModel::Global();
+  cost_model.ClearOverrides();
+  auto cost = cost_model.Evaluate({GetNodeData(*graph, c->id)}, shape_dict);
+  // the conv reads each of its 1*32*28*28 outputs through 16*3*3 inputs, and relu reads c once
+  double numel = 1 * 16 * 28 * 28;
+  double reads = 1 * 32 * 28 * 28 * (16 * 3 * 3) + numel;
+  EXPECT_DOUBLE_EQ(cost.recompute_flops, reads - numel);
+  EXPECT_DOUBLE_EQ(cost.bytes_saved, numel * 4 * 3);
+  EXPECT_DOUBLE_EQ(cost.schedule_penalty, 0.);
+  EXPECT_FALSE(cost_model.ShouldFuse({GetNodeData(*graph, c->id)}, shape_dict));
+
+  // the same add only read by relu is fused
+  Program program1;
+  auto c1 = program1.elementwise_add(A, B, 1);
+  auto d1 = program1.relu(c1);
+  program1.SetInputs({A, B});
+  program1.Validate();
+  auto graph1 = std::make_shared<hlir::framework::Graph>(program1, GetTarget());
+  hlir::framework::ApplyPass(graph1.get(), "InferShape");
+  auto& shape_dict1 = graph1->GetAttrs<ShapeDict>("infershape");
+  auto cost1        = cost_model.Evaluate({GetNodeData(*graph1, c1->id)}, shape_dict1);
+  EXPECT_DOUBLE_EQ(cost1.recompute_flops, 0.);
+  EXPECT_TRUE(cost_model.ShouldFuse({GetNodeData(*graph1, c1->id)}, shape_dict1));
+}
+
+// the conv output broadcast to a larger tensor forces the schedule of the conv onto the loop nest of the larger one
+TEST(fusion_cost_model, schedule_penalty) {
+  Placeholder A(Float(32), {1, 16, 8, 8}, "A");
+  Placeholder W(Float(32), {8, 16, 3, 3}, "W");
+  Placeholder B(Float(32), {8}, "B");
+  Placeholder X(Float(32), {2, 1, 8, 8, 8}, "X");
+
+  Program program;
+  auto c = program.conv2d(A, W, Conv2dAttrs());
+  auto d = program.elementwise_add(c, B, 1);
+  auto e = program.elementwise_add(X, c, 1);
+  program.SetInputs({A, W, B, X});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, GetTarget());
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  auto& shape_dict = graph->GetAttrs<ShapeDict>("infershape");
+
+  auto& cost_model = hlir::pass::FusionCostModel::Global();
+  cost_model.ClearOverrides();
+  auto cost = cost_model.Evaluate({GetNodeData(*graph, c->id)}, shape_dict);
+  // only the add to X mismatches, the master op is not recomputed
+  double numel      = 1 * 8 * 8 * 8;
+  double conv_flops = 2. * (16 * 3 * 3) * numel;
+  EXPECT_FALSE(cost.schedule_compatible);
+  EXPECT_DOUBLE_EQ(cost.schedule_penalty, cost_model.schedule_mismatch_ratio() * conv_flops);
+  EXPECT_DOUBLE_EQ(cost.recompute_flops, 0.);
+
+  EXPECT_LT(cost.bytes_saved * cost_model.flops_per_byte(), cost.schedule_penalty);
+  EXPECT_FALSE(cost_model.ShouldFuse({GetNodeData(*graph, c->id)}, shape_dict));
+
+  // without the penalty the bytes saved win
+  double ratio = cost_model.schedule_mismatch_ratio();
+  cost_model.set_schedule_mismatch_ratio(0.);
+  EXPECT_TRUE(cost_model.ShouldFuse({GetNodeData(*graph, c->id)}, shape_dict));
+  cost_model.set_schedule_mismatch_ratio(ratio);
+}
+#endif
+
 }  // namespace frontend
 }  // namespace cinn
@@ -19,3 +19,4 @@
 CINN_USE_REGISTER(InferShape)
 CINN_USE_REGISTER(OpFusion)
 CINN_USE_REGISTER(AlterLayout)
+CINN_USE_REGISTER(ConstantFolding)
@@ -326,6 +326,315 @@ std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
   return {out, call};
 }
 
+namespace {
+// The transform matrices of the Winograd algorithm F(m x m, 3 x 3) with m = 2 or 4, see
+// "Fast Algorithms for Convolutional Neural Networks" by Lavin and Gray.
+const std::vector<std::vector<float>> &WinogradMatrix(const std::string &name, int tile_size) {
+  static const std::vector<std::vector<float>> kBT2 = {{1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+  static const std::vector<std::vector<float>> kG2  = {{1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+  static const std::vector<std::vector<float>> kAT2 = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+  static const std::vector<std::vector<float>> kBT4 = {{4, 0, -5, 0, 1, 0},
+                                                       {0, -4, -4, 1, 1, 0},
+                                                       {0, 4, -4, -1, 1, 0},
+                                                       {0, -2, -1, 2, 1, 0},
+                                                       {0, 2, -1, -2, 1, 0},
+                                                       {0, 4, 0, -5, 0, 1}};
+  static const std::vector<std::vector<float>> kG4  = {{1.f / 4, 0, 0},
+                                                      {-1.f / 6, -1.f / 6, -1.f / 6},
+                                                      {-1.f / 6, 1.f / 6, -1.f / 6},
+                                                      {1.f / 24, 1.f / 12, 1.f / 6},
+                                                      {1.f / 24, -1.f / 12, 1.f / 6},
+                                                      {0, 0, 1}};
+  static const std::vector<std::vector<float>> kAT4 = {
+      {1, 1, 1, 1, 1, 0}, {0, 1, -1, 2, -2, 0}, {0, 1, 1, 4, 4, 0}, {0, 1, -1, 8, -8, 1}};
+  CHECK(tile_size == 2 || tile_size == 4) << "Winograd conv2d only supports tile size 2 or 4, but got " << tile_size;
+  if (name == "BT") return tile_size == 2 ? kBT2 : kBT4;
+  if (name == "G") return tile_size == 2 ? kG2 : kG4;
+  CHECK_EQ(name, "AT") << "Unknown Winograd matrix " << name;
+  return tile_size == 2 ? kAT2 : kAT4;
+}
+
+// Build the element (i, j) of left * X * right^T for the constant matrices, with x(a, b) the element (a, b) of X. Each
+// element is unrolled into the sum of the terms with nonzero coefficients, selected by the indices (i, j) once.
+Expr ConstMatrixTransform(const std::vector<std::vector<float>> &left,
+                          const std::vector<std::vector<float>> &right,
+                          Expr i,
+                          Expr j,
+                          const std::function<Expr(int, int)> &x,
+                          const Type &type) {
+  Expr res;
+  for (int ii = left.size() - 1; ii >= 0; ii--) {
+    Expr row;
+    for (int jj = right.size() - 1; jj >= 0; jj--) {
+      Expr sum;
+      for (int a = 0; a < left[ii].size(); a++) {
+        for (int b = 0; b < right[jj].size(); b++) {
+          float coef = left[ii][a] * right[jj][b];
+          if (coef == 0.f) continue;
+          Expr value = x(a, b);
+          if (!sum.defined()) {
+            sum = coef == 1.f ? value : common::make_const(type, coef) * value;
+          } else if (coef == 1.f) {
+            sum = sum + value;
+          } else if (coef == -1.f) {
+            sum = sum - value;
+          } else {
+            sum = sum + common::make_const(type, coef) * value;
+          }
+        }
+      }
+      if (!sum.defined()) sum = ir::Zero(type);
+      row = row.defined() ? ir::Select::Make(ir::EQ::Make(j, Expr(jj)), sum, row) : sum;
+    }
+    res = res.defined() ? ir::Select::Make(ir::EQ::Make(i, Expr(ii)), row, res) : row;
+  }
+  return res;
+}
+
+// The number of the unrolled terms of the transform by the matrix \p name on both sides of a tile.
+int WinogradTransformTerms(const std::string &name, int tile_size) {
+  int nonzeros = 0;
+  for (auto &row : WinogradMatrix(name, tile_size)) {
+    for (float coef : row) nonzeros += coef != 0.f;
+  }
+  return nonzeros * nonzeros;
+}
+}  // namespace
+
+ir::Tensor Conv2d_Winograd_WeightTransform(const ir::Tensor &weights, int tile_size, const std::string &output_name) {
+  CHECK_EQ(weights->shape.size(), 4U) << "Weight's dimension of Winograd conv2d is not 4! Please check.";
+  CHECK(MathEqual(weights->shape[2], Expr(3)) && MathEqual(weights->shape[3], Expr(3)))
+      << "Winograd conv2d only supports 3x3 filters";
+  auto &g    = WinogradMatrix("G", tile_size);
+  int alpha  = tile_size + 2;
+  auto type  = weights->type();
+  // U[e, n, c, k] = sum_{a, b} G[e, a] * w[k, c, a, b] * G[n, b]
+  return Compute(
+      {Expr(alpha), Expr(alpha), weights->shape[1], weights->shape[0]},
+      [=](Expr e, Expr n, Expr c, Expr k) {
+        return ConstMatrixTransform(
+            g, g, e, n, [&](int a, int b) { return weights(k, c, Expr(a), Expr(b)); }, type);
+      },
+      output_name);
+}
+
+std::vector<ir::Tensor> Conv2d_NCHW_Winograd(const ir::Tensor &input,
+                                             const ir::Tensor &transformed_weights,
+                                             int pad_h,
+                                             int pad_w,
+                                             int tile_size,
+                                             const std::string &output_name) {
+  CHECK_EQ(input->shape.size(), 4U) << "Input's dimension of Winograd conv2d is not 4! Please check.";
+  CHECK_EQ(transformed_weights->shape.size(), 4U) << "Transformed weight's dimension of Winograd conv2d is not 4!";
+  auto &bt  = WinogradMatrix("BT", tile_size);
+  auto &at  = WinogradMatrix("AT", tile_size);
+  int m     = tile_size;
+  int alpha = m + 2;
+  CHECK(MathEqual(transformed_weights->shape[0], Expr(alpha)))
+      << "The weights are not transformed with tile size " << tile_size;
+  auto type    = input->type();
+  int batch    = input->shape[0].as_int32();
+  int h_in     = input->shape[2].as_int32();
+  int w_in     = input->shape[3].as_int32();
+  int out_h    = h_in + 2 * pad_h - 2;
+  int out_w    = w_in + 2 * pad_w - 2;
+  int tiles_h  = (out_h + m - 1) / m;
+  int tiles_w  = (out_w + m - 1) / m;
+  int tiles    = batch * tiles_h * tiles_w;
+  Expr c_in    = transformed_weights->shape[2];
+  Expr c_out   = transformed_weights->shape[3];
+  Expr e_tiles = Expr(tiles_h * tiles_w);
+
+  // transform the input tiles: V[e, n, c, p] = sum_{a, b} BT[e, a] * d[c, p, a, b] * BT[n, b]
+  auto input_tile = Compute(
+      {Expr(alpha), Expr(alpha), c_in, Expr(tiles)},
+      [=](Expr e, Expr n, Expr c, Expr p) {
+        Expr batch_idx = p / e_tiles;
+        Expr tile_y    = (p % e_tiles) / tiles_w * m - pad_h;
+        Expr tile_x    = p % tiles_w * m - pad_w;
+        auto d         = [&](int a, int b) {
+          Expr y    = tile_y + a;
+          Expr x    = tile_x + b;
+          auto cond = lang::logic_and({y >= 0, y < h_in, x >= 0, x < w_in});
+          return ir::Select::Make(cond, input(batch_idx, c, y, x), ir::Zero(type));
+        };
+        return ConstMatrixTransform(bt, bt, e, n, d, type);
+      },
+      UniqName("winograd_input_tile"));
+
+  // batched GEMM: M[e, n, k, p] = sum_c U[e, n, c, k] * V[e, n, c, p]
+  Var rc(c_in, UniqName("rc"));
+  auto batch_gemm = Compute(
+      {Expr(alpha), Expr(alpha), c_out, Expr(tiles)},
+      [=](Expr e, Expr n, Expr k, Expr p) {
+        return lang::ReduceSum(transformed_weights(e, n, rc, k) * input_tile(e, n, rc, p), {rc});
+      },
+      UniqName("winograd_batch_gemm"));
+
+  // inverse transform: Y[k, p, i, j] = sum_{a, b} AT[i, a] * M[a, b, k, p] * AT[j, b]
+  auto inverse = Compute(
+      {c_out, Expr(tiles), Expr(m), Expr(m)},
+      [=](Expr k, Expr p, Expr i, Expr j) {
+        return ConstMatrixTransform(
+            at, at, i, j, [&](int a, int b) { return batch_gemm(Expr(a), Expr(b), k, p); }, type);
+      },
+      UniqName("winograd_inverse"));
+
+  auto res = Compute(
+      {input->shape[0], c_out, Expr(out_h), Expr(out_w)},
+      [=](Expr b, Expr k, Expr h, Expr w) {
+        return inverse(k, b * e_tiles + h / m * tiles_w + w / m, h % m, w % m);
+      },
+      output_name);
+  return {res, inverse, batch_gemm, input_tile};
+}
+
+std::vector<ir::Tensor> Conv2d_NCHW_Im2col(const ir::Tensor &input,
+                                           const ir::Tensor &weights,
+                                           int pad_h,
+                                           int pad_w,
+                                           int stride_h,
+                                           int stride_w,
+                                           int dilation_h,
+                                           int dilation_w,
+                                           const common::Target &target,
+                                           const std::string &output_name) {
+  CHECK_EQ(input->shape.size(), 4U) << "Input's dimension of im2col conv2d is not 4! Please check.";
+  CHECK_EQ(weights->shape.size(), 4U) << "Weight's dimension of im2col conv2d is not 4! Please check.";
+  CHECK(MathEqual(input->shape[1], weights->shape[1])) << "im2col conv2d does not support groups";
+  auto type    = input->type();
+  int c_in     = weights->shape[1].as_int32();
+  int c_out    = weights->shape[0].as_int32();
+  int kh       = weights->shape[2].as_int32();
+  int kw       = weights->shape[3].as_int32();
+  int h_in     = input->shape[2].as_int32();
+  int w_in     = input->shape[3].as_int32();
+  int out_h    = (h_in - ((kh - 1) * dilation_h + 1) + 2 * pad_h) / stride_h + 1;
+  int out_w    = (w_in - ((kw - 1) * dilation_w + 1) + 2 * pad_w) / stride_w + 1;
+  int k_size   = c_in * kh * kw;
+  int oc_bn    = GetArrayPackingFactor(c_out, type, target);
+  Expr oc_blk  = Expr(oc_bn);
+  Expr kernels = Expr(kh * kw);
+
+  // col[b, j, p]: the input element multiplied by the j-th weight of the filter at the p-th output position
+  auto col = Compute(
+      {input->shape[0], Expr(k_size), Expr(out_h * out_w)},
+      [=](Expr b, Expr j, Expr p) {
+        Expr y    = p / out_w * stride_h + j % kernels / kw * dilation_h - pad_h;
+        Expr x    = p % out_w * stride_w + j % kw * dilation_w - pad_w;
+        auto cond = lang::logic_and({y >= 0, y < h_in, x >= 0, x < w_in});
+        return ir::Select::Make(cond, input(b, j / kernels, y, x), ir::Zero(type));
+      },
+      UniqName("im2col_col"));
+  // pack the weights so that oc_bn output channels are contiguous in the innermost axis
+  auto packed_weights = Compute(
+      {Expr(c_out / oc_bn), Expr(k_size), oc_blk},
+      [=](Expr oc_chunk, Expr j, Expr oc_block) {
+        return weights(oc_chunk * oc_blk + oc_block, j / kernels, j % kernels / kw, j % kw);
+      },
+      UniqName("im2col_packed_weights"));
+  Var rj(k_size, UniqName("rj"));
+  auto gemm = Compute(
+      {input->shape[0], Expr(c_out / oc_bn), Expr(out_h * out_w), oc_blk},
+      [=](Expr b, Expr oc_chunk, Expr p, Expr oc_block) {
+        return lang::ReduceSum(packed_weights(oc_chunk, rj, oc_block) * col(b, rj, p), {rj});
+      },
+      UniqName("im2col_gemm"));
+  auto res = Compute(
+      {input->shape[0], weights->shape[0], Expr(out_h), Expr(out_w)},
+      [=](Expr b, Expr k, Expr h, Expr w) { return gemm(b, k / oc_blk, h * out_w + w, k % oc_blk); },
+      output_name);
+  return {res, gemm, packed_weights, col};
+}
+
+std::string SelectConv2dAlgorithm(const std::vector<int> &input_shape,
+                                  const std::vector<int> &weight_shape,
+                                  const std::vector<int> &stride,
+                                  const std::vector<int> &padding,
+                                  const std::vector<int> &dilation,
+                                  double extra_bytes,
+                                  const common::Target &target,
+                                  int *tile_size) {
+  CHECK_EQ(input_shape.size(), 4U);
+  CHECK_EQ(weight_shape.size(), 4U);
+  CHECK(tile_size);
+  CHECK(target.arch == common::Target::Arch::X86) << "conv2d algorithm selection is only used in x86";
+  *tile_size = 0;
+  // The efficiencies are the estimated fractions of the peak throughput each algorithm reaches, and the bytes
+  // moved through the intermediate tensors are weighted as kBytesCost flops each.
+  constexpr double kBytesCost = 0.5;
+  int batch = input_shape[0], c_in = input_shape[1], h_in = input_shape[2], w_in = input_shape[3];
+  int c_out = weight_shape[0], c_filter = weight_shape[1], kh = weight_shape[2], kw = weight_shape[3];
+  int groups = c_in / c_filter;
+  int out_h  = (h_in - ((kh - 1) * dilation[0] + 1) + 2 * padding[0]) / stride[0] + 1;
+  int out_w  = (w_in - ((kw - 1) * dilation[1] + 1) + 2 * padding[1]) / stride[1] + 1;
+  // the grouped convs keep computing on NCHWc
+  if (groups != 1) return "direct";
+  double direct_flops = 2.0 * batch * c_out * out_h * out_w * c_filter * kh * kw;
+
+  auto key     = GenerateX86ConvKey(input_shape, weight_shape, stride, padding, dilation);
+  auto &params = ScheduleParam::get_x86_instance().GetOrLoadParam(CreateX86SerialData);
+  // the direct algorithm runs faster with the tuned params
+  bool tuned      = params.count(key) > 0;
+  double best     = direct_flops / (tuned ? 0.8 : 0.6);
+  std::string res = "direct";
+  VLOG(4) << "conv2d " << key << " direct cost: " << best;
+
+  if (kh == 3 && kw == 3 && stride[0] == 1 && stride[1] == 1 && dilation[0] == 1 && dilation[1] == 1) {
+    // a "winograd_tile" entry in the tuned params overrides the cost model, the tile size 0 disables winograd
+    if (tuned && params.at(key).count("winograd_tile")) {
+      auto &tile = params.at(key).at("winograd_tile");
+      CHECK_EQ(tile.size(), 1U) << "the winograd_tile param of " << key << " should have one value";
+      CHECK(tile[0] == 0 || tile[0] == 2 || tile[0] == 4)
+          << "winograd only supports the tile size 2 or 4, but got " << tile[0];
+      if (tile[0]) {
+        *tile_size = tile[0];
+        VLOG(3) << "select the tuned winograd F(" << tile[0] << ", 3) algorithm for conv2d " << key;
+        return "winograd";
+      }
+    } else {
+      for (int m : {2, 4}) {
+        int alpha    = m + 2;
+        double tiles = static_cast<double>(batch) * ((out_h + m - 1) / m) * ((out_w + m - 1) / m);
+        double gemm  = 2.0 * alpha * alpha * tiles * c_in * c_out;
+        // an unrolled term of the input and the inverse transforms is a multiply-add
+        double trans = 2.0 * tiles * (WinogradTransformTerms("BT", m) * c_in + WinogradTransformTerms("AT", m) * c_out);
+        double bytes = 4.0 * alpha * alpha * tiles * (c_in + c_out) + extra_bytes;
+        double cost  = gemm / 0.5 + trans / 0.25 + bytes * kBytesCost;
+        VLOG(4) << "conv2d " << key << " winograd F(" << m << ", 3) cost: " << cost;
+        if (cost < best) {
+          best       = cost;
+          res        = "winograd";
+          *tile_size = m;
+        }
+      }
+    }
+  }
+  if (c_in * kh * kw >= 512 && c_out >= 256) {
+    double bytes = 4.0 * batch * c_in * kh * kw * out_h * out_w + extra_bytes;
+    double cost  = direct_flops / 0.75 + bytes * kBytesCost;
+    VLOG(4) << "conv2d " << key << " im2col cost: " << cost;
+    if (cost < best) {
+      best       = cost;
+      res        = "im2col";
+      *tile_size = 0;
+    }
+  }
+#ifdef CINN_WITH_MKLDNN
+  {
+    double cost = direct_flops / 0.7 + extra_bytes * kBytesCost;
+    VLOG(4) << "conv2d " << key << " mkldnn cost: " << cost;
+    if (cost < best) {
+      best       = cost;
+      res        = "mkldnn";
+      *tile_size = 0;
+    }
+  }
+#endif
+  VLOG(3) << "select " << res << " algorithm for conv2d " << key;
+  return res;
+}
+
 std::vector<ir::Tensor> Conv2d_NHWC(const ir::Tensor &input,
                                     const ir::Tensor &weights,
                                     int pad_h,
@@ -519,53 +828,99 @@ ir::Tensor BatchNorm_NCHWc(const ir::Tensor &input,
   return res;
 }
 
+namespace {
+std::vector<Expr> RemoveAxis(const std::vector<Expr> &indice, int axis) {
+  std::vector<Expr> new_indice;
+  for (size_t i = 0; i < indice.size(); i++) {
+    if (static_cast<int>(i) != axis) {
+      new_indice.push_back(indice[i]);
+    }
+  }
+  return new_indice;
+}
+
+// The max and the sum of exponents along the axis of A, which are shared by softmax and log_softmax.
+// Subtracting the max from the inputs keeps the exponents from overflowing.
+std::vector<ir::Tensor> SoftmaxReduce(const ir::Tensor &A, int axis, const std::string &prefix) {
+  std::vector<Expr> new_shapes = RemoveAxis(A->shape, axis);
+  // the indices of A with the reduce axis taken by reduce_axis
+  auto with_axis = [=](const std::vector<Expr> &indice, Expr reduce_axis) {
+    std::vector<Expr> new_indice;
+    int count = 0;
+    for (size_t i = 0; i < A->shape.size(); i++) {
+      if (static_cast<int>(i) != axis) {
+        new_indice.push_back(indice[count++]);
+      } else {
+        new_indice.push_back(reduce_axis);
+      }
+    }
+    return new_indice;
+  };
+
+  Var max_axis(A->shape[axis], UniqName("reduce_axis"));
+  auto max = Compute(
+      new_shapes,
+      [=](const std::vector<Expr> &indice) { return lang::ReduceMax(A(with_axis(indice, max_axis)), {max_axis}); },
+      UniqName(prefix + "_max"));
+  // evaluate each exponent only once, the sum and the softmax output both read it
+  auto exp = Compute(
+      A->shape,
+      [=](const std::vector<Expr> &indice) { return lang::Exp(A(indice) - max(RemoveAxis(indice, axis))); },
+      UniqName(prefix + "_exp"));
+  Var sum_axis(A->shape[axis], UniqName("reduce_axis"));
+  auto sum = Compute(
+      new_shapes,
+      [=](const std::vector<Expr> &indice) { return lang::ReduceSum(exp(with_axis(indice, sum_axis)), {sum_axis}); },
+      UniqName(prefix + "_temp_out"));
+  return {sum, max, exp};
+}
+}  // namespace
+
 /**
  * This operator implements the softmax layer.
  * @param A The input tensor.
  * @param axis The axis parameter.
  * @param output_name The name of output tensor.
- * @return The calculated output tensor.
+ * @return The calculated output tensor, followed by the sum of exponents, the max and the exponents along the axis.
  */
 std::vector<ir::Tensor> Softmax(const ir::Tensor &A, int axis, const std::string &output_name) {
   if (axis == -1) {
     axis = A->shape.size() - 1;
   }
-  Var reduce_axis(A->shape[axis], UniqName("reduce_axis"));
-  std::vector<Expr> new_shapes;
-  for (size_t i = 0; i < A->shape.size(); i++) {
-    if (static_cast<int>(i) != axis) {
-      new_shapes.push_back(A->shape[i]);
-    }
+  auto reduced = SoftmaxReduce(A, axis, "softmax");
+  auto sum     = reduced[0];
+  auto exp     = reduced[2];
+
+  ir::Tensor out = Compute(
+      A->shape,
+      [=](const std::vector<Expr> &indice) { return exp(indice) / sum(RemoveAxis(indice, axis)); },
+      UniqName("softmax_out"));
+  return {out, sum, reduced[1], exp};
+}
+
+/**
+ * This operator implements the log_softmax layer, log(softmax(A)) = A - max - log(sum(exp(A - max))).
+ * @param A The input tensor.
+ * @param axis The axis parameter.
+ * @param output_name The name of output tensor.
+ * @return The calculated output tensor, followed by the sum of exponents, the max and the exponents along the axis.
+ */
+std::vector<ir::Tensor> LogSoftmax(const ir::Tensor &A, int axis, const std::string &output_name) {
+  if (axis == -1) {
+    axis = A->shape.size() - 1;
   }
-  auto temp = Compute(
-      new_shapes,
-      [=](const std::vector<Expr> &indice) {
-        std::vector<Expr> new_indice;
-        int count = 0;
-        for (size_t i = 0; i < A->shape.size(); i++) {
-          if (static_cast<int>(i) != axis) {
-            new_indice.push_back(indice[count++]);
-          } else {
-            new_indice.push_back(reduce_axis);
-          }
-        }
-        return lang::ReduceSum(lang::Exp(A(new_indice)), {reduce_axis});
-      },
-      UniqName("softmax_temp_out"));
+  auto reduced = SoftmaxReduce(A, axis, "log_softmax");
+  auto sum     = reduced[0];
+  auto max     = reduced[1];
 
   ir::Tensor out = Compute(
       A->shape,
       [=](const std::vector<Expr> &indice) {
-        std::vector<Expr> new_indice;
-        for (size_t i = 0; i < indice.size(); i++) {
-          if (static_cast<int>(i) != axis) {
-            new_indice.push_back(indice[i]);
-          }
-        }
-        return lang::Exp(A(indice)) / temp(new_indice);
+        auto new_indice = RemoveAxis(indice, axis);
+        return A(indice) - max(new_indice) - lang::Log(sum(new_indice));
       },
-      UniqName("softmax_out"));
-  return {out, temp};
+      UniqName("log_softmax_out"));
+  return {out, sum, max, reduced[2]};
 }
 
 std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A, int axis, const std::string &output_name) {
@@ -164,6 +164,96 @@ std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
                                            int dilation_w,
                                            const std::string &output_name = UniqName("T_Conv2d_NCHW_out"));
 
+/**
+ * @brief Transform the 3x3 weights of a 2-D convolution for the Winograd algorithm F(m x m, 3 x 3), i.e. U = G g G^T.
+ *
+ * @param weights The 4-D weight tensor {C_out, C_in, 3, 3}
+ * @param tile_size The output tile size m, 2 or 4
+ * @param output_name The name of the output tensor
+ *
+ * @return the transformed weight tensor {m + 2, m + 2, C_in, C_out}
+ */
+ir::Tensor Conv2d_Winograd_WeightTransform(const ir::Tensor &weights,
+                                           int tile_size,
+                                           const std::string &output_name = UniqName("T_Winograd_weight_transform"));
+
+/**
+ * @brief Perform a 3x3 stride-1 2-D convolution with an NCHW-layout by the Winograd algorithm F(m x m, 3 x 3).
+ *
+ * @param input The 4-D input tensor {N, C_in, H, W}
+ * @param transformed_weights The weight tensor {m + 2, m + 2, C_in, C_out} transformed by
+ * Conv2d_Winograd_WeightTransform
+ * @param pad_h padding applied to the height of the image
+ * @param pad_w padding applied to the width of the image
+ * @param tile_size The output tile size m, 2 or 4
+ * @param output_name The name of the output tensor
+ *
+ * @return the output tensor {N, C_out, H + 2 * pad_h - 2, W + 2 * pad_w - 2}, followed by the inverse transformed
+ * tiles, the batched GEMM output and the transformed input tiles.
+ */
+std::vector<ir::Tensor> Conv2d_NCHW_Winograd(const ir::Tensor &input,
+                                             const ir::Tensor &transformed_weights,
+                                             int pad_h,
+                                             int pad_w,
+                                             int tile_size,
+                                             const std::string &output_name = UniqName("T_Conv2d_NCHW_winograd_out"));
+
+/**
+ * @brief Perform a 2-D convolution with an NCHW-layout by lowering the input patches to columns (im2col) and
+ * multiplying them with the packed weights.
+ *
+ * @param input The 4-D input tensor {N, C_in, H, W}
+ * @param weights The 4-D weight tensor {C_out, C_in, filter_h, filter_w}
+ * @param pad_h padding applied to the height of the image
+ * @param pad_w padding applied to the width of the image
+ * @param stride_h striding applied to the height of the image
+ * @param stride_w striding applied to the width of the image
+ * @param dilation_h dilation applied to the height of the image
+ * @param dilation_w dilation applied to the width of the image
+ * @param output_name The name of the output tensor
+ *
+ * @return the output tensor, followed by the GEMM output, the packed weights and the column tensor.
+ */
+std::vector<ir::Tensor> Conv2d_NCHW_Im2col(const ir::Tensor &input,
+                                           const ir::Tensor &weights,
+                                           int pad_h,
+                                           int pad_w,
+                                           int stride_h,
+                                           int stride_w,
+                                           int dilation_h,
+                                           int dilation_w,
+                                           const common::Target &target   = common::DefaultHostTarget(),
+                                           const std::string &output_name = UniqName("T_Conv2d_NCHW_im2col_out"));
+
+/**
+ * @brief Select the algorithm of a 2-D NCHW convolution on X86 by an analytical cost model.
+ *
+ * The candidates are "direct"(the NCHWc convolution), "winograd"(3x3 stride-1 only), "im2col" and "mkldnn"(only when
+ * built with MKLDNN). The cost of each one is its FLOPs divided by an estimated efficiency plus the bytes of its
+ * intermediate tensors. A "winograd_tile" entry in the tuned params of the conv overrides the choice of winograd, with
+ * the tile size to use or 0 to never use it.
+ *
+ * @param input_shape The input shape {N, C_in, H, W}
+ * @param weight_shape The weight shape {C_out, C_in/group, filter_h, filter_w}
+ * @param stride The strides
+ * @param padding The paddings
+ * @param dilation The dilations
+ * @param extra_bytes The bytes of the layout transforms needed by the algorithms computing on NCHW, which is charged
+ * to all the candidates except "direct"
+ * @param target The target
+ * @param tile_size The output tile size of the Winograd algorithm if it is selected
+ *
+ * @return the name of the selected algorithm
+ */
+std::string SelectConv2dAlgorithm(const std::vector<int> &input_shape,
+                                  const std::vector<int> &weight_shape,
+                                  const std::vector<int> &stride,
+                                  const std::vector<int> &padding,
+                                  const std::vector<int> &dilation,
+                                  double extra_bytes,
+                                  const common::Target &target,
+                                  int *tile_size);
+
 /**
  * @brief Perform a 2-D convolution with an NHWC-layout and support group and depthwise convolution.
  *
@@ -289,6 +379,10 @@ std::vector<ir::Tensor> Softmax(const ir::Tensor &A,
                                 int axis                       = -1,
                                 const std::string &output_name = UniqName("T_softmax_out"));
 
+std::vector<ir::Tensor> LogSoftmax(const ir::Tensor &A,
+                                   int axis                       = -1,
+                                   const std::string &output_name = UniqName("T_log_softmax_out"));
+
 std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A,
                                       int axis                       = -1,
                                       const std::string &output_name = UniqName("T_softmax_out"));
@@ -36,6 +36,19 @@ ScheduleParam::ScheduleParam() {}
 
 ScheduleParam::~ScheduleParam() {}
 
+absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, std::vector<int>>> &ScheduleParam::GetOrLoadParam(
+    void (*create_default)(const std::string &)) {
+  std::call_once(default_loaded_, [&] {
+    if (!param_data.empty()) return;
+    // the default params of x86 and cuda are created in the same file
+    static std::mutex file_mutex;
+    std::lock_guard<std::mutex> lock(file_mutex);
+    create_default("default_serial.log");
+    LoadSerialData(&param_data, "default_serial.log");
+  });
+  return param_data;
+}
+
 int GetInnerSplitter(int origin, int other_axis) {
   int two_exp = 1;
   while (origin % two_exp == 0) {
@@ -312,19 +325,84 @@ void MulScheduleCPU(poly::StageMap stages,
   }
 }
 
-void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir::Tensor &temp, int axis) {
+void SoftmaxScheduleCPU(poly::StageMap stage,
+                        const ir::Tensor &output,
+                        const ir::Tensor &temp,
+                        const ir::Tensor &max,
+                        const ir::Tensor &exp,
+                        int axis,
+                        const common::Target &target) {
   if (axis == -1) {
     axis += output->shape.size();
   }
+  // the outer axes before the reduce axis index the rows: [outer_fused, axis, inner...]
+  auto parallel_rows = [&](poly::Stage *row_stage) {
+    for (int i = 1; i < axis; i++) {
+      row_stage->Fuse(0, 1);
+    }
+    row_stage->Parallel(0);
+  };
+  if (axis > 0) {
+    parallel_rows(stage[max]);
+  }
+  int vectorize_factor = 1;
+  if (axis == static_cast<int>(output->shape.size()) - 1) {
+    vectorize_factor = GetVectorizeFactor(output->shape.back().as_int32(), GetBasicFactor(output->type(), target));
+  }
+  if (!stage[exp]->inlined()) {
+    parallel_rows(stage[exp]);
+    if (vectorize_factor > 1) {
+      stage[exp]->Vectorize(stage[exp]->n_out_dims() - 1, vectorize_factor);
+    }
+  }
+
   poly::Iterator fused = stage[output]->axis(0);
   stage[output]->Parallel(fused);
   for (int i = 1; i < axis; i++) {
     fused = stage[output]->Fuse(0, 1);
   }
   CHECK_GT(stage[output]->n_out_dims(), 1);
+  if (vectorize_factor > 1) {
+    stage[output]->Vectorize(stage[output]->n_out_dims() - 1, vectorize_factor);
+  }
   stage[temp]->ComputeAt(stage[output], 0);
 }
 
+ir::Tensor ReduceScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target) {
+  // the minimal extent of the parallel loop to keep all the threads busy
+  const int kParallelExtent = 16;
+  // the number of partial results computed in parallel by a rfactor
+  const int kRFactorParallel = 8;
+  if (!output->is_reduce_tensor() || stages[output]->inlined()) return output;
+  int out_extent = 1;
+  for (auto &dim : output->shape) {
+    CHECK(dim.is_constant());
+    out_extent *= dim.as_int32();
+  }
+  int lanes         = GetBasicFactor(output->type(), target);
+  auto &last_reduce = output->reduce_axis.back();
+  int reduce_extent = last_reduce->upper_bound.as_int32() - last_reduce->lower_bound.as_int32();
+  if (out_extent < kParallelExtent && reduce_extent >= kRFactorParallel * lanes * 4) {
+    ir::Tensor res;
+    auto rf         = stages[output]->RFactor(kRFactorParallel, lanes, stages, res);
+    int n_out       = res->shape.size();
+    int n_rf_dims   = stages[rf]->n_out_dims();
+    // [out..., kp, kv, reduce...] -> [out..., kp, reduce..., kv]
+    std::vector<int> order;
+    for (int i = n_out + 2; i < n_rf_dims; i++) order.push_back(i);
+    order.push_back(n_out + 1);
+    stages[rf]->Reorder(order);
+    for (int i = 0; i < n_out; i++) stages[rf]->Fuse(0, 1);
+    stages[rf]->Parallel(0);
+    stages[rf]->Vectorize(n_rf_dims - n_out - 1, lanes);
+    return res;
+  }
+  if (out_extent > 1) {
+    stages[output]->Parallel(0);
+  }
+  return output;
+}
+
 void PoolScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target) {
   CHECK_GE(stages[output]->n_out_dims(), 2);
   stages[output]->Fuse({0, 1});
@@ -350,11 +428,7 @@ void GetConv2dFactors(absl::flat_hash_map<std::string, int> *factors,
                       const std::string &key,
                       bool import_params) {
   if (import_params) {
-    auto &params = ScheduleParam::get_x86_instance().GetParam();
-    if (params.empty()) {
-      CreateX86SerialData();
-      LoadSerialData(&params);
-    }
+    auto &params = ScheduleParam::get_x86_instance().GetOrLoadParam(CreateX86SerialData);
     if (params.count(key)) {
       VLOG(3) << "find saved param, key is: " << key;
       CHECK(!params[key]["oc_bn"].empty());
@@ -1133,6 +1207,46 @@ void Conv2d_NCHWc_Schedule_CPU(poly::StageMap stages,
   }
 }
 
+void Conv2d_Winograd_Schedule_CPU(poly::StageMap stages,
+                                  const ir::Tensor &res,
+                                  const ir::Tensor &inverse,
+                                  const ir::Tensor &batch_gemm,
+                                  const ir::Tensor &input_tile,
+                                  const common::Target &target) {
+  CHECK(target.arch == Target::Arch::X86) << "Conv2d_Winograd_Schedule_CPU schedule only used in x86";
+  // input_tile: [alpha, alpha, c_in, tiles] -> [alpha_alpha_fused, c_in, tiles]
+  stages[input_tile]->Fuse({0, 1});
+  stages[input_tile]->Parallel(0);
+  // batch_gemm: [alpha, alpha, c_out, tiles] -> [alpha_alpha_fused, c_out, tiles]
+  stages[batch_gemm]->Fuse({0, 1});
+  stages[batch_gemm]->Parallel(0);
+  // inverse: [c_out, tiles, m, m] -> [c_out_tiles_fused, m, m]
+  stages[inverse]->Fuse({0, 1});
+  stages[inverse]->Parallel(0);
+  // res: [batch, c_out, out_h, out_w] -> [batch_c_out_fused, out_h, out_w]
+  stages[res]->Fuse({0, 1});
+  stages[res]->Parallel(0);
+}
+
+void Conv2d_Im2col_Schedule_CPU(poly::StageMap stages,
+                                const ir::Tensor &res,
+                                const ir::Tensor &gemm,
+                                const ir::Tensor &packed_weights,
+                                const ir::Tensor &col,
+                                const common::Target &target) {
+  CHECK(target.arch == Target::Arch::X86) << "Conv2d_Im2col_Schedule_CPU schedule only used in x86";
+  // col: [batch, k_size, out_h * out_w] -> [batch_k_size_fused, out_h * out_w]
+  stages[col]->Fuse({0, 1});
+  stages[col]->Parallel(0);
+  stages[packed_weights]->Parallel(0);
+  // gemm: [batch, oc_chunk, out_h * out_w, oc_block] -> [batch_oc_chunk_fused, out_h * out_w, oc_block]
+  stages[gemm]->Fuse({0, 1});
+  stages[gemm]->Parallel(0);
+  // res: [batch, c_out, out_h, out_w] -> [batch_c_out_fused, out_h, out_w]
+  stages[res]->Fuse({0, 1});
+  stages[res]->Parallel(0);
+}
+
 void Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
                                                 const ir::Tensor &res,
                                                 ir::Tensor &packed_out,
@@ -1374,11 +1488,7 @@ void CudaScheduleConv(poly::StageMap stages,
                       ir::Tensor &weights,
                       ir::Tensor &output,
                       const common::Target &target) {
-  auto &res = ScheduleParam::get_cuda_instance().GetParam();
-  if (res.empty()) {
-    CreateCudaSerialData();
-    LoadSerialData(&res);
-  }
+  auto &res = ScheduleParam::get_cuda_instance().GetOrLoadParam(CreateCudaSerialData);
 
   int n = output->shape[0].as_int32();
   int c = output->shape[1].as_int32();
@@ -1437,7 +1547,7 @@ void CudaScheduleConv2(poly::StageMap stages,
                        ir::Tensor &output,
                        const common::Target &target,
                        const std::string &key) {
-  auto &res = ScheduleParam::get_cuda_instance().GetParam();
+  auto &res = ScheduleParam::get_cuda_instance().GetOrLoadParam(CreateCudaSerialData);
   stages[input_pad]->ComputeInline();
   optim::Simplify(&(output->shape[2]));
   optim::Simplify(&(output->shape[3]));
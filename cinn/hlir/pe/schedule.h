@@ -44,12 +44,19 @@ class ScheduleParam {
   absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, std::vector<int>>> &GetParam() {
     return param_data;
   }
+  /**
+   * Get the params, the default ones are created by \p create_default and loaded on the first call if none are set.
+   * Thread safe, while the params should not be changed by GetParam when the schedules may read them.
+   */
+  absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, std::vector<int>>> &GetOrLoadParam(
+      void (*create_default)(const std::string &));
   absl::flat_hash_map<std::string, std::vector<int>> &operator[](const std::string &key) { return param_data[key]; }
   int Count(const std::string &key) { return param_data.count(key); }
 
  private:
   ScheduleParam();
   absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, std::vector<int>>> param_data;
+  std::once_flag default_loaded_;
 };
 
 int GetInnerSplitter(int origin, int other_axis);
@@ -82,7 +89,28 @@ void MulScheduleCPU(poly::StageMap stage,
                     const ir::Tensor &input_tensor,
                     const common::Target &target);
 
-void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir::Tensor &temp, int axis = -1);
+/**
+ * Schedule softmax and log_softmax on CPU: the rows along the axis run in parallel in each stage. Only the sum of the
+ * exponents of a row is computed right before normalizing it, the max and the exponents (if not inlined) remain
+ * separate passes over the whole input.
+ */
+void SoftmaxScheduleCPU(poly::StageMap stage,
+                        const ir::Tensor &output,
+                        const ir::Tensor &temp,
+                        const ir::Tensor &max,
+                        const ir::Tensor &exp,
+                        int axis                      = -1,
+                        const common::Target &target = common::DefaultHostTarget());
+
+/**
+ * Schedule a reduction on CPU. The non-reduced axes run in parallel if they are large enough, otherwise the last reduce
+ * axis is factored out by Stage::RFactor so that its partial results are computed in parallel and vectorized.
+ *
+ * @return the tensor holding the result of the reduction, which replaces the output if it is factored.
+ */
+ir::Tensor ReduceScheduleCPU(poly::StageMap stages,
+                             const ir::Tensor &output,
+                             const common::Target &target = common::DefaultHostTarget());
 
 void GetConv2dFactors(absl::flat_hash_map<std::string, int> *factors,
                       int oc,
@@ -113,6 +141,20 @@ void Conv2d_NCHWc_Schedule_CPU(poly::StageMap stages,
                                const std::string &key,
                                bool do_padding);
 
+void Conv2d_Winograd_Schedule_CPU(poly::StageMap stages,
+                                  const ir::Tensor &res,
+                                  const ir::Tensor &inverse,
+                                  const ir::Tensor &batch_gemm,
+                                  const ir::Tensor &input_tile,
+                                  const common::Target &target);
+
+void Conv2d_Im2col_Schedule_CPU(poly::StageMap stages,
+                                const ir::Tensor &res,
+                                const ir::Tensor &gemm,
+                                const ir::Tensor &packed_weights,
+                                const ir::Tensor &col,
+                                const common::Target &target);
+
 void PoolScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target);
 void PoolScheduleGPU(poly::StageMap stages, ir::Tensor &output, const common::Target &target);
 
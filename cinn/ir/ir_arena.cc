@@ -0,0 +1,141 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/ir_arena.h"
+
+#include <cstring>
+#include <new>
+
+#include "cinn/ir/ir_base.h"
+
+namespace cinn {
+namespace ir {
+
+namespace {
+constexpr size_t kAlignment     = 16;
+constexpr size_t kMaxCachedSize = 512;
+
+thread_local IrArena* current_arena = nullptr;
+
+// The nodes are allocated in the multiple of kAlignment even without an arena, so any node deleted in an arena can
+// be reused for a node of the same rounded size.
+inline size_t RoundUp(size_t size) { return (size + kAlignment - 1) / kAlignment * kAlignment; }
+}  // namespace
+
+IrArena::IrArena(bool hash_cons)
+    : hash_cons_(hash_cons), parent_(current_arena), free_lists_(kMaxCachedSize / kAlignment) {
+  current_arena = this;
+}
+
+IrArena::~IrArena() {
+  CHECK_EQ(current_arena, this) << "The IrArenas should be destroyed in the reverse order of creation on their thread";
+  // the shared immediates not used outside are freed to the free lists
+  for (auto& item : imms_) {
+    if (common::ref_count(item.second).Dec() == 0) delete item.second;
+  }
+  imms_.clear();
+  current_arena = parent_;
+
+  for (auto& free_list : free_lists_) {
+    for (void* p : free_list) ::operator delete(p);
+  }
+  VLOG(4) << "IrArena allocated " << num_allocated_ << " nodes, reused " << num_reused_ << " nodes, shared "
+          << num_shared_imms_ << " immediates";
+}
+
+IrArena* IrArena::Current() { return current_arena; }
+
+void* IrArena::AllocateNode(size_t size) {
+  size = RoundUp(size);
+  auto* arena = current_arena;
+  if (!arena || size > kMaxCachedSize) return ::operator new(size);
+
+  auto& free_list = arena->free_lists_[size / kAlignment - 1];
+  if (free_list.empty()) {
+    arena->num_allocated_++;
+    return ::operator new(size);
+  }
+  arena->num_reused_++;
+  void* p = free_list.back();
+  free_list.pop_back();
+  return p;
+}
+
+void IrArena::FreeNode(void* p, size_t size) {
+  if (!p) return;
+  size        = RoundUp(size);
+  auto* arena = current_arena;
+  if (!arena || size > kMaxCachedSize) {
+    ::operator delete(p);
+    return;
+  }
+  arena->free_lists_[size / kAlignment - 1].push_back(p);
+}
+
+IrNode* IrArena::GetImm(const ImmKey& key,
+                        IrNode* (*create)(const Type&, uint64_t),
+                        const Type& type,
+                        uint64_t value) {
+  auto& node = imms_[key];
+  if (!node) {
+    node = create(type, value);
+    // the arena holds a reference, so the immediate lives until the arena is destroyed
+    common::ref_count(node).Inc();
+  } else {
+    num_shared_imms_++;
+  }
+  return node;
+}
+
+IrNode* IrArena::SharedIntImm(const Type& type, int64_t value) {
+  auto* arena = current_arena;
+  // only the plain types are shared, the customized ones may carry more than the bits
+  if (!arena || !arena->hash_cons_ || type != Int(type.bits())) return nullptr;
+  return arena->GetImm(
+      {static_cast<int>(IrNodeTy::IntImm), type.bits(), static_cast<uint64_t>(value)},
+      [](const Type& t, uint64_t v) -> IrNode* { return new IntImm(t, static_cast<int64_t>(v)); },
+      type,
+      value);
+}
+
+IrNode* IrArena::SharedUIntImm(const Type& type, uint64_t value) {
+  auto* arena = current_arena;
+  if (!arena || !arena->hash_cons_ || type != UInt(type.bits())) return nullptr;
+  return arena->GetImm(
+      {static_cast<int>(IrNodeTy::UIntImm), type.bits(), value},
+      [](const Type& t, uint64_t v) -> IrNode* { return new UIntImm(t, static_cast<int64_t>(v)); },
+      type,
+      value);
+}
+
+IrNode* IrArena::SharedFloatImm(const Type& type, double value) {
+  auto* arena = current_arena;
+  if (!arena || !arena->hash_cons_ || type != Float(type.bits())) return nullptr;
+  // FloatImm holds the value converted to float, key on the value held
+  double held = static_cast<float>(value);
+  uint64_t bits;
+  std::memcpy(&bits, &held, sizeof(bits));
+  return arena->GetImm(
+      {static_cast<int>(IrNodeTy::FloatImm), type.bits(), bits},
+      [](const Type& t, uint64_t v) -> IrNode* {
+        double x;
+        std::memcpy(&x, &v, sizeof(x));
+        return new FloatImm(t, x);
+      },
+      type,
+      bits);
+}
+
+}  // namespace ir
+}  // namespace cinn
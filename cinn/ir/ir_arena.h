@@ -0,0 +1,95 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "cinn/common/type.h"
+
+namespace cinn {
+namespace ir {
+
+class IrNode;
+
+/**
+ * The memory of the IR nodes created in a session, e.g. the lowering of a fused group, in which the passes create and
+ * drop lots of small nodes.
+ *
+ * An arena is active on the thread creating it until it is destroyed, the arenas nest. While active, the nodes
+ * deleted on the thread are cached in the free lists of their size, and the new nodes reuse them, so the nodes do not
+ * go to the allocator for each copy or simplification. The nodes are still allocated one by one, so they can outlive
+ * the arena, which returns the cached memory to the allocator when destroyed.
+ *
+ * With \p hash_cons, the integer and float immediates created by `Expr(int)` and similar are shared by value in the
+ * arena. The shared immediates should not be changed in place.
+ */
+class IrArena {
+ public:
+  explicit IrArena(bool hash_cons = false);
+  ~IrArena();
+
+  IrArena(const IrArena&) = delete;
+  IrArena& operator=(const IrArena&) = delete;
+
+  //! The arena active on the current thread, nullptr if none.
+  static IrArena* Current();
+
+  //! Allocate and free the memory of an IR node, from and to the arena active on the current thread if any.
+  // @{
+  static void* AllocateNode(size_t size);
+  static void FreeNode(void* p, size_t size);
+  // @}
+
+  //! Get the immediate of \p type and \p value shared in the current arena, nullptr if not hash-consing.
+  // @{
+  static IrNode* SharedIntImm(const Type& type, int64_t value);
+  static IrNode* SharedUIntImm(const Type& type, uint64_t value);
+  static IrNode* SharedFloatImm(const Type& type, double value);
+  // @}
+
+  bool hash_cons() const { return hash_cons_; }
+
+  //! The statistics of the arena.
+  // @{
+  int64_t num_allocated() const { return num_allocated_; }
+  int64_t num_reused() const { return num_reused_; }
+  int64_t num_shared_imms() const { return num_shared_imms_; }
+  // @}
+
+ private:
+  //! The immediates are keyed by the node type, the bits of the type and the bits of the value.
+  using ImmKey = std::tuple<int, int, uint64_t>;
+
+  IrNode* GetImm(const ImmKey& key, IrNode* (*create)(const Type&, uint64_t), const Type& type, uint64_t value);
+
+  const bool hash_cons_;
+  IrArena* parent_{};
+
+  //! The cached nodes of size `(i + 1) * kAlignment`.
+  std::vector<std::vector<void*>> free_lists_;
+  absl::flat_hash_map<ImmKey, IrNode*> imms_;
+
+  int64_t num_allocated_{};
+  int64_t num_reused_{};
+  int64_t num_shared_imms_{};
+};
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,77 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/ir_arena.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace ir {
+
+TEST(IrArena, reuse_nodes) {
+  IrArena arena;
+  ASSERT_EQ(IrArena::Current(), &arena);
+  Var x("x");
+  for (int i = 0; i < 10; i++) {
+    Expr e = Add::Make(x, Expr(i));
+  }
+  // the nodes dropped in the previous iterations are reused
+  ASSERT_GT(arena.num_reused(), 0);
+  ASSERT_EQ(arena.num_shared_imms(), 0);
+}
+
+TEST(IrArena, hash_cons) {
+  Expr outlived;
+  {
+    IrArena arena(true);
+    Expr a(1);
+    Expr b(1);
+    Expr c(2);
+    Expr d(1.f);
+    Expr e(1.f);
+    ASSERT_TRUE(a.same_as(b));
+    ASSERT_FALSE(a.same_as(c));
+    ASSERT_TRUE(d.same_as(e));
+    ASSERT_FALSE(Expr(int64_t(1)).same_as(a));
+    ASSERT_EQ(arena.num_shared_imms(), 2);
+
+    Var x("x");
+    outlived = Add::Make(x, Expr(3));
+  }
+  ASSERT_EQ(IrArena::Current(), nullptr);
+  // the nodes outlive the arena
+  ASSERT_EQ(utils::GetStreamCnt(outlived), "(x + 3)");
+  ASSERT_FALSE(Expr(1).same_as(Expr(1)));
+}
+
+TEST(IrArena, nested) {
+  IrArena outer(true);
+  Expr a(1);
+  {
+    IrArena inner;
+    ASSERT_EQ(IrArena::Current(), &inner);
+    // the inner arena does not share immediates
+    ASSERT_FALSE(Expr(1).same_as(a));
+  }
+  ASSERT_EQ(IrArena::Current(), &outer);
+  ASSERT_TRUE(Expr(1).same_as(a));
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -18,6 +18,7 @@
 #include "cinn/common/common.h"
 #include "cinn/ir/buffer.h"
 #include "cinn/ir/ir.h"
+#include "cinn/ir/ir_arena.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_visitor.h"
 #include "cinn/ir/module.h"
@@ -65,6 +66,34 @@ Expr Zero(const Type &type) {
   return Expr();
 }
 
+void *IrNode::operator new(size_t size) { return IrArena::AllocateNode(size); }
+void IrNode::operator delete(void *p, size_t size) { IrArena::FreeNode(p, size); }
+
+Expr::Expr(int32_t x) {
+  auto *node = IrArena::SharedIntImm(Int(32), x);
+  Reset(node ? node : new IntImm(Int(32), x));
+}
+Expr::Expr(uint32_t x) {
+  auto *node = IrArena::SharedUIntImm(UInt(32), x);
+  Reset(node ? node : new UIntImm(UInt(32), x));
+}
+Expr::Expr(int64_t x) {
+  auto *node = IrArena::SharedIntImm(Int(64), x);
+  Reset(node ? node : new IntImm(Int(64), x));
+}
+Expr::Expr(uint64_t x) {
+  auto *node = IrArena::SharedUIntImm(UInt(64), x);
+  Reset(node ? node : new UIntImm(UInt(64), x));
+}
+Expr::Expr(float x) {
+  auto *node = IrArena::SharedFloatImm(Float(32), x);
+  Reset(node ? node : new FloatImm(Float(32), x));
+}
+Expr::Expr(double x) {
+  auto *node = IrArena::SharedFloatImm(Float(64), x);
+  Reset(node ? node : new FloatImm(Float(64), x));
+}
+
 Expr::Expr(const Var &var) { *static_cast<IrNodeRef *>(this) = *static_cast<const IrNodeRef *>(&var); }
 
 int32_t Expr::as_int32() const {
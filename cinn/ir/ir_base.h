@@ -140,6 +140,12 @@ class IrNode : public common::Object {
   explicit IrNode(Type t) : type_(t) {}
   virtual ~IrNode() = default;
 
+  //! The nodes are allocated from the IrArena active on the current thread if any.
+  // @{
+  static void* operator new(size_t size);
+  static void operator delete(void* p, size_t size);
+  // @}
+
   virtual IrNodeTy node_type() const { return IrNodeTy::kUnk; }
   virtual Type type() const { return type_; }
   void set_type(Type type) { type_ = type; }
@@ -282,14 +288,15 @@ struct Expr : public IrNodeRef {
   Expr(IrNode* p) : IrNodeRef(p) {}  // NOLINT
   explicit Expr(const Var& var);
 
-  //! Helper function to construct numeric constants of various types.
+  //! Helper function to construct numeric constants of various types, the numeric constants are shared in the
+  //! IrArena hash-consing on the current thread if any.
   // @{
-  explicit Expr(int32_t x) : IrNodeRef(new IntImm(Int(32), x)) {}
-  explicit Expr(uint32_t x) : IrNodeRef(new UIntImm(UInt(32), x)) {}
-  explicit Expr(int64_t x) : IrNodeRef(new IntImm(Int(64), x)) {}
-  explicit Expr(uint64_t x) : IrNodeRef(new UIntImm(UInt(64), x)) {}
-  explicit Expr(float x) : IrNodeRef(new FloatImm(Float(32), x)) {}
-  explicit Expr(double x) : IrNodeRef(new FloatImm(Float(64), x)) {}
+  explicit Expr(int32_t x);
+  explicit Expr(uint32_t x);
+  explicit Expr(int64_t x);
+  explicit Expr(uint64_t x);
+  explicit Expr(float x);
+  explicit Expr(double x);
   explicit Expr(const std::string& x) : IrNodeRef(new StringImm(x)) {}
   // @}
 
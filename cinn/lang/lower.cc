@@ -21,7 +21,9 @@
 #include <unordered_set>
 #include <utility>
 
+#include "cinn/common/context.h"
 #include "cinn/ir/buffer.h"
+#include "cinn/ir/ir_arena.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/lang/lower_impl.h"
 #include "cinn/optim/optimize.h"
@@ -94,6 +96,8 @@ ir::LoweredFunc Lower(const std::string& name,
                       const std::vector<Tensor>& temp_tensors,
                       Module::Builder* b,
                       const Target& target) {
+  // The nodes dropped by the passes are reused in the lowering.
+  ir::IrArena arena(FLAGS_cinn_ir_hash_cons);
   // Init the reduce tensors first before any process.
   for (auto& t : tensor_args) InitReduceTensor(stages, t, target);
   for (auto& t : temp_tensors) InitReduceTensor(stages, t, target);
@@ -149,6 +153,8 @@ std::vector<ir::LoweredFunc> LowerVec(const std::string& name,
                                       const std::vector<Tensor>& temp_tensors,
                                       Module::Builder* b,
                                       const Target& target) {
+  // The nodes dropped by the passes are reused in the lowering.
+  ir::IrArena arena(FLAGS_cinn_ir_hash_cons);
   // Init the reduce tensors first before any process.
   for (auto& t : tensor_args) InitReduceTensor(stages, t, target);
   for (auto& t : temp_tensors) InitReduceTensor(stages, t, target);
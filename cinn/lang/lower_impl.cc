@@ -109,7 +109,7 @@ Expr LowerGroup(const poly::ScheduleGroup& group,
     Expr statement_candi_expr = tuple_to_expr.at(statement.first);
 
     VLOG(3) << "replacing " << statement.first << " to " << statement_candi_expr;
-    optim::ReplaceIslCallWithExpr(&e, statement.first, statement_candi_expr, axis_expr_map);
+    optim::ReplaceIslCallWithExpr(&e, gen.StatementName(statement.first), statement_candi_expr, axis_expr_map);
   }
   CheckNoIslCallRemains(&e);
 
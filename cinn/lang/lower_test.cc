@@ -151,5 +151,34 @@ TEST(lower, temp_buffer_collects) {
   }
 }
 
+// The groups differing only in the names of their stages share the AST built by isl.
+TEST(lower, reuse_ast) {
+  auto M = Expr(100);
+  auto N = Expr(15);
+
+  auto lower = [&](const std::string& a, const std::string& b) {
+    Placeholder<float> A(a, {M, N});
+    auto B = Compute(
+        {M, N}, [=](Var i, Var j) -> Expr { return A(i, j) + 1.f; }, b);
+    auto stages = CreateStages({B});
+    return Lower("cal_" + b, stages, {A, B});
+  };
+
+  auto fn0 = lower("A", "B");
+  auto fn1 = lower("X", "Y");
+  auto out = R"ROC(
+{
+  for (i, 0, 100)
+  {
+    for (j, 0, 15)
+    {
+      Y[i, j] = (1 + X[i, j])
+    }
+  }
+}
+)ROC";
+  EXPECT_EQ(utils::GetStreamCnt(fn1->body), utils::Trim(out));
+}
+
 }  // namespace lang
 }  // namespace cinn
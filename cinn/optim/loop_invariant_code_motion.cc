@@ -0,0 +1,337 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/loop_invariant_code_motion.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/context.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+//! A call without side effects, e.g. a math function.
+bool IsPureCall(const ir::Call* call) {
+  return call->is_extern_call() && call->write_args.empty() && !call->type().is_void() &&
+         !call->type().is_cpp_handle();
+}
+
+bool IsForloop(const Expr& expr) { return expr.As<ir::For>() || expr.As<ir::PolyFor>(); }
+
+//! Wrap the forloop \p body into a block, so the Lets can be inserted before the forloops in it.
+void WrapForloopInBlock(Expr* body) {
+  if (body->defined() && IsForloop(*body)) *body = ir::Block::Make({*body});
+}
+
+//! What a forloop defines and writes, an expression using none of them is invariant in the forloop.
+struct LoopInfo {
+  absl::flat_hash_set<std::string> defined_vars;
+  absl::flat_hash_set<std::string> stored_tensors;
+  //! No load is invariant if the loop calls a function which may write the memory.
+  bool has_impure_call{false};
+  //! The body runs at least once.
+  bool runs{false};
+
+  explicit LoopInfo(const ir::For* loop) {
+    defined_vars.insert(loop->loop_var->name);
+    auto* min    = loop->min.As<ir::IntImm>();
+    auto* extent = loop->extent.As<ir::IntImm>();
+    runs         = min && extent && min->value < extent->value;
+    CollectBody(loop->body);
+  }
+
+  explicit LoopInfo(const ir::PolyFor* loop) {
+    defined_vars.insert(loop->iterator->name);
+    // only the forloop of `for (i = init; i < extent; ...)` is known to run
+    auto* init = loop->init.As<ir::IntImm>();
+    auto* cond = loop->condition.As<ir::LT>();
+    if (init && cond && cond->a().as_var() && cond->a().as_var()->name == loop->iterator->name) {
+      auto* extent = cond->b().As<ir::IntImm>();
+      runs         = extent && init->value < extent->value;
+    }
+    CollectBody(loop->body);
+  }
+
+  void CollectBody(const Expr& body) {
+    ir::CollectIRNodes(body, [&](const Expr* x) {
+      if (auto* for_ = x->As<ir::For>()) {
+        defined_vars.insert(for_->loop_var->name);
+      } else if (auto* poly_for = x->As<ir::PolyFor>()) {
+        defined_vars.insert(poly_for->iterator->name);
+      } else if (auto* let = x->As<ir::Let>()) {
+        defined_vars.insert(let->symbol.as_var()->name);
+      } else if (auto* store = x->As<ir::Store>()) {
+        auto* tensor = store->tensor.As<ir::_Tensor_>();
+        CHECK(tensor);
+        stored_tensors.insert(tensor->name);
+        if (tensor->buffer.defined()) stored_tensors.insert(tensor->buffer->name);
+      } else if (auto* call = x->As<ir::Call>()) {
+        has_impure_call |= !IsPureCall(call);
+      }
+      return false;
+    });
+  }
+
+  /**
+   * Whether \p expr is invariant in the forloop.
+   * @param may_fault Set if \p expr loads or divides.
+   */
+  bool IsInvariant(const Expr& expr, bool* may_fault) const {
+    switch (expr.node_type()) {
+      case ir::IrNodeTy::IntImm:
+      case ir::IrNodeTy::UIntImm:
+      case ir::IrNodeTy::FloatImm:
+        return true;
+      case ir::IrNodeTy::_Var_:
+        return !defined_vars.count(expr.as_var()->name);
+      case ir::IrNodeTy::Load: {
+        auto* load   = expr.As<ir::Load>();
+        auto* tensor = load->tensor.As<ir::_Tensor_>();
+        if (has_impure_call || !tensor || stored_tensors.count(tensor->name) ||
+            (tensor->buffer.defined() && stored_tensors.count(tensor->buffer->name))) {
+          return false;
+        }
+        *may_fault = true;
+        for (auto& index : load->indices) {
+          if (!IsInvariant(index, may_fault)) return false;
+        }
+        return true;
+      }
+      case ir::IrNodeTy::Call:
+        if (!IsPureCall(expr.As<ir::Call>())) return false;
+        break;
+      case ir::IrNodeTy::Div:
+      case ir::IrNodeTy::Mod:
+        *may_fault = true;
+        break;
+      case ir::IrNodeTy::Add:
+      case ir::IrNodeTy::Sub:
+      case ir::IrNodeTy::Mul:
+      case ir::IrNodeTy::EQ:
+      case ir::IrNodeTy::NE:
+      case ir::IrNodeTy::LT:
+      case ir::IrNodeTy::LE:
+      case ir::IrNodeTy::GT:
+      case ir::IrNodeTy::GE:
+      case ir::IrNodeTy::And:
+      case ir::IrNodeTy::Or:
+      case ir::IrNodeTy::Min:
+      case ir::IrNodeTy::Max:
+      case ir::IrNodeTy::Minus:
+      case ir::IrNodeTy::Not:
+      case ir::IrNodeTy::Cast:
+      case ir::IrNodeTy::Select:
+        break;
+      default:
+        return false;
+    }
+    for (auto* field : expr->expr_fields()) {
+      if (!IsInvariant(*field, may_fault)) return false;
+    }
+    return true;
+  }
+};
+
+//! Whether hoisting \p expr saves any computation, the variables and the immediates are not worth a Let.
+bool WorthHoisting(const Expr& expr) {
+  if (!expr.type().valid() || expr.type().lanes() != 1 || expr.type().is_cpp_handle()) return false;
+  if (expr.is_constant() || expr.As<ir::_Var_>()) return false;
+  if (auto* cast = expr.As<ir::Cast>()) return WorthHoisting(cast->v());
+  return true;
+}
+
+/**
+ * Replace the invariant expressions in the body of a forloop with the variables of the Lets to insert before it. The
+ * nested forloops are already processed, only their ranges are evaluated in each iteration of this forloop.
+ */
+struct InvariantHoister {
+  explicit InvariantHoister(const LoopInfo& info) : info_(info) {}
+
+  //! The Lets of the invariant expressions, in the order of definition.
+  std::vector<Expr> lets;
+
+  void operator()(Expr* body) {
+    auto* block = body->As<ir::Block>();
+    if (!block) {
+      Process(body);
+      return;
+    }
+    std::vector<Expr> stmts;
+    for (auto& stmt : block->stmts) {
+      // an invariant Let evaluated in every iteration is moved out as a whole
+      auto* let      = stmt.As<ir::Let>();
+      bool may_fault = false;
+      if (let && let->body.defined() && info_.IsInvariant(let->body, &may_fault) && (!may_fault || info_.runs)) {
+        lets.push_back(stmt);
+        info_.defined_vars.erase(let->symbol.as_var()->name);
+        continue;
+      }
+      Process(&stmt);
+      stmts.push_back(stmt);
+    }
+    block->stmts = stmts;
+  }
+
+ private:
+  //! Replace the largest invariant subexpressions of \p expr.
+  void Process(Expr* expr) {
+    if (!expr->defined() || expr->As<ir::_Tensor_>() || expr->As<ir::_Buffer_>()) return;
+    bool may_fault = false;
+    if (WorthHoisting(*expr) && info_.IsInvariant(*expr, &may_fault) && (!may_fault || (info_.runs && !guarded_))) {
+      *expr = GetVar(*expr);
+      return;
+    }
+
+    switch (expr->node_type()) {
+      case ir::IrNodeTy::For: {
+        auto* node = expr->As<ir::For>();
+        Process(&node->min);
+        Process(&node->extent);
+        break;
+      }
+      case ir::IrNodeTy::PolyFor:
+        Process(&expr->As<ir::PolyFor>()->init);
+        break;
+      case ir::IrNodeTy::IfThenElse: {
+        auto* node = expr->As<ir::IfThenElse>();
+        Process(&node->condition);
+        guarded_++;
+        Process(&node->true_case);
+        Process(&node->false_case);
+        guarded_--;
+        break;
+      }
+      case ir::IrNodeTy::Select: {
+        auto* node = expr->As<ir::Select>();
+        Process(&node->condition);
+        guarded_++;
+        Process(&node->true_value);
+        Process(&node->false_value);
+        guarded_--;
+        break;
+      }
+      case ir::IrNodeTy::Let:
+        Process(&expr->As<ir::Let>()->body);
+        break;
+      case ir::IrNodeTy::Load:
+        for (auto& index : expr->As<ir::Load>()->indices) Process(&index);
+        break;
+      case ir::IrNodeTy::Store: {
+        auto* node = expr->As<ir::Store>();
+        Process(&node->value);
+        for (auto& index : node->indices) Process(&index);
+        break;
+      }
+      default:
+        for (auto* field : (*expr)->expr_fields()) Process(field);
+    }
+  }
+
+  //! The variable of the Let of \p expr, the same expressions share a Let.
+  Var GetVar(const Expr& expr) {
+    auto key = utils::GetStreamCnt(expr.type()) + ":" + utils::GetStreamCnt(expr);
+    auto it  = vars_.find(key);
+    if (it != vars_.end()) return it->second;
+    Var var(common::UniqName("loop_inv"), expr.type());
+    lets.push_back(ir::Let::Make(var, expr));
+    vars_.emplace(key, var);
+    return var;
+  }
+
+  LoopInfo info_;
+  absl::flat_hash_map<std::string, Var> vars_;
+  //! The depth of the conditions the current expression is evaluated under.
+  int guarded_{0};
+};
+
+struct LoopInvariantCodeMotionMutator : public ir::IRMutator<Expr*> {
+  void operator()(Expr* expr) {
+    WrapForloopInBlock(expr);
+    ir::IRMutator<>::Visit(expr, expr);
+  }
+
+  void Visit(const ir::Block* op, Expr* expr) override {
+    auto* node = expr->As<ir::Block>();
+    std::vector<Expr> stmts;
+    for (auto& stmt : node->stmts) {
+      // the inner forloops first, so their invariants can be hoisted further
+      ir::IRMutator<>::Visit(&stmt, &stmt);
+      // the PolyFors are mostly transformed to Fors before, but the IR not optimized may still have them
+      auto* for_      = stmt.As<ir::For>();
+      auto* poly_for = stmt.As<ir::PolyFor>();
+      if (for_ && for_->is_serial()) {
+        Hoist(LoopInfo(for_), for_->loop_var->name, &for_->body, &stmts);
+      } else if (poly_for && poly_for->is_serial()) {
+        Hoist(LoopInfo(poly_for), poly_for->iterator->name, &poly_for->body, &stmts);
+      }
+      stmts.push_back(stmt);
+    }
+    node->stmts = stmts;
+  }
+
+  void Hoist(const LoopInfo& info, const std::string& loop_var, Expr* body, std::vector<Expr>* stmts) {
+    InvariantHoister hoister{info};
+    hoister(body);
+    if (!hoister.lets.empty()) {
+      VLOG(4) << "hoist " << hoister.lets.size() << " invariants out of forloop " << loop_var;
+    }
+    stmts->insert(stmts->end(), hoister.lets.begin(), hoister.lets.end());
+  }
+
+  void Visit(const ir::_LoweredFunc_* op, Expr* expr) override {
+    auto* node = expr->As<ir::_LoweredFunc_>();
+    WrapForloopInBlock(&node->body);
+    ir::IRMutator<>::Visit(&node->body, &node->body);
+  }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    auto* node = expr->As<ir::For>();
+    WrapForloopInBlock(&node->body);
+    ir::IRMutator<>::Visit(&node->body, &node->body);
+  }
+
+  void Visit(const ir::PolyFor* op, Expr* expr) override {
+    auto* node = expr->As<ir::PolyFor>();
+    WrapForloopInBlock(&node->body);
+    ir::IRMutator<>::Visit(&node->body, &node->body);
+  }
+
+  void Visit(const ir::IfThenElse* op, Expr* expr) override {
+    auto* node = expr->As<ir::IfThenElse>();
+    WrapForloopInBlock(&node->true_case);
+    WrapForloopInBlock(&node->false_case);
+    ir::IRMutator<>::Visit(&node->true_case, &node->true_case);
+    if (node->false_case.defined()) ir::IRMutator<>::Visit(&node->false_case, &node->false_case);
+  }
+};
+
+}  // namespace
+
+void LoopInvariantCodeMotion(Expr* expr) {
+  LoopInvariantCodeMotionMutator mutator;
+  mutator(expr);
+}
+
+}  // namespace optim
+}  // namespace cinn
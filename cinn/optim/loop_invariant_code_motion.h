@@ -0,0 +1,32 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Hoist the loop invariant expressions out of the serial forloops into the Lets right before the forloops, e.g. the
+ * index arithmetic of the outer loops and the loads of the broadcast operands.
+ *
+ * An expression is invariant in a forloop if it uses neither the loop variable nor the variables defined in the loop,
+ * and it loads no tensor or buffer stored in the loop. The loads and the divisions, which may fault, are only hoisted
+ * if they are evaluated in every iteration of a forloop known to run.
+ */
+void LoopInvariantCodeMotion(Expr* expr);
+
+}  // namespace optim
+}  // namespace cinn
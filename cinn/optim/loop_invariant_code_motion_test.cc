@@ -0,0 +1,224 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/loop_invariant_code_motion.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+
+#include "cinn/backends/codegen_c_x86.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/cinn.h"
+#include "cinn/common/context.h"
+#include "cinn/common/ir_util.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/lang/placeholder.h"
+#include "cinn/optim/strength_reduction.h"
+
+namespace cinn {
+namespace optim {
+
+using lang::Placeholder;
+
+Expr MakeFor(Var loop_var, int extent, Expr body) {
+  return ir::For::Make(loop_var,
+                       common::make_const(0),
+                       common::make_const(extent),
+                       ir::ForType::Serial,
+                       ir::DeviceAPI::Host,
+                       ir::Block::Make({body}));
+}
+
+int CountNodes(Expr expr, std::function<bool(const Expr*)>&& teller) {
+  return ir::CollectIRNodes(expr, std::move(teller)).size();
+}
+
+TEST(LoopInvariantCodeMotion, hoist_load_and_index) {
+  Placeholder<float> A("A", std::vector<int>{32, 16});
+  Placeholder<float> bias("bias", std::vector<int>{32});
+  Placeholder<float> C("C", std::vector<int>{512});
+  Var i("i"), j("j");
+
+  // C[i * 16 + j] = A[i, j] * bias[i]
+  Expr store = ir::Store::Make(
+      ir::Tensor(C),
+      ir::Mul::Make(ir::Load::Make(ir::Tensor(A), {Expr(i), Expr(j)}), ir::Load::Make(ir::Tensor(bias), {Expr(i)})),
+      {ir::Add::Make(ir::Mul::Make(Expr(i), Expr(16)), Expr(j))});
+  Expr e = ir::Block::Make({MakeFor(i, 32, MakeFor(j, 16, store))});
+
+  LoopInvariantCodeMotion(&e);
+  LOG(INFO) << "\n" << e;
+
+  // bias[i] and i * 16 are computed once per i
+  auto* inner = ir::CollectIRNodes(e, [&](const Expr* x) {
+                  return x->As<ir::For>() && x->As<ir::For>()->loop_var->name == "j";
+                }).begin()->As<ir::For>();
+  auto loads_bias = [](const Expr* x) { return x->As<ir::Load>() && x->As<ir::Load>()->name() == "bias"; };
+  EXPECT_EQ(CountNodes(inner->body, loads_bias), 0);
+  EXPECT_EQ(CountNodes(inner->body, [](const Expr* x) { return x->As<ir::Mul>() && x->type().is_int(); }), 0);
+  EXPECT_EQ(CountNodes(e, [](const Expr* x) { return x->As<ir::Let>(); }), 2);
+}
+
+TEST(LoopInvariantCodeMotion, keep_stored_and_guarded) {
+  Placeholder<float> A("A", std::vector<int>{32});
+  Placeholder<float> B("B", std::vector<int>{16});
+  Placeholder<float> D("D", std::vector<int>{32});
+  Var i("i"), j("j");
+
+  // A[i] = A[i] + B[j], A[i] is written in the loop of j
+  Expr accumulate = ir::Store::Make(
+      ir::Tensor(A),
+      ir::Add::Make(ir::Load::Make(ir::Tensor(A), {Expr(i)}), ir::Load::Make(ir::Tensor(B), {Expr(j)})),
+      {Expr(i)});
+  // if (j > 8) B[j] = D[i], D[i] may be out of bound when not guarded
+  Expr guarded = ir::IfThenElse::Make(
+      ir::GT::Make(Expr(j), Expr(8)),
+      ir::Store::Make(ir::Tensor(B), ir::Load::Make(ir::Tensor(D), {Expr(i)}), {Expr(j)}));
+  Expr e = ir::Block::Make({MakeFor(i, 32, MakeFor(j, 16, ir::Block::Make({accumulate, guarded})))});
+
+  LoopInvariantCodeMotion(&e);
+  LOG(INFO) << "\n" << e;
+
+  EXPECT_EQ(CountNodes(e, [](const Expr* x) { return x->As<ir::Let>(); }), 0);
+}
+
+TEST(LoopInvariantCodeMotion, hoist_out_of_polyfor) {
+  Placeholder<float> A("A", std::vector<int>{32});
+  Placeholder<float> scale("scale", std::vector<int>{4});
+  Placeholder<float> C("C", std::vector<int>{128});
+  Var k("k"), i("i");
+
+  // for (i = 0; i < 32; i += 1) C[k * 32 + i] = A[i] * scale[k]
+  Expr store = ir::Store::Make(
+      ir::Tensor(C),
+      ir::Mul::Make(ir::Load::Make(ir::Tensor(A), {Expr(i)}), ir::Load::Make(ir::Tensor(scale), {Expr(k)})),
+      {ir::Add::Make(ir::Mul::Make(Expr(k), Expr(32)), Expr(i))});
+  Expr polyfor = ir::PolyFor::Make(i,
+                                   common::make_const(0),
+                                   ir::LT::Make(Expr(i), common::make_const(32)),
+                                   common::make_const(1),
+                                   ir::ForType::Serial,
+                                   ir::DeviceAPI::Host,
+                                   ir::Block::Make({store}));
+  Expr e = ir::Block::Make({MakeFor(k, 4, polyfor)});
+
+  LoopInvariantCodeMotion(&e);
+  LOG(INFO) << "\n" << e;
+
+  // scale[k] and k * 32 are computed once per k
+  auto polyfors = ir::CollectIRNodes(e, [](const Expr* x) { return x->As<ir::PolyFor>(); });
+  ASSERT_EQ(polyfors.size(), 1UL);
+  auto* inner      = polyfors.begin()->As<ir::PolyFor>();
+  auto loads_scale = [](const Expr* x) { return x->As<ir::Load>() && x->As<ir::Load>()->name() == "scale"; };
+  EXPECT_EQ(CountNodes(inner->body, loads_scale), 0);
+  EXPECT_EQ(CountNodes(inner->body, [](const Expr* x) { return x->As<ir::Mul>() && x->type().is_int(); }), 0);
+  EXPECT_EQ(CountNodes(e, [](const Expr* x) { return x->As<ir::Let>(); }), 2);
+}
+
+TEST(StrengthReduction, polyfor) {
+  Placeholder<float> A("A", std::vector<int>{64});
+  Var i("i"), j("j");
+
+  // A[i * 4 + j] = 1 for i in [0, 16), j in [0, 4)
+  Expr store = ir::Store::Make(ir::Tensor(A), Expr(1.f), {ir::Add::Make(ir::Mul::Make(Expr(i), Expr(4)), Expr(j))});
+  Expr e     = ir::Block::Make({MakeFor(i, 16, MakeFor(j, 4, store))});
+
+  LoopInvariantCodeMotion(&e);
+  StrengthReduction(&e);
+  LOG(INFO) << "\n" << e;
+
+  // i is only used as i * 4 after the motion, its loop steps by 4
+  auto polyfors = ir::CollectIRNodes(e, [](const Expr* x) { return x->As<ir::PolyFor>(); });
+  ASSERT_EQ(polyfors.size(), 1UL);
+  auto* polyfor = polyfors.begin()->As<ir::PolyFor>();
+  EXPECT_EQ(utils::GetStreamCnt(polyfor->inc), "4");
+  EXPECT_EQ(CountNodes(e, [](const Expr* x) { return x->As<ir::Mul>(); }), 0);
+  // j is not multiplied
+  EXPECT_EQ(CountNodes(e, [](const Expr* x) { return x->As<ir::For>(); }), 1);
+}
+
+// Lower a matmul split on the columns with the bias broadcast to each row, D[i, j] = sum_k(A[i, k] * B[k, j]) + bias[i]
+ir::Module LowerMatmulBias(bool optimize_loops) {
+  bool flag                             = FLAGS_cinn_loop_invariant_code_motion;
+  FLAGS_cinn_loop_invariant_code_motion = optimize_loops;
+  Expr M(32), N(24), K(16);
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+  Placeholder<float> bias("bias", {M});
+  Var k(K.as_int32(), "k0");
+  auto C = Compute(
+      {M, N}, [&](Var i, Var j) { return lang::ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+  auto D = Compute(
+      {M, N}, [&](Var i, Var j) { return C(i, j) + bias(i); }, "D");
+  auto stages = CreateStages({C, D});
+  stages[C]->Split(1, 8);
+  stages[D]->Split(1, 8);
+
+  Target target = common::DefaultHostTarget();
+  ir::Module::Builder builder("module_licm", target);
+  auto func = Lower("matmul_bias", stages, {A, B, bias, C, D});
+  LOG(INFO) << "loops " << (optimize_loops ? "optimized" : "not optimized") << ":\n" << func;
+  builder.AddFunction(func);
+  FLAGS_cinn_loop_invariant_code_motion = flag;
+  return builder.Build();
+}
+
+TEST(LoopInvariantCodeMotion, lowered_function) {
+  auto module     = LowerMatmulBias(true);
+  auto ref_module = LowerMatmulBias(false);
+
+  // the C code with the Lets and the PolyFors compiles as well
+  backends::CodeGenCX86 codegen(common::DefaultHostTarget(), backends::CodeGenCX86::Feature::AVX512);
+  codegen.SetInlineBuiltinCodes(false);
+  auto code = codegen.Compile(module, backends::CodeGenC::OutputKind::CImpl);
+  LOG(INFO) << "C code:\n" << code;
+  EXPECT_NE(code.find("loop_inv"), std::string::npos);
+  backends::CodeGenCX86 ref_codegen(common::DefaultHostTarget(), backends::CodeGenCX86::Feature::AVX512);
+  ref_codegen.SetInlineBuiltinCodes(false);
+  EXPECT_EQ(ref_codegen.Compile(ref_module, backends::CodeGenC::OutputKind::CImpl).find("loop_inv"),
+            std::string::npos);
+
+  // the JIT results are the same as the ones not optimized
+  auto* A_buf    = common::BufferBuilder(Float(32), {32, 16}).set_random().Build();
+  auto* B_buf    = common::BufferBuilder(Float(32), {16, 24}).set_random().Build();
+  auto* bias_buf = common::BufferBuilder(Float(32), {32}).set_random().Build();
+  auto run       = [&](const ir::Module& module) {
+    auto jit = backends::ExecutionEngine::Create({});
+    jit->Link(module);
+    auto fn = reinterpret_cast<void (*)(void*, int32_t)>(jit->Lookup("matmul_bias"));
+    CHECK(fn);
+    auto* C_buf = common::BufferBuilder(Float(32), {32, 24}).set_zero().Build();
+    auto* D_buf = common::BufferBuilder(Float(32), {32, 24}).set_zero().Build();
+    cinn_pod_value_t args[] = {cinn_pod_value_t(A_buf),
+                               cinn_pod_value_t(B_buf),
+                               cinn_pod_value_t(bias_buf),
+                               cinn_pod_value_t(C_buf),
+                               cinn_pod_value_t(D_buf)};
+    fn(args, 5);
+    auto* data = reinterpret_cast<float*>(D_buf->memory);
+    return std::vector<float>(data, data + 32 * 24);
+  };
+  auto res      = run(module);
+  auto expected = run(ref_module);
+  for (int i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(res[i], expected[i], 1e-5) << "differs at " << i;
+  }
+}
+
+}  // namespace optim
+}  // namespace cinn
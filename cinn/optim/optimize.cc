@@ -14,6 +14,7 @@
 
 #include "cinn/optim/optimize.h"
 
+#include "cinn/common/context.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/optim/call_arg_list_to_pod_value.h"
 #include "cinn/optim/cast_bool_to_int8.h"
@@ -26,10 +27,12 @@
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/lower_function_call_bind_vars.h"
+#include "cinn/optim/loop_invariant_code_motion.h"
 #include "cinn/optim/lower_intrin.h"
 #include "cinn/optim/map_extern_call.h"
 #include "cinn/optim/remove_nested_block.h"
 #include "cinn/optim/replace_const_param_to_integer.h"
+#include "cinn/optim/strength_reduction.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 #include "cinn/optim/transform_polyfor_to_for.h"
 #include "cinn/optim/unroll_loops.h"
@@ -63,6 +66,12 @@ Expr Optimize(Expr e, Target target, bool runtime_debug_info) {
   Simplify(&copied);
   IfSimplify(&copied);
 
+  if (FLAGS_cinn_loop_invariant_code_motion) {
+    LoopInvariantCodeMotion(&copied);
+    // the PolyFors are only generated for the host, the device codes keep the forloops
+    if (target.arch == Target::Arch::X86) StrengthReduction(&copied);
+  }
+
   if (runtime_debug_info) {
     LOG(WARNING) << "Turn on runtime debug information output";
     InsertDebugLogCallee(&copied);
@@ -0,0 +1,116 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/strength_reduction.h"
+
+#include <string>
+
+#include "cinn/common/context.h"
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/optim/ir_simplify.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+/**
+ * Replace the products of the loop variable and a constant with the induction variable, it fails if the loop variable
+ * is used otherwise or multiplied by different constants.
+ */
+struct InductionVarReplacer : public ir::IRMutator<Expr*> {
+  explicit InductionVarReplacer(const Var& loop_var) : loop_var_(loop_var) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  bool succeeded() const { return !failed_ && stride_ > 0; }
+  int64_t stride() const { return stride_; }
+  const Var& induction_var() const { return induction_var_; }
+
+  void Visit(const ir::Mul* op, Expr* expr) override {
+    int64_t factor = Factor(op);
+    if (factor <= 1) {
+      ir::IRMutator<>::Visit(op, expr);
+      return;
+    }
+    if (stride_ == 0) {
+      stride_        = factor;
+      induction_var_ = Var(common::UniqName(loop_var_->name + "_" + std::to_string(factor)), loop_var_->type());
+    }
+    if (factor != stride_) {
+      failed_ = true;
+      return;
+    }
+    *expr = Expr(induction_var_);
+  }
+
+  void Visit(const ir::_Var_* op, Expr* expr) override {
+    if (op->name == loop_var_->name) failed_ = true;
+  }
+
+ private:
+  //! The constant \p op multiplies the loop variable by, 0 if it is not such a product.
+  int64_t Factor(const ir::Mul* op) const {
+    auto is_loop_var = [&](const Expr& x) { return x.As<ir::_Var_>() && x.as_var()->name == loop_var_->name; };
+    const ir::IntImm* factor{};
+    if (is_loop_var(op->a())) factor = op->b().As<ir::IntImm>();
+    if (is_loop_var(op->b())) factor = op->a().As<ir::IntImm>();
+    return factor ? factor->value : 0;
+  }
+
+  Var loop_var_;
+  Var induction_var_;
+  int64_t stride_{0};
+  bool failed_{false};
+};
+
+struct StrengthReductionMutator : public ir::IRMutator<Expr*> {
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    // the inner forloops first
+    ir::IRMutator<>::Visit(op, expr);
+
+    auto* node = expr->As<ir::For>();
+    if (!node->is_serial() || !node->loop_var->type().is_int()) return;
+
+    Expr body = IRCopy(node->body);
+    InductionVarReplacer replacer(node->loop_var);
+    replacer(&body);
+    if (!replacer.succeeded()) return;
+
+    VLOG(4) << "reduce the strength of forloop " << node->loop_var->name << " by stride " << replacer.stride();
+    Var var     = replacer.induction_var();
+    Expr stride = common::make_const(var->type(), replacer.stride());
+    Expr init   = ir::Mul::Make(node->min, stride);
+    Expr end    = ir::Mul::Make(node->extent, stride);
+    Simplify(&init);
+    Simplify(&end);
+    *expr = ir::PolyFor::Make(
+        var, init, ir::LT::Make(var, end), stride, node->for_type(), node->device_api, body, node->vectorize_info());
+  }
+};
+
+}  // namespace
+
+void StrengthReduction(Expr* expr) {
+  StrengthReductionMutator mutator;
+  mutator(expr);
+}
+
+}  // namespace optim
+}  // namespace cinn
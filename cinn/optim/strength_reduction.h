@@ -0,0 +1,31 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Reduce the multiplications of the loop variables to the increments of the induction variables. A serial forloop
+ * whose variable is only used multiplied by the same constant, e.g. the outer loop of a split after
+ * LoopInvariantCodeMotion, is rewritten to a PolyFor stepping by the constant:
+ *
+ *   for (i, 0, 16) { A[i * 4] }  =>  for (i_4 = 0; i_4 < 64; i_4 += 4) { A[i_4] }
+ */
+void StrengthReduction(Expr* expr);
+
+}  // namespace optim
+}  // namespace cinn
@@ -16,10 +16,15 @@
 
 #include <llvm/Support/FormatVariadic.h>
 
+#include <absl/container/flat_hash_map.h>
+
+#include <mutex>
 #include <utility>
 
 #include "cinn/common/common.h"
+#include "cinn/common/context.h"
 #include "cinn/ir/ir.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace poly {
@@ -56,6 +61,8 @@ struct AstGen::Impl {
   std::vector<std::string> iterator_names_;
   //! tuple name -> { axis -> isl_ast }
   std::map<std::string, std::map<std::string, isl::ast_expr>> transformed_indice_map_;
+  //! tuple name -> the name of the statement in the AST
+  std::map<std::string, std::string> statement_names_;
   isl::union_map build_options_;
 
   friend class AstGen;
@@ -132,6 +139,50 @@ isl::union_set TransIdentityExtentToContextId(isl::union_set set) {
   return isl_union_set_from_sets(sets);
 }
 
+namespace {
+
+/**
+ * The ASTs built in the global isl context, keyed by the context, the iterator names and the schedule on the domains
+ * with the statements named by the order of the stages. The elementwise and broadcast groups of the same shapes differ
+ * only in the names of their stages, so they share the AST and skip the AST generation of isl.
+ */
+class AstCache {
+ public:
+  struct Entry {
+    isl::ast_node ast;
+    //! statement name -> { axis -> isl_ast }
+    std::map<std::string, std::map<std::string, isl::ast_expr>> indice_map;
+  };
+
+  static AstCache& Global() {
+    // leaked for the isl objects should not outlive the isl context
+    static auto* x = new AstCache;
+    return *x;
+  }
+
+  bool Get(const std::string& key, Entry* entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    *entry = it->second;
+    return true;
+  }
+
+  void Put(const std::string& key, const Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() >= kMaxSize) entries_.clear();
+    entries_.emplace(key, entry);
+  }
+
+ private:
+  static constexpr size_t kMaxSize = 4096;
+
+  std::mutex mutex_;
+  absl::flat_hash_map<std::string, Entry> entries_;
+};
+
+}  // namespace
+
 isl::ast_node AstGen::Build() {
   // Collect schedule from scheduler.
   auto schedule_map = CollectScheduleMapFromGroup(impl_->schedule_group_);
@@ -143,16 +194,54 @@ isl::ast_node AstGen::Build() {
   }
   auto schedule = isl_maps_to_union_map(maps);
 
+  // Name the statements by the order of the stages, so the AST does not depend on the names of the stages.
+  std::vector<isl::map> transforms;
+  std::vector<isl::set> domains;
+  std::map<std::string, isl::set> statement_domains;
+  impl_->statement_names_.clear();
+  for (int i = 0; i < impl_->stages_.size(); i++) {
+    auto& stage                          = impl_->stages_[i];
+    std::string name                     = kIslStatementPrefix + std::to_string(i);
+    impl_->statement_names_[stage->id()] = name;
+    statement_domains[name]              = stage->domain();
+    transforms.push_back(isl::manage(isl_map_set_tuple_name(stage->transform().copy(), isl_dim_in, name.c_str())));
+    domains.push_back(isl::manage(isl_set_set_tuple_name(stage->domain().copy(), name.c_str())));
+  }
+
+  // Set iterators names for readable code.
+  auto iterator_names =
+      impl_->iterator_names_.empty() ? impl_->schedule_group_.dimension_names : impl_->iterator_names_;
+  iterator_names = SchedulerBase::WrapIteratorNames(iterator_names);
+
+  isl::union_map transformed_schedule = isl_maps_to_union_map(transforms).apply_range(schedule);
+  VLOG(4) << "transformed_schedule: " << transformed_schedule;
+  auto schedule_domain = transformed_schedule.intersect_domain(isl_sets_to_union_set(domains));
+  VLOG(4) << "domain: " << impl_->domain();
+  VLOG(4) << "transform schedule " << impl_->stages()[0]->transform();
+  VLOG(4) << "schedule: " << schedule;
+  VLOG(4) << "schedule_domain: " << schedule_domain;
+
+  // The build options may refer to the names of the stages, the ASTs built with them are not cached. The cache lives in
+  // the isl ctx of the process, the ASTs of a CompileSession are not cached.
+  bool cacheable = impl_->build_options_.is_null() && ctx().get() == Context::Process().isl_ctx().get();
+  std::string key;
+  AstCache::Entry entry;
+  if (cacheable) {
+    key = utils::GetStreamCnt(impl_->context_) + "|" + utils::Join(iterator_names, ",") + "|" +
+          utils::GetStreamCnt(schedule_domain);
+    if (AstCache::Global().Get(key, &entry)) {
+      VLOG(3) << "Reuse the AST of the schedule: " << schedule_domain;
+      SetTransformedIndiceMap(entry.indice_map);
+      return entry.ast;
+    }
+  }
+
   // Build it.
   auto ast_build = isl::ast_build::from_context(impl_->context_);
 
   if (!impl_->build_options_.is_null())
     ast_build = isl::manage(isl_ast_build_set_options(ast_build.release(), impl_->build_options_.release()));
 
-  // Set iterators names for readable code.
-  auto iterator_names =
-      impl_->iterator_names_.empty() ? impl_->schedule_group_.dimension_names : impl_->iterator_names_;
-  iterator_names   = SchedulerBase::WrapIteratorNames(iterator_names);
   isl::id_list ids = isl::manage(isl_id_list_alloc(ctx().get(), iterator_names.size()));
   for (int i = 0; i < iterator_names.size(); i++) {
     ids = isl::manage(isl_id_list_add(ids.release(), isl_id_alloc(ctx().get(), iterator_names[i].c_str(), nullptr)));
@@ -160,34 +249,39 @@ isl::ast_node AstGen::Build() {
   ast_build = isl::manage(isl_ast_build_set_iterators(ast_build.release(), ids.release()));
 
   // collect iterator map
-  auto get_domain_by_name = [this](const std::string& name) -> isl::set {
-    auto ele_it = std::find_if(
-        impl_->stages_.begin(), impl_->stages_.end(), [&name](const Shared<Stage>& ele) { return ele->id() == name; });
-    CHECK(ele_it != std::end(impl_->stages_));
-    return (*ele_it)->domain();
-  };
-
   auto collect = [&](isl::ast_node node, isl::ast_build build) -> isl::ast_node {
-    auto tuple_name = detail::GetTupleName(node.get());
-    auto indice_map = impl_->ExtractIslTransformedIndiceMap(get_domain_by_name(tuple_name), build.get());
-    impl_->transformed_indice_map_[tuple_name] = indice_map;
+    auto statement = detail::GetTupleName(node.get());
+    CHECK(statement_domains.count(statement)) << "statement " << statement << " not found";
+    entry.indice_map[statement] = impl_->ExtractIslTransformedIndiceMap(statement_domains[statement], build.get());
     return node;
   };
 
   ast_build = ast_build.set_at_each_domain(collect);
 
-  isl::union_map transformed_schedule = impl_->transform().apply_range(schedule);
-  VLOG(4) << "transformed_schedule: " << transformed_schedule;
-  auto schedule_domain = transformed_schedule.intersect_domain(impl_->domain());
-  VLOG(4) << "domain: " << impl_->domain();
-  VLOG(4) << "transform schedule " << impl_->stages()[0]->transform();
-  VLOG(4) << "schedule: " << schedule;
-  VLOG(4) << "schedule_domain: " << schedule_domain;
   auto ast = ast_build.node_from_schedule_map(schedule_domain);
   VLOG(2) << "AST:\n" << isl_ast_node_to_C_str(ast.get());
+  SetTransformedIndiceMap(entry.indice_map);
+  if (cacheable) {
+    entry.ast = ast;
+    AstCache::Global().Put(key, entry);
+  }
   return ast;
 }
 
+void AstGen::SetTransformedIndiceMap(const std::map<std::string, std::map<std::string, isl::ast_expr>>& indice_map) {
+  impl_->transformed_indice_map_.clear();
+  for (auto& item : impl_->statement_names_) {
+    auto it = indice_map.find(item.second);
+    if (it != indice_map.end()) impl_->transformed_indice_map_[item.first] = it->second;
+  }
+}
+
+const std::string& AstGen::StatementName(const std::string& tuple_name) const {
+  auto it = impl_->statement_names_.find(tuple_name);
+  CHECK(it != impl_->statement_names_.end()) << "no id " << tuple_name;
+  return it->second;
+}
+
 AstGen& AstGen::SetIteratorNames(const std::vector<std::string>& names) {
   impl_->iterator_names_ = names;
   return *this;
@@ -409,7 +503,8 @@ void IslAstExprToCinnExpr(const isl::ast_expr& node, ir::Expr* expr) {
   switch (isl_ast_expr_get_type(node.get())) {
     case isl_ast_expr_int: {
       isl::val val = isl::manage(isl_ast_expr_get_val(node.get()));
-      *expr        = ir::Expr(static_cast<int>(isl_val_get_num_si(val.get())));
+      // not shared by hash-consing, for the type of it may be changed below
+      *expr = ir::Expr(common::make_shared<ir::IntImm>(Int(32), isl_val_get_num_si(val.get())));
     } break;
     case isl_ast_expr_id: {
       isl::id id = isl::manage(isl_ast_expr_get_id(node.get()));
@@ -34,6 +34,8 @@ namespace cinn {
 namespace poly {
 
 static const char* kIslParamConstPrefix = "_const_";
+//! The statements in the AST are named by the prefix and the order of their stages.
+static const char* kIslStatementPrefix = "_stmt_";
 
 /**
  * Generate IR from polyhedral schedule.
@@ -52,8 +54,16 @@ class AstGen {
 
   isl::ctx ctx() const;
 
+  /**
+   * Build the AST of the stages. The statements in the AST are named by the order of their stages rather than the
+   * names of the stages, so the groups differing only in the names share the AST built. Get the name of a statement in
+   * the AST by `StatementName`.
+   */
   isl::ast_node Build();
 
+  //! Get the name of the statement of the stage \p tuple_name in the AST built.
+  const std::string& StatementName(const std::string& tuple_name) const;
+
   //! Get the map from original CINN iterators to the transformed actual ISL ast nodes.
   const std::map<std::string, isl::ast_expr>& axis2ast(const std::string& tuple_name) const;
 
@@ -64,6 +74,9 @@ class AstGen {
   void SetBuildOptions(const isl::union_map& options);
 
  private:
+  //! Set the transformed indices of the stages by those of their statements in the AST.
+  void SetTransformedIndiceMap(const std::map<std::string, std::map<std::string, isl::ast_expr>>& indice_map);
+
   class Impl;
   std::unique_ptr<Impl> impl_;
 };
@@ -1206,6 +1206,86 @@ ir::Tensor Stage::CacheWrite(const std::string &memory_type, StageMap stages, ir
   return my_tensor;
 }
 
+ir::Tensor Stage::RFactor(int factor, int lanes, StageMap stages, ir::Tensor &key_tensor) {
+  CHECK(tensor_);
+  CHECK(tensor_->is_reduce_tensor()) << "RFactor only works on a reduce tensor, but " << tensor_->name << " is not";
+  CHECK(!tensor_->buffer.defined()) << "This tensor is already binded to a buffer, cannot rfactor";
+  CHECK(!meta.compute_inline) << "Cannot rfactor an inlined tensor";
+  CHECK_GE(factor, 1);
+  CHECK_GE(lanes, 1);
+  auto *reduce = tensor_->body().As<ir::Reduce>();
+  CHECK(reduce) << "The body of " << tensor_->name << " is not a reduce";
+  auto reduce_type   = reduce->reduce_type;
+  auto init          = reduce->init;
+  auto body          = reduce->body;
+  auto axis          = tensor_->axis();
+  auto reduce_axis   = tensor_->reduce_axis;
+  auto shape         = tensor_->shape;
+  auto original_name = tensor_->name;
+  auto ctrl_depend   = ctrl_depends_;
+
+  Var k = reduce_axis.back();
+  reduce_axis.pop_back();
+  CHECK(k->lower_bound.is_constant() && k->upper_bound.is_constant())
+      << "RFactor only supports the reduce axis with constant extent";
+  int extent = k->upper_bound.as_int32() - k->lower_bound.as_int32();
+  int chunk  = (extent + factor * lanes - 1) / (factor * lanes);
+  Var ko(chunk, Context::Global().NewName(k->name + "_o"));
+  reduce_axis.push_back(ko);
+
+  std::vector<Expr> rf_shape = shape;
+  rf_shape.push_back(Expr(factor));
+  rf_shape.push_back(Expr(lanes));
+  auto rf_tensor = lang::Compute(
+      rf_shape,
+      [=](const std::vector<Expr> &indices) {
+        int n         = indices.size();
+        Expr kp       = indices[n - 2];
+        Expr kv       = indices[n - 1];
+        Expr index    = (kp * chunk + ko) * lanes + kv;
+        Expr new_body = optim::IRCopy(body);
+        optim::ReplaceVarWithExpr(&new_body, k, index + k->lower_bound);
+        for (int i = 0; i < axis.size(); i++) {
+          optim::ReplaceVarWithExpr(&new_body, axis[i], indices[i]);
+        }
+        // the tail out of the reduce axis contributes the initial value
+        if (chunk * factor * lanes != extent) {
+          new_body = ir::Select::Make(index < extent, new_body, init);
+        }
+        return ir::Reduce::Make(reduce_type, init, new_body, reduce_axis);
+      },
+      original_name + "_rf");
+
+  Var rp(factor, Context::Global().NewName(original_name + "_rp"));
+  Var rv(lanes, Context::Global().NewName(original_name + "_rv"));
+  auto combine_tensor = lang::Compute(
+      shape,
+      [=](const std::vector<Expr> &indices) {
+        std::vector<Expr> rf_indices = indices;
+        rf_indices.push_back(rp);
+        rf_indices.push_back(rv);
+        return ir::Reduce::Make(reduce_type, init, rf_tensor(rf_indices), {rp, rv});
+      },
+      original_name);
+
+  // NOTE this stage is replaced by the combine tensor's stage with the same name, do not touch it afterwards.
+  stages->Insert(rf_tensor, CreateStage(rf_tensor).get());
+  stages[rf_tensor]->ctrl_depends_ = ctrl_depend;
+  stages->Insert(combine_tensor, CreateStage(combine_tensor).get());
+
+  std::vector<ir::Tensor> readers;
+  for (auto &i : stages) {
+    if (i.second->tensor()->name == original_name || i.second->tensor()->name == rf_tensor->name) continue;
+    if (i.second->tensor()->is_compute_node()) {
+      readers.push_back(ir::Tensor(i.second->tensor()));
+    }
+  }
+  CacheReadWriteReplace(readers, combine_tensor, original_name);
+
+  key_tensor = combine_tensor;
+  return rf_tensor;
+}
+
 void Stage::ComputeInline() {
   CHECK(tensor_);
   meta.compute_inline = true;
@@ -281,6 +281,23 @@ class Stage : public Object {
    */
   ir::Tensor CacheWrite(const std::string& memory_type, poly::StageMap stages, ir::Tensor& key_tensor);
 
+  /**
+   * \brief Factor the last reduce axis out of a reduce stage into a tensor of partial results(rfactor), so that the
+   * partial results can be computed in parallel and vectorized, and let the original tensor combine them.
+   *
+   * The last reduce axis k of extent N is split into k = (kp * chunk + ko) * lanes + kv, where chunk = ceil(N /
+   * (factor * lanes)), and the partial results keep kp and kv as the innermost axes:
+   *   T_rf[..., kp, kv] = reduce_{ko, other reduce axes}(body)
+   *   T[...]            = reduce_{kp, kv}(T_rf[..., kp, kv])
+   *
+   * @param factor the number of partial results computed in parallel.
+   * @param lanes the number of partial results computed in a vector.
+   * @param stages the stage map.
+   * @param key_tensor return the tensor combining the partial results, which replaces this stage's tensor.
+   * @return the tensor of the partial results.
+   */
+  ir::Tensor RFactor(int factor, int lanes, poly::StageMap stages, ir::Tensor& key_tensor);
+
   /**
    * Generate the `syncthreads()` code to sync all threads on CUDA backends.
    * For other backends like Opencl, generate corresponding code to sync multi threads.
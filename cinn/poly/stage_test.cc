@@ -510,6 +510,55 @@ TEST(ShareBufferWith, basic) {
   LOG(INFO) << "\n" << codegen.Compile(builder.Build(), backends::CodeGenC::OutputKind::CImpl);
 }
 
+TEST(RFactor, jit_precision_test) {
+  Expr M(2);
+  Expr N(1000);
+  Placeholder<float> A("A", {M, N});
+  Var k(N, "k0");
+
+  auto C = Compute(
+      {M}, [&](Var i) -> Expr { return ReduceSum(A(i, k), {k}); }, "C");
+
+  auto stages = CreateStages({C});
+
+  ir::Tensor D;
+  auto C_rf = stages[C]->RFactor(4, 8, stages, D);
+  ASSERT_EQ(D->name, "C");
+  ASSERT_EQ(C_rf->shape.size(), 3UL);
+  stages[C_rf]->Reorder({3, 2});
+  stages[C_rf]->Fuse(0, 1);
+  stages[C_rf]->Parallel(0);
+  stages[C_rf]->Vectorize(2, 8);
+
+  auto fn = Lower("fn", stages, {A, D});
+  LOG(INFO) << "fn:\n" << fn;
+
+  Module::Builder module_builder("some_module", common::DefaultHostTarget());
+  module_builder.AddFunction(fn);
+
+  auto jit = backends::SimpleJIT::Create();
+  jit->Link(module_builder.Build(), false);
+  auto _fn_handler = jit->Lookup("fn");
+  auto* fn_handler = reinterpret_cast<lower_func_ptr_t>(_fn_handler);
+
+  auto A_buf    = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_random().Build();
+  auto D_buf    = common::BufferBuilder(Float(32), {M.as_int32()}).set_zero().Build();
+  auto arg_pack = common::ArgsBuilder().Add(A_buf).Add(D_buf).Build();
+
+  fn_handler(arg_pack.data(), arg_pack.size());
+
+  auto* A_data = reinterpret_cast<float*>(A_buf->memory);
+  auto* D_data = reinterpret_cast<float*>(D_buf->memory);
+  for (int i = 0; i < M.as_int32(); i++) {
+    float sum = 0.f;
+    for (int j = 0; j < N.as_int32(); j++) sum += A_data[i * N.as_int32() + j];
+    ASSERT_NEAR(sum, D_data[i], 1e-3);
+  }
+
+  cinn_buffer_free(nullptr, A_buf);
+  cinn_buffer_free(nullptr, D_buf);
+}
+
 TEST(isl, test) {
   isl::ctx ctx(isl_ctx_alloc());
   isl::set domain(
@@ -14,12 +14,19 @@
 
 #pragma once
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "cinn/common/cinn_value.h"
 #include "cinn/common/shared.h"
+#include "cinn/hlir/framework/tensor.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_visitor.h"
@@ -165,4 +172,82 @@ class _Operation_Wrapper : ir::_Operation_ {
  public:
   const char *func_type() const override { PYBIND11_OVERLOAD_PURE(const char *, ir::_Operation_, func_type); }
 };
+
+//! The numpy dtype of a tensor, float32 if the tensor has no type yet.
+inline py::dtype DTypeOf(const hlir::framework::Tensor &tensor) {
+  const Type &type = tensor->type();
+  if (type.is_float(64)) return py::dtype::of<double>();
+  if (type.is_int(32)) return py::dtype::of<int32_t>();
+  if (type.is_int(64)) return py::dtype::of<int64_t>();
+  if (type.is_bool()) return py::dtype::of<bool>();
+  return py::dtype::of<float>();
+}
+
+/**
+ * The numpy arrays whose last reference in C++ is dropped by a thread not holding the GIL, such as the worker of
+ * Program::ExecuteAsync. Acquiring the GIL there may deadlock with a Python thread waiting for the worker, so they
+ * are released later by a thread calling into the bindings.
+ */
+class PendingArrays {
+ public:
+  static PendingArrays &Global() {
+    static PendingArrays *x = new PendingArrays;  // never destroyed, the arrays cannot be released after Python exits
+    return *x;
+  }
+
+  //! Release \p array now if the GIL is held by this thread, otherwise later on a thread holding it.
+  void Release(py::array *array) {
+    if (PyGILState_Check()) {
+      delete array;
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    arrays_.push_back(array);
+  }
+
+  //! Release the pending arrays, the GIL should be held by the calling thread.
+  void ReleaseAll() {
+    std::vector<py::array *> arrays;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      arrays.swap(arrays_);
+    }
+    for (auto *array : arrays) delete array;
+  }
+
+ private:
+  std::mutex mu_;
+  std::vector<py::array *> arrays_;
+};
+
+//! Keep a numpy array alive while its memory is referenced in C++, it is released on a thread holding the GIL.
+inline std::shared_ptr<void> HoldArray(py::array array) {
+  PendingArrays::Global().ReleaseAll();
+  return std::shared_ptr<void>(new py::array(std::move(array)),
+                               [](void *x) { PendingArrays::Global().Release(static_cast<py::array *>(x)); });
+}
+
+/**
+ * Feed a numpy array to a tensor on X86. The tensor references the memory of the array directly if the array is
+ * C-contiguous and aligned as the tensor requires, otherwise a copy of the array.
+ * @return whether the memory of the array is shared.
+ */
+inline bool FeedArrayX86(hlir::framework::Tensor tensor, py::array array) {
+  auto dtype = DTypeOf(tensor);
+  CHECK(array.dtype().is(dtype)) << "The dtype of the array does not match the tensor";
+  CHECK_EQ(array.size(), tensor->shape().numel()) << "The size of the array does not match the tensor";
+  Type type        = tensor->type().valid() ? tensor->type() : Float(32);
+  size_t alignment = type.ElementOf().bits();
+  if ((array.flags() & py::array::c_style) && reinterpret_cast<uintptr_t>(array.data()) % alignment == 0) {
+    tensor->ShareExternalData(const_cast<void *>(array.data()), type, common::DefaultHostTarget(), HoldArray(array));
+    return true;
+  }
+  // the tensor may still reference an array fed before, so copy to memory of its own
+  py::array contiguous = py::array::ensure(array, py::array::c_style);
+  std::shared_ptr<void> staging(
+      std::aligned_alloc(alignment, (contiguous.nbytes() + alignment - 1) / alignment * alignment), std::free);
+  std::memcpy(staging.get(), contiguous.data(), contiguous.nbytes());
+  tensor->ShareExternalData(staging.get(), type, common::DefaultHostTarget(), staging);
+  return false;
+}
 }  // namespace cinn::pybind
@@ -125,14 +125,13 @@ void BindFramework(pybind11::module *m) {
       .def("set_type", [](hlir::framework::Tensor &self, Type type) { self->set_type(type); })
       .def("numpy",
            [](hlir::framework::Tensor &self, const common::Target &target) {
-             py::dtype dt;
-             // set float by default
-             dt = py::dtype::of<float>();
+             // float32 if the tensor has no type
+             py::dtype dt = DTypeOf(self);
              py::array::ShapeContainer shape(self->shape().data().begin(), self->shape().data().end());
              py::array array(std::move(dt), std::move(shape));
              void *array_data = array.mutable_data();
              if (target.arch == Target::Arch::X86) {
-               std::memcpy(array_data, self->data<float>(), self->shape().numel() * sizeof(float));
+               std::memcpy(array_data, self->buffer()->memory, array.nbytes());
              } else if (target.arch == Target::Arch::NVGPU) {
 #ifdef CINN_WITH_CUDA
                CUDA_CALL(cudaMemcpy(array_data,
@@ -155,9 +154,8 @@ void BindFramework(pybind11::module *m) {
                  self->shape().numel());
         auto *data = self->mutable_data<float>(target);
         if (target.arch == Target::Arch::X86) {
-          for (int i = 0; i < self->shape().numel(); i++) {
-            data[i] = reinterpret_cast<const float *>(array.data())[i];
-          }
+          py::array contiguous = py::array::ensure(array, py::array::c_style);
+          std::memcpy(data, contiguous.data(), self->shape().numel() * sizeof(float));
         } else if (target.arch == Target::Arch::NVGPU) {
 #ifdef CINN_WITH_CUDA
           CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
@@ -170,6 +168,27 @@ void BindFramework(pybind11::module *m) {
         } else {
           CINN_NOT_IMPLEMENTED
         }
-      });
+      })
+      .def(
+          "share_numpy",
+          [](hlir::framework::Tensor &self, py::array array, const common::Target &target) {
+            CHECK(target.arch == Target::Arch::X86) << "Only X86 tensors can share the memory of a numpy array";
+            return FeedArrayX86(self, array);
+          },
+          "Reference the memory of a numpy array without copying if it is contiguous and aligned, otherwise copy it. "
+          "Returns whether the memory is shared. The tensor should not be resized larger while sharing the memory, "
+          "share the array again instead.")
+      .def(
+          "numpy_view",
+          [](hlir::framework::Tensor &self, const common::Target &target) {
+            CHECK(target.arch == Target::Arch::X86) << "Only X86 tensors can be viewed as a numpy array";
+            CHECK(self->buffer()->memory) << "The tensor has no memory to view";
+            py::array::ShapeContainer shape(self->shape().data().begin(), self->shape().data().end());
+            // The capsule keeps the tensor, and so its buffer, alive as long as the array.
+            auto *holder = new hlir::framework::Tensor(self);
+            py::capsule base(holder, [](void *x) { delete static_cast<hlir::framework::Tensor *>(x); });
+            return py::array(DTypeOf(self), std::move(shape), self->buffer()->memory, base);
+          },
+          "A numpy array referencing the memory of the tensor without copying.");
 }
 }  // namespace cinn::pybind
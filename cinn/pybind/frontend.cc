@@ -134,12 +134,12 @@ void BindFrontend(pybind11::module *m) {
              auto program = gc.Build();
              for (size_t i = 0; i < tensor_inputs.size(); i++) {
                auto in_tensor = scope->GetTensor(tensor_inputs[i]->id);
-               auto *data     = in_tensor->mutable_data<float>(target);
                CHECK_EQ(input_data[i].size(), in_tensor->shape().numel())
                    << "The size of tensor [" << tensor_inputs[i]->id
                    << "] is different with the input data's size! Please check.";
                if (target.arch == Target::Arch::NVGPU) {
 #ifdef CINN_WITH_CUDA
+                 auto *data = in_tensor->mutable_data<float>(target);
                  CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
                                       input_data[i].data(),
                                       in_tensor->shape().numel() * sizeof(float),
@@ -148,9 +148,7 @@ void BindFrontend(pybind11::module *m) {
                  LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
 #endif
                } else if (target.arch == Target::Arch::X86) {
-                 for (size_t j = 0; j < in_tensor->shape().numel(); j++) {
-                   data[j] = reinterpret_cast<const float *>(input_data[i].data())[j];  // All random data
-                 }
+                 FeedArrayX86(in_tensor, input_data[i]);
                } else {
                  CINN_NOT_IMPLEMENTED
                }
@@ -192,12 +190,12 @@ void BindFrontend(pybind11::module *m) {
              auto program = gc.Build();
              for (size_t i = 0; i < tensor_inputs.size(); i++) {
                auto in_tensor = scope->GetTensor(tensor_inputs[i]->id);
-               auto *data     = in_tensor->mutable_data<float>(target);
                CHECK_EQ(input_data[i].size(), in_tensor->shape().numel())
                    << "The size of tensor [" << tensor_inputs[i]->id
                    << "] is different with the input data's size! Please check.";
                if (target.arch == Target::Arch::NVGPU) {
 #ifdef CINN_WITH_CUDA
+                 auto *data = in_tensor->mutable_data<float>(target);
                  CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
                                       input_data[i].data(),
                                       in_tensor->shape().numel() * sizeof(float),
@@ -206,9 +204,7 @@ void BindFrontend(pybind11::module *m) {
                  LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
 #endif
                } else if (target.arch == Target::Arch::X86) {
-                 for (size_t j = 0; j < in_tensor->shape().numel(); j++) {
-                   data[j] = reinterpret_cast<const float *>(input_data[i].data())[j];  // All random data
-                 }
+                 FeedArrayX86(in_tensor, input_data[i]);
                } else {
                  CINN_NOT_IMPLEMENTED
                }
@@ -234,12 +230,12 @@ void BindFrontend(pybind11::module *m) {
              auto program = gc.Build(code);
              for (size_t i = 0; i < tensor_inputs.size(); i++) {
                auto in_tensor = scope->GetTensor(tensor_inputs[i]->id);
-               auto *data     = in_tensor->mutable_data<float>(target);
                CHECK_EQ(input_data[i].size(), in_tensor->shape().numel())
                    << "The size of tensor [" << tensor_inputs[i]->id
                    << "] is different with the input data's size! Please check.";
                if (target.arch == Target::Arch::NVGPU) {
 #ifdef CINN_WITH_CUDA
+                 auto *data = in_tensor->mutable_data<float>(target);
                  CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
                                       input_data[i].data(),
                                       in_tensor->shape().numel() * sizeof(float),
@@ -248,9 +244,7 @@ void BindFrontend(pybind11::module *m) {
                  LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
 #endif
                } else if (target.arch == Target::Arch::X86) {
-                 for (size_t j = 0; j < in_tensor->shape().numel(); j++) {
-                   data[j] = reinterpret_cast<const float *>(input_data[i].data())[j];  // All random data
-                 }
+                 FeedArrayX86(in_tensor, input_data[i]);
                } else {
                  CINN_NOT_IMPLEMENTED
                }
@@ -278,7 +272,43 @@ void BindFrontend(pybind11::module *m) {
            py::arg("input_names"),
            py::arg("input_shapes"))  //
       .def("load_paddle_model", &frontend::Interpreter::LoadPaddleModel)
-      .def("run", &frontend::Interpreter::Run)
+      .def("save_compiled_model", &frontend::Interpreter::SaveCompiledModel)
+      .def("load_compiled_model", &frontend::Interpreter::LoadCompiledModel)
+      .def(
+          "bind_input",
+          [](frontend::Interpreter &self, const std::string &name, py::array array) {
+            CHECK(array.flags() & py::array::c_style) << "The array bound to input [" << name
+                                                      << "] should be C-contiguous";
+            self.BindInput(name, array.mutable_data(), array.nbytes(), HoldArray(array));
+          },
+          py::arg("name"),
+          py::arg("array"),
+          "Let the input read from the memory of a numpy array at every run. The array should keep its shape while "
+          "bound, bind it again after resizing the input.")
+      .def(
+          "bind_output",
+          [](frontend::Interpreter &self, const std::string &name, py::array array) {
+            CHECK(array.flags() & py::array::c_style) << "The array bound to output [" << name
+                                                      << "] should be C-contiguous";
+            self.BindOutput(name, array.mutable_data(), array.nbytes(), HoldArray(array));
+          },
+          py::arg("name"),
+          py::arg("array"),
+          "Let the output be written to the memory of a numpy array at every run. The array should keep its shape "
+          "while bound, bind it again after resizing the output.")
+      .def(
+          "run",
+          [](frontend::Interpreter &self) {
+            {
+              // the bound arrays are held by the interpreter, so the other Python threads can run meanwhile
+              py::gil_scoped_release release;
+              self.Run();
+            }
+            // the arrays unbound on other threads are released here with the GIL held
+            PendingArrays::Global().ReleaseAll();
+          },
+          "Run the model without holding the GIL, the interpreter should not be bound or run by other threads "
+          "meanwhile.")
       .def("get_tensor", &frontend::Interpreter::GetTensor)
       .def("scope", &frontend::Interpreter::scope);
 
@@ -366,6 +396,7 @@ void BindFrontend(pybind11::module *m) {
            py::arg("bias")             = 0.0f,
            py::arg("bias_after_scale") = true)
       .def("softmax", &NetBuilder::softmax, py::arg("a"), py::arg("axis") = -1, py::arg("data_format") = "AnyLayout")
+      .def("log_softmax", &NetBuilder::log_softmax, py::arg("a"), py::arg("axis") = -1)
       .def("sigmoid", &NetBuilder::sigmoid, py::arg("a"))
       .def("slice",
            &NetBuilder::slice,
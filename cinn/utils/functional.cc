@@ -14,6 +14,107 @@
 
 #include "cinn/utils/functional.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>  //NOLINT
+
 namespace cinn {
-namespace utils {}  // namespace utils
+namespace utils {
+
+namespace {
+
+// The threads shared by all the ParallelFor calls, so a call does not pay for creating and joining its threads. The
+// pool is never destroyed, its idle threads just wait for tasks until the process exits.
+class ThreadPool {
+ public:
+  static ThreadPool &Global() {
+    static ThreadPool *pool = new ThreadPool(std::max(1U, std::thread::hardware_concurrency()) - 1);
+    return *pool;
+  }
+
+  int num_threads() const { return num_threads_; }
+
+  void Run(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  explicit ThreadPool(int num_threads) : num_threads_(num_threads) {
+    for (int i = 0; i < num_threads; i++) std::thread([this] { Loop(); }).detach();
+  }
+
+  void Loop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !tasks_.empty(); });
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  int num_threads_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+};
+
+// The indices of a ParallelFor call, shared with the pool threads helping it.
+struct ParallelForState {
+  std::atomic<int> next;
+  int end;
+  const std::function<void(int)> *fn;
+  std::atomic<int> num_left;
+  std::mutex mutex;
+  std::condition_variable finished;
+
+  void Work() {
+    for (int i = next++; i < end; i = next++) {
+      (*fn)(i);
+      if (--num_left == 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.notify_all();
+      }
+    }
+  }
+};
+
+}  // namespace
+
+void ParallelFor(int begin, int end, const std::function<void(int)> &fn, int num_threads) {
+  auto &pool = ThreadPool::Global();
+  if (num_threads <= 0) {
+    num_threads = pool.num_threads() + 1;
+  }
+  num_threads = std::min({num_threads, pool.num_threads() + 1, end - begin});
+  if (num_threads <= 1) {
+    for (int i = begin; i < end; i++) fn(i);
+    return;
+  }
+  auto state      = std::make_shared<ParallelForState>();
+  state->next     = begin;
+  state->end      = end;
+  state->fn       = &fn;
+  state->num_left = end - begin;
+  // The caller works on the indices too and only waits for the ones taken by the helpers. A helper that starts after
+  // all the indices are taken, e.g. when the pool is busy with the caller of a nested call, returns without calling
+  // fn, so a nested call never waits for a pool thread.
+  for (int i = 1; i < num_threads; i++) pool.Run([state] { state->Work(); });
+  state->Work();
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->finished.wait(lock, [&] { return state->num_left == 0; });
+}
+
+}  // namespace utils
 }  // namespace cinn
@@ -48,5 +48,12 @@ template <typename T, typename... Ts>
 auto Max(T &&t, Ts &&... ts) {
   return std::max(t, Max(ts...));
 }
+
+/**
+ * Run \p fn(i) for i in [begin, end) on \p num_threads threads, each thread takes the next index once it finishes one.
+ * The calling thread works too, helped by the threads of a pool shared by all the calls.
+ * @param num_threads the number of threads, all the hardware threads are used if it is not positive.
+ */
+void ParallelFor(int begin, int end, const std::function<void(int)> &fn, int num_threads = -1);
 }  // namespace utils
 }  // namespace cinn
@@ -0,0 +1,48 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <memory>
+#include <string>
+
+namespace cinn {
+namespace utils {
+
+/**
+ * A read-only view of a whole file mapped into memory. The pages are loaded lazily on the first access and shared
+ * with other processes mapping the same file. The mapping is private, so writing to it never changes the file and
+ * only copies the pages written.
+ */
+class MappedFile {
+ public:
+  //! Map the file \p path, return nullptr if it cannot be opened or mapped.
+  static std::shared_ptr<MappedFile> Open(const std::string& path);
+
+  ~MappedFile();
+
+  const char* data() const { return data_; }
+  char* mutable_data() { return data_; }
+  size_t size() const { return size_; }
+  const std::string& path() const { return path_; }
+
+ private:
+  MappedFile(const std::string& path, char* data, size_t size) : path_(path), data_(data), size_(size) {}
+
+  std::string path_;
+  char* data_{};
+  size_t size_{};
+};
+
+}  // namespace utils
+}  // namespace cinn
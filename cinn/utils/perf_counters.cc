@@ -0,0 +1,212 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/perf_counters.h"
+
+#include <glog/logging.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#endif
+
+namespace cinn {
+namespace utils {
+
+#ifdef __linux__
+namespace {
+
+// CORE_POWER.LVL1_TURBO_LICENSE and CORE_POWER.LVL2_TURBO_LICENSE are the raw events 0x1828 and 0x2028 of Skylake-X
+// and its successors of the same model, the codes count other events or nothing on the other CPUs.
+bool HasLicenseEvents() {
+  std::ifstream is("/proc/cpuinfo");
+  std::string line;
+  std::string vendor;
+  int family = -1;
+  int model  = -1;
+  // the fields of the first processor
+  while (std::getline(is, line) && !line.empty()) {
+    auto pos = line.find(':');
+    if (pos == std::string::npos) continue;
+    std::string key   = line.substr(0, line.find_last_not_of(" \t", pos - 1) + 1);
+    std::string value = line.substr(std::min(pos + 2, line.size()));
+    if (key == "vendor_id") {
+      vendor = value;
+    } else if (key == "cpu family") {
+      family = std::atoi(value.c_str());
+    } else if (key == "model") {
+      model = std::atoi(value.c_str());
+    }
+  }
+  return vendor == "GenuineIntel" && family == 6 && model == 85;
+}
+
+int OpenCounter(uint32_t type, uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size           = sizeof(attr);
+  attr.type           = type;
+  attr.config         = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // the group starts counting once all its counters are opened
+  attr.disabled = group_fd < 0;
+  // count the calling thread on any cpu
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+uint64_t CacheConfig(uint64_t cache, uint64_t op, uint64_t result) { return cache | (op << 8) | (result << 16); }
+
+int OpenEvent(PerfCounters::Event event, int group_fd) {
+  switch (event) {
+    case PerfCounters::kCycles:
+      return OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, group_fd);
+    case PerfCounters::kInstructions:
+      return OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, group_fd);
+    case PerfCounters::kL1DMisses:
+      return OpenCounter(
+          PERF_TYPE_HW_CACHE,
+          CacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS),
+          group_fd);
+    case PerfCounters::kLLCMisses:
+      return OpenCounter(
+          PERF_TYPE_HW_CACHE,
+          CacheConfig(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS),
+          group_fd);
+    case PerfCounters::kBranchMisses:
+      return OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, group_fd);
+    case PerfCounters::kAVX2LicenseCycles:
+      return OpenCounter(PERF_TYPE_RAW, 0x1828, group_fd);
+    case PerfCounters::kAVX512LicenseCycles:
+      return OpenCounter(PERF_TYPE_RAW, 0x2028, group_fd);
+    default:
+      return -1;
+  }
+}
+
+}  // namespace
+#endif
+
+const char* PerfCounters::Name(Event event) {
+  switch (event) {
+    case kCycles:
+      return "cycles";
+    case kInstructions:
+      return "instructions";
+    case kL1DMisses:
+      return "l1d_misses";
+    case kLLCMisses:
+      return "llc_misses";
+    case kBranchMisses:
+      return "branch_misses";
+    case kAVX2LicenseCycles:
+      return "avx2_license_cycles";
+    case kAVX512LicenseCycles:
+      return "avx512_license_cycles";
+    default:
+      return "unknown";
+  }
+}
+
+PerfCounters& PerfCounters::ThisThread() {
+  static thread_local PerfCounters x;
+  return x;
+}
+
+PerfCounters::PerfCounters() {
+  fds_.fill(-1);
+#ifdef __linux__
+  // the general counters take 3 programmable counters besides the fixed ones, so the group fits in any x86 PMU
+  OpenGroup({kCycles, kInstructions, kL1DMisses, kLLCMisses, kBranchMisses});
+  static const bool has_license_events = HasLicenseEvents();
+  if (has_license_events) {
+    OpenGroup({kAVX2LicenseCycles, kAVX512LicenseCycles});
+  }
+  if (!available()) {
+    LOG(WARNING) << "No hardware performance counter is available, check /proc/sys/kernel/perf_event_paranoid";
+  }
+#endif
+}
+
+void PerfCounters::OpenGroup(const std::vector<Event>& events) {
+#ifdef __linux__
+  Group group;
+  for (auto event : events) {
+    int fd = OpenEvent(event, group.leader);
+    if (fd < 0) continue;
+    if (group.leader < 0) group.leader = fd;
+    fds_[event] = fd;
+    group.events.push_back(event);
+  }
+  if (group.leader < 0) return;
+  ioctl(group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  groups_.push_back(group);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (int fd : fds_) {
+    if (fd >= 0) close(fd);
+  }
+#endif
+}
+
+bool PerfCounters::available() const {
+  for (int fd : fds_) {
+    if (fd >= 0) return true;
+  }
+  return false;
+}
+
+PerfCounters::Values PerfCounters::Read() const {
+  Values values;
+  values.fill(-1);
+#ifdef __linux__
+  for (auto& group : groups_) {
+    // the number of the values, the time enabled, the time running and the values of the group
+    std::vector<uint64_t> data(3 + group.events.size());
+    ssize_t size = data.size() * sizeof(uint64_t);
+    if (read(group.leader, data.data(), size) != size || data[0] != group.events.size()) continue;
+    uint64_t enabled = data[1];
+    uint64_t running = data[2];
+    for (size_t i = 0; i < group.events.size(); i++) {
+      // scale up the values counted while the group is multiplexed with the others
+      values[group.events[i]] =
+          running == 0 ? 0 : static_cast<int64_t>(static_cast<double>(data[3 + i]) * enabled / running);
+    }
+  }
+#endif
+  return values;
+}
+
+PerfCounters::Values PerfCounters::Diff(const Values& begin, const Values& end) {
+  Values values;
+  for (int i = 0; i < kNumEvents; i++) {
+    values[i] = begin[i] < 0 || end[i] < 0 ? -1 : end[i] - begin[i];
+  }
+  return values;
+}
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,82 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+/**
+ * The hardware performance counters of the calling thread, counted in user space by perf_event_open on Linux. The
+ * counters the kernel or the CPU does not support, e.g. on other platforms or without the permission by
+ * perf_event_paranoid, are reported as unavailable.
+ *
+ * The counters are opened in groups, the counters of a group are scheduled on the CPU together so their values are
+ * measured over the same time. When the groups are multiplexed, the values are scaled by the time enabled over the
+ * time running.
+ */
+class PerfCounters {
+ public:
+  enum Event {
+    kCycles = 0,
+    kInstructions,
+    kL1DMisses,
+    kLLCMisses,
+    kBranchMisses,
+    //! The cycles running at the frequency license of AVX2 and AVX-512 heavy instructions, only on Skylake-X.
+    kAVX2LicenseCycles,
+    kAVX512LicenseCycles,
+    kNumEvents,
+  };
+
+  //! The values of the counters, -1 if the counter is unavailable.
+  using Values = std::array<int64_t, kNumEvents>;
+
+  static const char* Name(Event event);
+
+  //! The counters of the calling thread, opened at the first call in the thread.
+  static PerfCounters& ThisThread();
+
+  //! Whether any counter is available.
+  bool available() const;
+
+  //! Read the values counted since the counters were opened.
+  Values Read() const;
+
+  //! The values counted from \p begin to \p end, unavailable if either is.
+  static Values Diff(const Values& begin, const Values& end);
+
+  ~PerfCounters();
+
+ private:
+  PerfCounters();
+
+  //! Open the \p events as a group, the events failed to open are left out of it.
+  void OpenGroup(const std::vector<Event>& events);
+
+  struct Group {
+    int leader{-1};
+    //! The events opened in the group, in the order of their values read from the leader.
+    std::vector<Event> events;
+  };
+
+  std::vector<Group> groups_;
+  std::array<int, kNumEvents> fds_;
+};
+
+}  // namespace utils
+}  // namespace cinn
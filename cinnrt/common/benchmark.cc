@@ -0,0 +1,237 @@
+#include "cinnrt/common/benchmark.h"
+
+#include <glog/logging.h>
+#include <llvm/Support/raw_ostream.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace cinnrt {
+
+namespace {
+// The CPU time of the calling thread, std::clock() is of the whole process and counts the other benchmark threads.
+std::chrono::nanoseconds ThreadCpuTime() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  timespec ts;
+  CHECK_EQ(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts), 0);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+#else
+  return std::chrono::nanoseconds(static_cast<int64_t>(1e9 * std::clock() / CLOCKS_PER_SEC));
+#endif
+}
+}  // namespace
+
+void BenchmarkStats::StartRun() {
+  ++cur_count_;
+  // Start recording CPU time.
+  cur_start_walltime_ = std::chrono::steady_clock::now();
+  cur_start_cpu_      = ThreadCpuTime();
+}
+
+void BenchmarkStats::StopRun() {
+  // Do not collect the runtime statistics if we are still in the warm up
+  // period.
+  if (cur_count_ <= num_warmup_runs_) return;
+
+  // Stop the CPU timer.
+  auto cur_stop_cpu_ = ThreadCpuTime();
+
+  // Stop the wall clock timer.
+  auto cur_stop_walltime_ = std::chrono::steady_clock::now();
+
+  // Collect the wall clock duration.
+  auto duration_walltime_ = cur_stop_walltime_ - cur_start_walltime_;
+  run_times_walltime_.push_back(duration_walltime_);
+
+  // Collect the CPU duration.
+  auto duration_cpu_ = cur_stop_cpu_ - cur_start_cpu_;
+  run_times_cpu_.push_back(duration_cpu_);
+
+  total_duration_walltime_ += duration_walltime_;
+  total_duration_cpu_ += duration_cpu_;
+}
+
+void BenchmarkStats::Merge(const BenchmarkStats& other) {
+  run_times_walltime_.insert(
+      run_times_walltime_.end(), other.run_times_walltime_.begin(), other.run_times_walltime_.end());
+  run_times_cpu_.insert(run_times_cpu_.end(), other.run_times_cpu_.begin(), other.run_times_cpu_.end());
+  total_duration_walltime_ += other.total_duration_walltime_;
+  total_duration_cpu_ += other.total_duration_cpu_;
+}
+
+BenchmarkResult BenchmarkStats::Result() const {
+  BenchmarkResult result;
+  result.name  = name_;
+  result.count = run_times_walltime_.size();
+  if (run_times_walltime_.empty()) return result;
+
+  auto walltime = run_times_walltime_;
+  auto cpu      = run_times_cpu_;
+  std::sort(walltime.begin(), walltime.end());
+  std::sort(cpu.begin(), cpu.end());
+  auto percentile = [](double p, const std::vector<std::chrono::nanoseconds>& run_times) {
+    CHECK(p >= 0.0 && p <= 1.0);
+    return run_times[std::min<size_t>(run_times.size() * p, run_times.size() - 1)].count();
+  };
+
+  result.duration        = total_duration_walltime_.count();
+  result.time_min        = walltime.front().count();
+  result.time_max        = walltime.back().count();
+  result.time_50         = percentile(0.5, walltime);
+  result.time_95         = percentile(0.95, walltime);
+  result.time_99         = percentile(0.99, walltime);
+  result.cpu_duration    = total_duration_cpu_.count();
+  result.cpu_min         = cpu.front().count();
+  result.cpu_max         = cpu.back().count();
+  result.cpu_50          = percentile(0.5, cpu);
+  result.cpu_95          = percentile(0.95, cpu);
+  result.cpu_99          = percentile(0.99, cpu);
+  result.cpu_utilization = total_duration_cpu_.count() * 100.0 / total_duration_walltime_.count();
+  return result;
+}
+
+void BenchmarkStats::Summarize() const {
+  auto result = Result();
+  if (result.count == 0) {
+    LOG(WARNING) << "No run of benchmark " << name_ << " is counted";
+    return;
+  }
+
+  // BM: prefix is added to make grepping results from lit output easier.
+  std::string prefix;
+  llvm::raw_string_ostream(prefix) << "BM:" << name_ << ':';
+
+  llvm::outs() << prefix << "Count: " << result.count << '\n';
+  llvm::outs() << prefix << "Duration(ns): " << result.duration << '\n';
+  llvm::outs() << prefix << "Time Min(ns): " << result.time_min << '\n';
+  llvm::outs() << prefix << "Time Max(ns): " << result.time_max << '\n';
+  llvm::outs() << prefix << "Time 50%(ns): " << result.time_50 << '\n';
+  llvm::outs() << prefix << "Time 95%(ns): " << result.time_95 << '\n';
+  llvm::outs() << prefix << "Time 99%(ns): " << result.time_99 << '\n';
+  // Log CPU time statistics.
+  llvm::outs() << prefix << "CPU Duration(ns): " << result.cpu_duration << '\n';
+  llvm::outs() << prefix << "CPU Min(ns): " << result.cpu_min << '\n';
+  llvm::outs() << prefix << "CPU Max(ns): " << result.cpu_max << '\n';
+  llvm::outs() << prefix << "CPU 50%(ns): " << result.cpu_50 << '\n';
+  llvm::outs() << prefix << "CPU 95%(ns): " << result.cpu_95 << '\n';
+  llvm::outs() << prefix << "CPU 99%(ns): " << result.cpu_99 << '\n';
+  llvm::outs() << prefix << "CPU utilization(percent): " << result.cpu_utilization << "\n";
+  llvm::outs().flush();
+}
+
+bool PinThisThread(int cpu) {
+#ifdef __linux__
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu % std::max(1u, std::thread::hardware_concurrency()), &cpuset);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0;
+#else
+  return false;
+#endif
+}
+
+BenchmarkResult RunBenchmark(const BenchmarkOptions& options,
+                             const std::function<std::function<void()>(int)>& make_fn) {
+  CHECK_GT(options.num_threads, 0);
+  std::vector<BenchmarkStats> stats;
+  for (int i = 0; i < options.num_threads; i++) {
+    stats.emplace_back(options.name, options.num_warmup_runs, options.max_count, options.duration);
+  }
+
+  // the runs start only after all the threads have made their functions, so that no run is measured while the others
+  // are still compiling
+  std::mutex mu;
+  std::condition_variable cv;
+  int num_ready = 0;
+  auto run      = [&](int i) {
+    if (options.pin_threads && !PinThisThread(i)) LOG(WARNING) << "Failed to pin the benchmark thread " << i;
+    auto fn = make_fn(i);
+    {
+      std::unique_lock<std::mutex> lock(mu);
+      if (++num_ready == options.num_threads) {
+        cv.notify_all();
+      } else {
+        cv.wait(lock, [&] { return num_ready == options.num_threads; });
+      }
+    }
+    while (stats[i].MoreRun()) {
+      stats[i].StartRun();
+      fn();
+      stats[i].StopRun();
+    }
+  };
+  if (options.num_threads == 1) {
+    run(0);
+  } else {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.num_threads; i++) threads.emplace_back(run, i);
+    for (auto& thread : threads) thread.join();
+  }
+
+  for (int i = 1; i < options.num_threads; i++) stats[0].Merge(stats[i]);
+  auto result        = stats[0].Result();
+  result.params      = options.params;
+  result.num_threads = options.num_threads;
+  return result;
+}
+
+namespace {
+std::string JsonString(const std::string& x) {
+  std::string res = "\"";
+  for (char c : x) {
+    if (c == '"' || c == '\\') {
+      res += '\\';
+      res += c;
+    } else if (c == '\n') {
+      res += "\\n";
+    } else if (c == '\t') {
+      res += "\\t";
+    } else if (c == '\r') {
+      res += "\\r";
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      // the other control characters are not allowed in a JSON string
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+      res += buf;
+    } else {
+      res += c;
+    }
+  }
+  return res + "\"";
+}
+}  // namespace
+
+std::string BenchmarkResultsToJson(const std::vector<BenchmarkResult>& results) {
+  std::stringstream ss;
+  ss << "[\n";
+  for (int i = 0; i < results.size(); i++) {
+    auto& x = results[i];
+    ss << "  {\"name\": " << JsonString(x.name) << ", \"params\": {";
+    for (int j = 0; j < x.params.size(); j++) {
+      if (j > 0) ss << ", ";
+      ss << JsonString(x.params[j].first) << ": " << JsonString(x.params[j].second);
+    }
+    ss << "}, \"num_threads\": " << x.num_threads << ", \"count\": " << x.count;
+    ss << ", \"duration_ns\": " << x.duration << ", \"time_min_ns\": " << x.time_min
+       << ", \"time_max_ns\": " << x.time_max << ", \"time_50_ns\": " << x.time_50 << ", \"time_95_ns\": " << x.time_95
+       << ", \"time_99_ns\": " << x.time_99;
+    ss << ", \"cpu_duration_ns\": " << x.cpu_duration << ", \"cpu_min_ns\": " << x.cpu_min
+       << ", \"cpu_max_ns\": " << x.cpu_max << ", \"cpu_50_ns\": " << x.cpu_50 << ", \"cpu_95_ns\": " << x.cpu_95
+       << ", \"cpu_99_ns\": " << x.cpu_99 << ", \"cpu_utilization\": " << x.cpu_utilization << "}";
+    ss << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  ss << "]\n";
+  return ss.str();
+}
+
+}  // namespace cinnrt
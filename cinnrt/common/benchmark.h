@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cinnrt {
+
+struct BenchmarkOptions {
+  //! The name used to tag the results.
+  std::string name;
+  int num_warmup_runs{3};
+  //! The max number of runs of each thread, not counting the warm up ones.
+  int max_count{1000};
+  //! The max duration of the runs of each thread.
+  std::chrono::microseconds duration{std::chrono::seconds(10)};
+  //! The number of the threads running concurrently, each thread runs its own function.
+  int num_threads{1};
+  //! Pin the i-th thread to the i-th cpu.
+  bool pin_threads{false};
+  //! The parameters of the benchmark to report with the results, e.g. the shapes.
+  std::vector<std::pair<std::string, std::string>> params;
+};
+
+//! The statistics of the runs in nanoseconds.
+struct BenchmarkResult {
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> params;
+  int num_threads{1};
+  int count{0};
+
+  int64_t duration{0};
+  int64_t time_min{0};
+  int64_t time_max{0};
+  int64_t time_50{0};
+  int64_t time_95{0};
+  int64_t time_99{0};
+
+  //! The CPU time is of the thread running the benchmark, excluding the threads a run parallelizes to.
+  int64_t cpu_duration{0};
+  int64_t cpu_min{0};
+  int64_t cpu_max{0};
+  int64_t cpu_50{0};
+  int64_t cpu_95{0};
+  int64_t cpu_99{0};
+  double cpu_utilization{0};
+};
+
+/**
+ * Collect the wall and CPU times of the runs of a benchmark. The runs stop after \p max_count runs or once they have
+ * taken \p benchmark_duration, the first \p num_warmup_runs runs are not counted.
+ */
+class BenchmarkStats {
+ public:
+  BenchmarkStats(std::string name, int num_warmup_runs, int max_count, std::chrono::microseconds benchmark_duration)
+      : name_{name},
+        num_warmup_runs_{num_warmup_runs},
+        max_count_{max_count},
+        benchmark_duration_{benchmark_duration} {}
+
+  void StartRun();
+  void StopRun();
+
+  // Return if we should we run more rounds.
+  bool MoreRun() const {
+    return cur_count_ < max_count_ + num_warmup_runs_ && total_duration_walltime_ < benchmark_duration_;
+  }
+
+  //! Add the runs of \p other, e.g. another thread running the same benchmark.
+  void Merge(const BenchmarkStats& other);
+
+  BenchmarkResult Result() const;
+
+  //! Print the results with the "BM:" prefix.
+  void Summarize() const;
+
+ private:
+  const std::string name_;
+  const int num_warmup_runs_;
+  const int max_count_;
+  int cur_count_ = 0;
+  const std::chrono::nanoseconds benchmark_duration_;
+  std::chrono::nanoseconds total_duration_walltime_{};
+  std::chrono::nanoseconds total_duration_cpu_{};
+  std::chrono::time_point<std::chrono::steady_clock> cur_start_walltime_{};
+  std::chrono::nanoseconds cur_start_cpu_{};
+  std::vector<std::chrono::nanoseconds> run_times_walltime_;
+  std::vector<std::chrono::nanoseconds> run_times_cpu_;
+};
+
+/**
+ * Run a benchmark on `options.num_threads` threads.
+ * @param make_fn Create the function the i-th thread runs, on that thread, so each thread can hold its own states,
+ * e.g. a program and its scope. The threads start running only after all of them have made their functions.
+ */
+BenchmarkResult RunBenchmark(const BenchmarkOptions& options, const std::function<std::function<void()>(int)>& make_fn);
+
+//! Pin the calling thread to \p cpu, return false if it fails.
+bool PinThisThread(int cpu);
+
+//! Print the results as a JSON array, one object per result.
+std::string BenchmarkResultsToJson(const std::vector<BenchmarkResult>& results);
+
+}  // namespace cinnrt
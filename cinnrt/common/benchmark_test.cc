@@ -0,0 +1,110 @@
+#include "cinnrt/common/benchmark.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace cinnrt {
+
+TEST(Benchmark, stats) {
+  BenchmarkStats stats("stats", 2, 5, std::chrono::seconds(10));
+  while (stats.MoreRun()) {
+    stats.StartRun();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    stats.StopRun();
+  }
+  auto result = stats.Result();
+  // the warm up runs are not counted
+  ASSERT_EQ(result.count, 5);
+  ASSERT_GE(result.time_min, 100000);
+  ASSERT_LE(result.time_min, result.time_50);
+  ASSERT_LE(result.time_50, result.time_95);
+  ASSERT_LE(result.time_95, result.time_99);
+  ASSERT_LE(result.time_99, result.time_max);
+  ASSERT_GE(result.duration, result.time_max);
+}
+
+TEST(Benchmark, threads) {
+  BenchmarkOptions options;
+  options.name            = "threads";
+  options.num_warmup_runs = 1;
+  options.max_count       = 4;
+  options.num_threads     = 3;
+  options.params          = {{"op", "add"}};
+  std::atomic<int> num_made{0};
+  std::atomic<int> num_runs{0};
+  auto result = RunBenchmark(options, [&](int i) {
+    // a slow thread delays the runs of all the others
+    if (i == 0) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ++num_made;
+    return [&] {
+      EXPECT_EQ(num_made.load(), options.num_threads) << "A run starts before all the threads are ready";
+      ++num_runs;
+    };
+  });
+  ASSERT_EQ(num_runs.load(), 3 * (1 + 4));
+  ASSERT_EQ(result.name, "threads");
+  ASSERT_EQ(result.num_threads, 3);
+  ASSERT_EQ(result.count, 3 * 4);
+  ASSERT_EQ(result.params.size(), 1U);
+}
+
+TEST(Benchmark, json) {
+  BenchmarkResult result;
+  result.name        = "fc \"relu\"";
+  result.params      = {{"shapes", "32x512"}, {"op", "fc"}};
+  result.num_threads = 2;
+  result.count       = 10;
+  result.duration    = 1000;
+  result.time_min    = 90;
+  result.time_max    = 110;
+  result.time_50     = 100;
+  result.time_95     = 105;
+  result.time_99     = 108;
+  BenchmarkResult other;
+  other.name = "relu";
+
+  auto json = BenchmarkResultsToJson({result, other});
+  ASSERT_EQ(json.front(), '[');
+  ASSERT_NE(json.find("{\"name\": \"fc \\\"relu\\\"\", \"params\": {\"shapes\": \"32x512\", \"op\": \"fc\"}, "
+                      "\"num_threads\": 2, \"count\": 10, \"duration_ns\": 1000, \"time_min_ns\": 90, "
+                      "\"time_max_ns\": 110, \"time_50_ns\": 100, \"time_95_ns\": 105, \"time_99_ns\": 108, "),
+            std::string::npos)
+      << json;
+  // the results are separated by commas
+  ASSERT_NE(json.find("},\n  {\"name\": \"relu\", \"params\": {}, \"num_threads\": 1, \"count\": 0"), std::string::npos)
+      << json;
+  ASSERT_EQ(json.substr(json.size() - 4), "}\n]\n");
+}
+
+TEST(Benchmark, json_control_characters) {
+  BenchmarkResult result;
+  result.name   = "a\tb\x01";
+  result.params = {{"line", "x\ry"}};
+  auto json     = BenchmarkResultsToJson({result});
+  ASSERT_NE(json.find("{\"name\": \"a\\tb\\u0001\", \"params\": {\"line\": \"x\\ry\"}"), std::string::npos) << json;
+}
+
+TEST(Benchmark, thread_cpu_time) {
+  std::atomic<bool> stop{false};
+  // a busy thread does not count to the CPU time of a sleeping benchmark
+  std::thread busy([&] {
+    while (!stop) {
+    }
+  });
+  BenchmarkStats stats("sleep", 0, 3, std::chrono::seconds(10));
+  while (stats.MoreRun()) {
+    stats.StartRun();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    stats.StopRun();
+  }
+  stop = true;
+  busy.join();
+  auto result = stats.Result();
+  ASSERT_EQ(result.count, 3);
+  ASSERT_LT(result.cpu_max, 10000000) << "the CPU time of the other threads is counted";
+}
+
+}  // namespace cinnrt
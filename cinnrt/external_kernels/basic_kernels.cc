@@ -31,15 +31,25 @@ void print(T a) {
 void RegisterKernels(cinnrt::host_context::KernelRegistry *registry) {
   // int32
   registry->AddKernel("external.add.i32", CINN_KERNEL(add<int32_t>));
+  registry->AddKernelReadOnlyArgs("external.add.i32", {0, 1});
   registry->AddKernel("external.sub.i32", CINN_KERNEL(sub<int32_t>));
+  registry->AddKernelReadOnlyArgs("external.sub.i32", {0, 1});
   registry->AddKernel("external.mul.i32", CINN_KERNEL(mul<int32_t>));
+  registry->AddKernelReadOnlyArgs("external.mul.i32", {0, 1});
   registry->AddKernel("external.div.i32", CINN_KERNEL(div<int32_t>));
+  registry->AddKernelReadOnlyArgs("external.div.i32", {0, 1});
   registry->AddKernel("external.print.i32", CINN_KERNEL(print<int32_t>));
+  registry->AddKernelReadOnlyArgs("external.print.i32", {0});
 
   // float
   registry->AddKernel("external.add.f32", CINN_KERNEL(add<float>));
+  registry->AddKernelReadOnlyArgs("external.add.f32", {0, 1});
   registry->AddKernel("external.sub.f32", CINN_KERNEL(sub<float>));
+  registry->AddKernelReadOnlyArgs("external.sub.f32", {0, 1});
   registry->AddKernel("external.mul.f32", CINN_KERNEL(mul<float>));
+  registry->AddKernelReadOnlyArgs("external.mul.f32", {0, 1});
   registry->AddKernel("external.div.f32", CINN_KERNEL(div<float>));
+  registry->AddKernelReadOnlyArgs("external.div.f32", {0, 1});
   registry->AddKernel("external.print.f32", CINN_KERNEL(print<float>));
+  registry->AddKernelReadOnlyArgs("external.print.f32", {0});
 }
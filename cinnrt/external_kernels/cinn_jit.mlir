@@ -0,0 +1,30 @@
+// CHECK-LABEL: @cinn_jit
+func @cinn_jit() -> () {
+  %input = dt.create_uninit_tensor.f32 [3, 5] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%input : !cinn.tensor<X86, NCHW, F32>) {value=1.0:f32}
+
+  %w = dt.create_uninit_tensor.f32 [5, 4] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%w : !cinn.tensor<X86, NCHW, F32>) {value=2.0:f32}
+
+  %bias = dt.create_uninit_tensor.f32 [4] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%bias : !cinn.tensor<X86, NCHW, F32>) {value=3.0:f32}
+
+  // test cinn_jit.matmul
+  %out0 = dt.create_uninit_tensor.f32 [3, 4] -> !cinn.tensor<X86, NCHW, F32>
+  "cinn_jit.matmul"(%input, %w, %out0) {}: (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> ()
+  // CHECK: tensor: shape=shape[3,4], values=[10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10]
+  dt.print_tensor (%out0 : !cinn.tensor<X86, NCHW, F32>)
+
+  // test cinn_jit.elementwise_add writing to one of its inputs
+  "cinn_jit.elementwise_add"(%out0, %bias, %out0) {axis=-1:i32}: (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> ()
+  // CHECK: tensor: shape=shape[3,4], values=[13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13]
+  dt.print_tensor (%out0 : !cinn.tensor<X86, NCHW, F32>)
+
+  // test cinn_jit.fc, the matmul, elementwise_add and relu are fused
+  %out1 = dt.create_uninit_tensor.f32 [3, 4] -> !cinn.tensor<X86, NCHW, F32>
+  "cinn_jit.fc"(%input, %w, %bias, %out1) {activation="relu"}: (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> ()
+  // CHECK: tensor: shape=shape[3,4], values=[13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13]
+  dt.print_tensor (%out1 : !cinn.tensor<X86, NCHW, F32>)
+
+  cinn.return
+}
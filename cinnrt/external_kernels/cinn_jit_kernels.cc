@@ -0,0 +1,238 @@
+// The kernels compiled by CINN at runtime, they build a graph of CINN ops for the shapes of the input tensors, fuse and
+// lower it through hlir, and run the generated code on the buffers of the DenseHostTensors directly.
+//
+// Load this library with `--shared_libs` of cinn-exec or `CinnRtConfig::set_shared_libs`, and call the kernels in the
+// destination-passing style of the external kernels, e.g.
+//   "cinn_jit.fc"(%input, %w, %bias, %out) {activation="relu"} : (...) -> ()
+#include <absl/container/flat_hash_map.h>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/string.h"
+#include "cinnrt/host_context/kernel_registry.h"
+#include "cinnrt/host_context/kernel_utils.h"
+#include "cinnrt/tensor/dense_host_tensor.h"
+
+namespace cinnrt {
+namespace cinn_jit {
+
+using cinnrt::host_context::Attribute;
+using cinnrt::tensor::DenseHostTensor;
+
+//! Build the CINN ops of a kernel on its inputs, and return the output.
+using GraphBuilder = std::function<cinn::frontend::Variable(cinn::frontend::Program*,
+                                                            const std::vector<cinn::frontend::Variable>&)>;
+
+/**
+ * A graph compiled for the shapes of its inputs, the inputs and the output are bound to the buffers of the kernel
+ * arguments before each run.
+ */
+struct CompiledGraph {
+  std::shared_ptr<cinn::hlir::framework::Scope> scope;
+  std::unique_ptr<cinn::hlir::framework::GraphCompiler> graph_compiler;
+  std::unique_ptr<cinn::hlir::framework::Program> program;
+  std::vector<std::string> input_names;
+  std::string output_name;
+  //! The output is computed here if the output tensor is also an input, e.g. `%out = relu(%out)`.
+  std::vector<float> staging;
+  //! The scope is shared by the runs, so the runs of a graph are serialized.
+  std::mutex mutex;
+};
+
+std::unique_ptr<CompiledGraph> CompileGraph(const std::vector<std::vector<int>>& input_shapes,
+                                            const GraphBuilder& build) {
+  auto target = cinn::common::DefaultHostTarget();
+  std::unique_ptr<CompiledGraph> compiled(new CompiledGraph);
+
+  cinn::frontend::Program program;
+  std::vector<cinn::frontend::Variable> inputs;
+  for (int i = 0; i < input_shapes.size(); i++) {
+    cinn::frontend::Placeholder x(cinn::common::Float(32), input_shapes[i], "cinn_jit_input_" + std::to_string(i));
+    inputs.push_back(x);
+    compiled->input_names.push_back(inputs.back()->id);
+  }
+  auto output           = build(&program, inputs);
+  compiled->output_name = output->id;
+  program.SetInputs(inputs);
+  program.Validate();
+
+  auto graph = std::make_shared<cinn::hlir::framework::Graph>(program, target);
+  cinn::hlir::framework::ApplyPass(graph.get(), "InferShape");
+  cinn::hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  compiled->scope = cinn::hlir::framework::BuildScope(target, graph);
+  compiled->graph_compiler.reset(new cinn::hlir::framework::GraphCompiler(target, compiled->scope, graph));
+  // the kernels are compiled on the threads of the executors, which may compile other graphs at the same time
+  cinn::hlir::framework::GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  options.with_session               = true;
+  compiled->program = std::move(compiled->graph_compiler->Build(options).runtime_program);
+  return compiled;
+}
+
+/**
+ * The graphs compiled by the kernels, keyed by the kernel and the shapes of its inputs, so a kernel is compiled once
+ * for each shape it is called with. The compilation runs outside the lock of the cache, the callers of the same key wait
+ * for it while the callers of the others go on.
+ */
+class JitCache {
+ public:
+  static JitCache& Global() {
+    static JitCache x;
+    return x;
+  }
+
+  CompiledGraph* Get(const std::string& kernel,
+                     const std::vector<std::vector<int>>& input_shapes,
+                     const GraphBuilder& build) {
+    std::string key = kernel;
+    for (auto& shape : input_shapes) key += "[" + cinn::utils::Join(shape, ",") + "]";
+
+    Entry* entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& slot = entries_[key];
+      if (!slot) slot.reset(new Entry);
+      entry = slot.get();
+    }
+    std::call_once(entry->compiled, [&] {
+      VLOG(3) << "JIT compile " << key;
+      entry->graph = CompileGraph(input_shapes, build);
+    });
+    return entry->graph.get();
+  }
+
+ private:
+  struct Entry {
+    std::once_flag compiled;
+    std::unique_ptr<CompiledGraph> graph;
+  };
+
+  std::mutex mutex_;
+  //! The entries are never erased, so a caller holds its entry after releasing the lock.
+  absl::flat_hash_map<std::string, std::unique_ptr<Entry>> entries_;
+};
+
+std::vector<int> ShapeOf(const DenseHostTensor& x) {
+  std::vector<int> shape;
+  for (int i = 0; i < x.shape().GetRank(); i++) shape.push_back(x.shape().GetDim(i));
+  return shape;
+}
+
+//! Compile the graph of \p kernel for the shapes of \p inputs if needed, and run it writing to \p out.
+void Run(const std::string& kernel,
+         const std::vector<const DenseHostTensor*>& inputs,
+         DenseHostTensor* out,
+         const GraphBuilder& build) {
+  CHECK(out->metadata().dtype == GetDType<float>()) << "Only float32 tensors are supported by " << kernel;
+  std::vector<std::vector<int>> input_shapes;
+  for (auto* x : inputs) {
+    CHECK(x->metadata().dtype == GetDType<float>()) << "Only float32 tensors are supported by " << kernel;
+    input_shapes.push_back(ShapeOf(*x));
+  }
+  auto* graph = JitCache::Global().Get(kernel, input_shapes, build);
+
+  auto target = cinn::common::DefaultHostTarget();
+  auto type   = cinn::common::Float(32);
+  std::lock_guard<std::mutex> lock(graph->mutex);
+  for (int i = 0; i < inputs.size(); i++) {
+    graph->scope->GetTensor(graph->input_names[i])->ShareExternalData(inputs[i]->raw_data(), type, target, nullptr);
+  }
+
+  auto output  = graph->scope->GetTensor(graph->output_name);
+  int numel    = output->shape().numel();
+  bool aliased = false;
+  for (auto* x : inputs) aliased |= x->raw_data() == out->raw_data();
+  CHECK_EQ(numel, out->shape().GetNumElements()) << "The output of " << kernel << " should be of shape ["
+                                                 << cinn::utils::Join(output->shape().data(), ",") << "]";
+  if (aliased) graph->staging.resize(numel);
+  output->ShareExternalData(aliased ? graph->staging.data() : out->raw_data(), type, target, nullptr);
+
+  graph->program->Execute();
+
+  if (aliased) std::memcpy(out->raw_data(), graph->staging.data(), numel * sizeof(float));
+}
+
+cinn::frontend::Variable Activate(cinn::frontend::Program* program,
+                                  const cinn::frontend::Variable& x,
+                                  const std::string& activation) {
+  if (activation.empty()) return x;
+  if (activation == "relu") return program->relu(x);
+  if (activation == "sigmoid") return program->sigmoid(x);
+  LOG(FATAL) << "Not supported activation [" << activation << "] in cinn_jit kernels";
+  return x;
+}
+
+/// ===== Kernel begin ====
+
+void Matmul(const DenseHostTensor& x, const DenseHostTensor& y, DenseHostTensor* out) {
+  Run("cinn_jit.matmul", {&x, &y}, out, [](cinn::frontend::Program* program, const auto& inputs) {
+    return program->matmul(inputs[0], inputs[1]);
+  });
+}
+
+void ElementwiseAdd(const DenseHostTensor& x, const DenseHostTensor& y, DenseHostTensor* out, Attribute<int32_t> axis) {
+  int axis_v = axis.get();
+  Run("cinn_jit.elementwise_add.axis" + std::to_string(axis_v),
+      {&x, &y},
+      out,
+      [axis_v](cinn::frontend::Program* program, const auto& inputs) {
+        return program->elementwise_add(inputs[0], inputs[1], axis_v);
+      });
+}
+
+void Relu(const DenseHostTensor& x, DenseHostTensor* out) {
+  Run("cinn_jit.relu", {&x}, out, [](cinn::frontend::Program* program, const auto& inputs) {
+    return program->relu(inputs[0]);
+  });
+}
+
+void Sigmoid(const DenseHostTensor& x, DenseHostTensor* out) {
+  Run("cinn_jit.sigmoid", {&x}, out, [](cinn::frontend::Program* program, const auto& inputs) {
+    return program->sigmoid(inputs[0]);
+  });
+}
+
+// out = activation(x * w + bias), the three ops are fused into one kernel.
+void Fc(const DenseHostTensor& x,
+        const DenseHostTensor& w,
+        const DenseHostTensor& bias,
+        DenseHostTensor* out,
+        Attribute<std::string> activation) {
+  const std::string& act = activation.get();
+  Run("cinn_jit.fc." + act, {&x, &w, &bias}, out, [act](cinn::frontend::Program* program, const auto& inputs) {
+    auto y = program->elementwise_add(program->matmul(inputs[0], inputs[1]), inputs[2]);
+    return Activate(program, y, act);
+  });
+}
+
+/// ===== Kernel end ====
+
+}  // namespace cinn_jit
+}  // namespace cinnrt
+
+void RegisterKernels(cinnrt::host_context::KernelRegistry *registry) {
+  using namespace cinnrt::cinn_jit;  // NOLINT
+  registry->AddKernel("cinn_jit.matmul", CINN_KERNEL(Matmul));
+  registry->AddKernelReadOnlyArgs("cinn_jit.matmul", {0, 1});
+  registry->AddKernel("cinn_jit.elementwise_add", CINN_KERNEL(ElementwiseAdd));
+  registry->AddKernelReadOnlyArgs("cinn_jit.elementwise_add", {0, 1});
+  registry->AddKernel("cinn_jit.relu", CINN_KERNEL(Relu));
+  registry->AddKernelReadOnlyArgs("cinn_jit.relu", {0});
+  registry->AddKernel("cinn_jit.sigmoid", CINN_KERNEL(Sigmoid));
+  registry->AddKernelReadOnlyArgs("cinn_jit.sigmoid", {0});
+  registry->AddKernel("cinn_jit.fc", CINN_KERNEL(Fc));
+  registry->AddKernelReadOnlyArgs("cinn_jit.fc", {0, 1, 2});
+}
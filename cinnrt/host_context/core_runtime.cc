@@ -1,10 +1,13 @@
 #include "cinnrt/host_context/core_runtime.h"
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 
 #include <string>
 #include <vector>
 
+#include "cinnrt/host_context/dataflow_executor.h"
+#include "cinnrt/host_context/kernel_frame.h"
 #include "cinnrt/host_context/kernel_registry.h"
 #include "cinnrt/host_context/op_executable.h"
 #include "cinnrt/host_context/symbol_table.h"
@@ -17,6 +20,55 @@ struct CoreRuntime::Impl {
   std::vector<OpExecutableBuilder> op_executables;
 
   mutable std::vector<ValueRef> results;
+
+  //! The compiled execution plan, the kernels of the ops to execute with their frames in a flat array, so the repeated
+  //! executions just call them one by one, with no lookup or allocation.
+  struct Step {
+    KernelImplementation kernel;
+    KernelFrame* frame;
+    //! The tensors to release after this step, whose last use is this step.
+    llvm::SmallVector<Value*, 2> dead;
+  };
+  std::vector<Step> plan;
+  //! The number of ops the plan is compiled from, the plan is compiled again once more ops are added.
+  size_t num_planned_ops{0};
+
+  //! Release the dead tensors in the plan, except these values.
+  bool release_dead_tensors{false};
+  absl::flat_hash_set<Value*> live_outs;
+
+  void CompilePlan() {
+    plan.clear();
+    for (auto& op : op_executables) {
+      if (op.finished()) continue;
+      plan.push_back(Step{op.kernel_impl(), &op.frame()});
+    }
+    num_planned_ops = op_executables.size();
+    if (release_dead_tensors) PlanTensorRelease();
+  }
+
+  // Only the tensors produced in the plan are released, the arguments and the results of the ops executed once, e.g.
+  // the params, are held across the executions.
+  void PlanTensorRelease() {
+    absl::flat_hash_map<Value*, int> last_use;
+    absl::flat_hash_set<Value*> produced;
+    for (int i = 0; i < plan.size(); i++) {
+      for (Value* x : plan[i].frame->GetArguments()) last_use[x] = i;
+      for (Value* x : plan[i].frame->GetResults()) {
+        last_use[x] = i;
+        produced.insert(x);
+      }
+    }
+    for (auto& item : last_use) {
+      Value* x = item.first;
+      if (!produced.count(x) || live_outs.count(x) || !x->is_type<tensor::DenseHostTensor>()) continue;
+      plan[item.second].dead.push_back(x);
+    }
+  }
+
+  int num_threads{1};
+  //! Built after the ops run once in order, and again once more ops are added.
+  std::unique_ptr<DataflowExecutor> dataflow_executor;
 };
 
 SymbolTable* CoreRuntime::symbol_table() { return &impl_->symbol_table; }
@@ -24,18 +76,56 @@ SymbolTable* CoreRuntime::symbol_table() { return &impl_->symbol_table; }
 CoreRuntime::CoreRuntime(CoreRuntime::Impl* impl) : impl_(impl) { CHECK(impl); }
 
 void CoreRuntime::Execute() {
+  auto& executor = impl_->dataflow_executor;
+  if (executor && executor->num_ops() == impl_->op_executables.size()) {
+    executor->Execute();
+    return;
+  }
+  if (impl_->num_threads == 1 && impl_->num_planned_ops > 0 && impl_->num_planned_ops == impl_->op_executables.size()) {
+    for (auto& step : impl_->plan) {
+      step.kernel(step.frame);
+      for (Value* x : step.dead) x->set(tensor::DenseHostTensor());
+    }
+    return;
+  }
   // std::cout << "CoreRuntime::Execute" << std::endl;
   int op_offset = 0;
   for (auto& op : impl_->op_executables) {
     VLOG(3) << "running op " << op_offset++ << " " << op.name();
     op.Execute();
   }
+  // the ops to run only once are dropped from the plan after the first run
+  impl_->CompilePlan();
+  // the types of the values are known after the first run, then the dataflow graph can be built
+  if (impl_->num_threads > 1) {
+    executor.reset(new DataflowExecutor(GetOps(), impl_->kernel_registry, impl_->num_threads));
+  }
 }
 
 KernelRegistry* CoreRuntime::kernel_registry() const { return impl_->kernel_registry; }
 
+void CoreRuntime::SetNumThreads(int num_threads) {
+  CHECK_GT(num_threads, 0);
+  if (num_threads != impl_->num_threads) impl_->dataflow_executor.reset();
+  impl_->num_threads = num_threads;
+}
+
+void CoreRuntime::ReleaseDeadTensors(llvm::ArrayRef<Value*> live_outs) {
+  impl_->release_dead_tensors = true;
+  impl_->live_outs.clear();
+  impl_->live_outs.insert(live_outs.begin(), live_outs.end());
+  // compile the plan again with the tensors to release
+  impl_->num_planned_ops = 0;
+}
+
 size_t CoreRuntime::num_ops() const { return impl_->op_executables.size(); }
 
+std::vector<OpExecutable*> CoreRuntime::GetOps() {
+  std::vector<OpExecutable*> ops;
+  for (auto& op : impl_->op_executables) ops.push_back(&op);
+  return ops;
+}
+
 CoreRuntimeBuilder::CoreRuntimeBuilder(KernelRegistry* kernel_registry) : CoreRuntime(new Impl) {
   impl_->kernel_registry = kernel_registry ? kernel_registry : GetCpuKernelRegistry();
 }
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cinnrt/host_context/value.h"
 
@@ -25,9 +26,26 @@ class CoreRuntime : public std::enable_shared_from_this<CoreRuntime> {
   //! Execute a program.
   void Execute();
 
+  /**
+   * Execute the ops concurrently on \p num_threads threads in the order of their data dependencies if it is larger
+   * than 1, see DataflowExecutor. The first execution after the ops change is still in order, it finds the types of
+   * the values to build the dataflow graph. The functions called by the ops still run their ops in order.
+   */
+  void SetNumThreads(int num_threads);
+
+  /**
+   * Release the tensors produced by the ops right after their last uses, so their buffers go back to the
+   * tensor::BufferPool and are reused by the later ops of the same execution. \p live_outs are the values read after
+   * the execution, e.g. the results of a function, which are kept. Only the sequential execution releases tensors.
+   */
+  void ReleaseDeadTensors(llvm::ArrayRef<Value*> live_outs);
+
   //! Return the number of ops.
   size_t num_ops() const;
 
+  //! Get the ops in the program order.
+  std::vector<OpExecutable*> GetOps();
+
   //! Get the results of the execution.
   llvm::SmallVector<ValueRef, 4>  //
   GetResults(llvm::ArrayRef<absl::string_view> arg_names);
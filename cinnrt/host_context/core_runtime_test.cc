@@ -2,10 +2,26 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
 #include "cinnrt/host_context/kernel_registry.h"
 #include "cinnrt/host_context/kernel_utils.h"
 #include "cinnrt/host_context/op_executable.h"
 #include "cinnrt/host_context/symbol_table.h"
+#include "cinnrt/tensor/buffer_pool.h"
+
+// Count the heap allocations of the test binary, so the steady-state executions can be checked to allocate nothing.
+std::atomic<size_t> num_heap_allocations{0};
+
+void* operator new(size_t size) {
+  num_heap_allocations++;
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
 
 namespace cinnrt {
 namespace host_context {
@@ -76,5 +92,151 @@ TEST(CoreRuntime, function) {
   ASSERT_EQ(res[0].get<int>(), 3);
 }
 
+TEST(CoreRuntime, repeated_execution) {
+  KernelRegistry registry;
+  registry.AddKernel("cinn.test.addi32", CINN_KERNEL(add));
+  registry.AddKernel("cinn.test.subi32", CINN_KERNEL(sub));
+
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  table->Register("a", 1);
+  table->Register("b", 2);
+
+  // c = a + b; d = c - a
+  auto* op0 = builder.NewOpExecutable("cinn.test.addi32");
+  op0->AppendArgument("a");
+  op0->AppendArgument("b");
+  op0->SetResults({"c"});
+  auto* op1 = builder.NewOpExecutable("cinn.test.subi32");
+  op1->AppendArgument("c");
+  op1->AppendArgument("a");
+  op1->SetResults({"d"});
+
+  builder.Execute();
+  ASSERT_EQ(table->GetValue("d")->get<int>(), 2);
+
+  // the later executions run the compiled plan on the values updated in place
+  for (int i = 0; i < 3; i++) {
+    table->GetValue("b")->set(10 + i);
+    builder.Execute();
+    ASSERT_EQ(table->GetValue("c")->get<int>(), 11 + i);
+    ASSERT_EQ(table->GetValue("d")->get<int>(), 10 + i);
+  }
+}
+
+TEST(CoreRuntime, steady_state_no_allocation) {
+  KernelRegistry registry;
+  registry.AddKernel("cinn.test.addi32", CINN_KERNEL(add));
+  registry.AddKernel("cinn.test.subi32", CINN_KERNEL(sub));
+
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  table->Register("a", 1);
+  table->Register("b", 2);
+
+  // c = a + b; d = c - a
+  auto* op0 = builder.NewOpExecutable("cinn.test.addi32");
+  op0->AppendArgument("a");
+  op0->AppendArgument("b");
+  op0->SetResults({"c"});
+  auto* op1 = builder.NewOpExecutable("cinn.test.subi32");
+  op1->AppendArgument("c");
+  op1->AppendArgument("a");
+  op1->SetResults({"d"});
+
+  // the first execution compiles the plan
+  builder.Execute();
+  Value* c = table->GetValue("c");
+  Value* d = table->GetValue("d");
+  Value* b = table->GetValue("b");
+
+  size_t num_allocations = num_heap_allocations;
+  for (int i = 0; i < 100; i++) {
+    b->set(i);
+    builder.Execute();
+  }
+  ASSERT_EQ(num_heap_allocations, num_allocations);
+
+  // the results are written to the same planned slots
+  ASSERT_EQ(table->GetValue("c"), c);
+  ASSERT_EQ(table->GetValue("d"), d);
+  ASSERT_EQ(c->get<int>(), 100);
+  ASSERT_EQ(d->get<int>(), 99);
+}
+
+tensor::DenseHostTensor new_tensor() {
+  int64_t dims[] = {4};
+  auto buffer    = tensor::BufferPool::Global().Acquire(4 * sizeof(float));
+  return tensor::DenseHostTensor(tensor::TensorShape(dims), GetDType<float>(), buffer);
+}
+
+std::vector<void*> used_buffers;
+void use_tensor(const tensor::DenseHostTensor& x) { used_buffers.push_back(x.raw_data()); }
+
+TEST(CoreRuntime, release_dead_tensors) {
+  KernelRegistry registry;
+  registry.AddKernel("test.new_tensor", CINN_KERNEL(new_tensor));
+  registry.AddKernel("test.use_tensor", CINN_KERNEL(use_tensor));
+
+  // t0 = new_tensor(); use_tensor(t0); t1 = new_tensor(); use_tensor(t1)
+  CoreRuntimeBuilder builder(&registry);
+  for (int i = 0; i < 2; i++) {
+    std::string t = "t" + std::to_string(i);
+    auto* op0      = builder.NewOpExecutable("test.new_tensor");
+    op0->SetResults({t});
+    auto* op1 = builder.NewOpExecutable("test.use_tensor");
+    op1->AppendArgument(t);
+    op1->SetResults(llvm::ArrayRef<std::string>{});
+  }
+  builder.ReleaseDeadTensors({});
+
+  builder.Execute();
+  used_buffers.clear();
+  builder.Execute();
+  // t0 is released after its use, t1 reuses its buffer
+  ASSERT_EQ(used_buffers.size(), 2UL);
+  ASSERT_EQ(used_buffers[0], used_buffers[1]);
+
+  // no more allocation once the pool is warm
+  size_t num_allocations = tensor::BufferPool::Global().num_allocations();
+  builder.Execute();
+  ASSERT_EQ(tensor::BufferPool::Global().num_allocations(), num_allocations);
+}
+
+TEST(BufferPool, max_cached_bytes) {
+  auto& pool = tensor::BufferPool::Global();
+  pool.Clear();
+  size_t max_cached_bytes = pool.max_cached_bytes();
+  pool.SetMaxCachedBytes(3 * 1024);
+
+  {
+    auto a = pool.Acquire(1024);
+    auto b = pool.Acquire(1024);
+    auto c = pool.Acquire(2048);
+    a.reset();
+    b.reset();
+    ASSERT_EQ(pool.cached_bytes(), 2048UL);
+  }
+  // c does not fit, a is the least recently released and freed
+  ASSERT_EQ(pool.num_cached(), 2UL);
+  ASSERT_EQ(pool.cached_bytes(), 3072UL);
+
+  // a buffer larger than the limit is never cached
+  pool.Acquire(4096);
+  ASSERT_EQ(pool.cached_bytes(), 3072UL);
+
+  // b is freed before c, released after it
+  pool.SetMaxCachedBytes(2048);
+  ASSERT_EQ(pool.num_cached(), 1UL);
+  size_t num_allocations = pool.num_allocations();
+  pool.Acquire(2048);
+  ASSERT_EQ(pool.num_allocations(), num_allocations);
+
+  pool.Clear();
+  ASSERT_EQ(pool.num_cached(), 0UL);
+  ASSERT_EQ(pool.cached_bytes(), 0UL);
+  pool.SetMaxCachedBytes(max_cached_bytes);
+}
+
 }  // namespace host_context
 }  // namespace cinnrt
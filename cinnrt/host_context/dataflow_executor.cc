@@ -0,0 +1,266 @@
+#include "cinnrt/host_context/dataflow_executor.h"
+
+#include <glog/logging.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "cinnrt/host_context/kernel_frame.h"
+#include "cinnrt/host_context/kernel_registry.h"
+#include "cinnrt/host_context/mlir_function_executable.h"
+#include "cinnrt/host_context/op_executable.h"
+
+namespace cinnrt {
+namespace host_context {
+
+namespace {
+// the pool and the index of the worker running on this thread
+thread_local WorkStealingPool* tls_pool = nullptr;
+thread_local int tls_worker             = -1;
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(int num_threads) {
+  CHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; i++) queues_.emplace_back(new Queue);
+  for (int i = 0; i < num_threads; i++) threads_.emplace_back([this, i] { Loop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) thread.join();
+}
+
+void WorkStealingPool::Schedule(std::function<void()> task) {
+  int index = tls_pool == this ? tls_worker : next_queue_++ % queues_.size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_tasks_++;
+  }
+  cv_.notify_one();
+}
+
+bool WorkStealingPool::Pop(int index, std::function<void()>* task) {
+  {
+    auto& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      *task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+  for (size_t i = 1; i < queues_.size(); i++) {
+    auto& queue = *queues_[(index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      *task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::Loop(int index) {
+  tls_pool   = this;
+  tls_worker = index;
+  std::function<void()> task;
+  while (true) {
+    if (Pop(index, &task)) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        num_tasks_--;
+      }
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return stopped_ || num_tasks_ > 0; });
+    if (stopped_ && num_tasks_ == 0) return;
+  }
+}
+
+namespace {
+
+// How an op uses its values: the arguments it writes, and the arguments each of its results may share the buffer with.
+struct Effects {
+  std::vector<bool> writes_arg;
+  std::vector<std::vector<int>> result_aliases;
+};
+
+// Partition the values of the ops into the classes of the values sharing buffers.
+class AliasAnalysis {
+ public:
+  explicit AliasAnalysis(KernelRegistry* registry) : registry_(registry) { CHECK(registry); }
+
+  //! Join the results of the ops with the arguments they may alias.
+  void AddOps(llvm::ArrayRef<OpExecutable*> ops) {
+    for (auto* op : ops) {
+      auto results        = op->frame().GetResults();
+      auto args           = op->frame().GetArguments();
+      const auto& effects = EffectsOf(op);
+      for (int r = 0; r < static_cast<int>(results.size()); r++) {
+        for (int j : effects.result_aliases[r]) alias_[Find(results[r])] = Find(args[j]);
+      }
+    }
+  }
+
+  //! Get the representative of the alias class of \p x.
+  Value* Find(Value* x) {
+    auto it = alias_.find(x);
+    if (it == alias_.end()) return alias_[x] = x;
+    if (it->second == x) return x;
+    return it->second = Find(it->second);
+  }
+
+  //! The alias classes the op uses, and whether it writes them.
+  std::unordered_map<Value*, bool> Accesses(OpExecutable* op) {
+    std::unordered_map<Value*, bool> writes;
+    auto args           = op->frame().GetArguments();
+    const auto& effects = EffectsOf(op);
+    for (int j = 0; j < static_cast<int>(args.size()); j++) writes[Find(args[j])] |= effects.writes_arg[j];
+    for (Value* result : op->frame().GetResults()) writes[Find(result)] = true;
+    return writes;
+  }
+
+ private:
+  static bool IsTensor(Value* x) { return x->is_type<tensor::DenseHostTensor>() || x->is_type<tensor::TensorMap>(); }
+
+  const Effects& EffectsOf(OpExecutable* op) {
+    auto it = effects_.find(op);
+    if (it != effects_.end()) return it->second;
+
+    auto& frame  = op->frame();
+    auto args    = frame.GetArguments();
+    auto results = frame.GetResults();
+    std::string name(op->name().data(), op->name().size());
+    Effects effects;
+    effects.writes_arg.resize(args.size(), true);
+    effects.result_aliases.resize(results.size());
+    auto* fn = name == "cinn.call" ? frame.GetAttributeAt(0)->get<MlirFunctionExecutable*>() : nullptr;
+    if (fn && fn->core_runtime()->num_ops() > 0) {
+      CallEffects(fn, args, &effects);
+    } else {
+      // a callee not built yet is assumed to write all the arguments and to return them
+      for (int j = 0; j < static_cast<int>(args.size()); j++) {
+        effects.writes_arg[j] = fn || !registry_->IsReadOnlyArg(name, j);
+      }
+      for (int r = 0; r < static_cast<int>(results.size()); r++) {
+        for (int j = 0; j < static_cast<int>(args.size()); j++) {
+          bool may_alias = fn || registry_->MayAliasArg(name, r, j);
+          if (may_alias && IsTensor(results[r]) && IsTensor(args[j])) effects.result_aliases[r].push_back(j);
+        }
+      }
+    }
+    return effects_[op] = std::move(effects);
+  }
+
+  // The ops of the function called by `cinn.call` use the arguments of the call directly, and the results of the call
+  // are shallow copies of the values the function returns.
+  void CallEffects(MlirFunctionExecutable* fn, llvm::ArrayRef<Value*> args, Effects* effects) {
+    auto* runtime = fn->core_runtime();
+    AliasAnalysis callee(runtime->kernel_registry());
+    auto ops = runtime->GetOps();
+    callee.AddOps(ops);
+    std::set<Value*> written;
+    for (auto* op : ops) {
+      for (auto& item : callee.Accesses(op)) {
+        if (item.second) written.insert(item.first);
+      }
+    }
+    for (int j = 0; j < static_cast<int>(args.size()); j++) {
+      effects->writes_arg[j] = written.count(callee.Find(args[j]));
+    }
+    auto returned = fn->runtime_results();
+    CHECK_EQ(returned.size(), effects->result_aliases.size());
+    for (int r = 0; r < static_cast<int>(returned.size()); r++) {
+      for (int j = 0; j < static_cast<int>(args.size()); j++) {
+        bool same_buffer = callee.Find(returned[r]) == callee.Find(args[j]);
+        if (same_buffer && IsTensor(returned[r]) && IsTensor(args[j])) effects->result_aliases[r].push_back(j);
+      }
+    }
+  }
+
+  KernelRegistry* registry_;
+  // the values aliasing each other share a representative
+  std::unordered_map<Value*, Value*> alias_;
+  std::unordered_map<OpExecutable*, Effects> effects_;
+};
+
+}  // namespace
+
+DataflowExecutor::DataflowExecutor(llvm::ArrayRef<OpExecutable*> ops, KernelRegistry* registry, int num_threads)
+    : pool_(num_threads) {
+  AliasAnalysis aliases(registry);
+  aliases.AddOps(ops);
+
+  struct Access {
+    int last_writer{-1};
+    std::vector<int> readers;
+  };
+  std::unordered_map<Value*, Access> accesses;
+  std::vector<std::set<int>> predecessors(ops.size());
+  for (int i = 0; i < static_cast<int>(ops.size()); i++) {
+    for (auto& item : aliases.Accesses(ops[i])) {
+      auto& access = accesses[item.first];
+      if (access.last_writer >= 0) predecessors[i].insert(access.last_writer);
+      if (item.second) {
+        for (int reader : access.readers) predecessors[i].insert(reader);
+        access.readers.clear();
+        access.last_writer = i;
+      } else {
+        access.readers.push_back(i);
+      }
+    }
+  }
+
+  for (int i = 0; i < static_cast<int>(ops.size()); i++) {
+    nodes_.emplace_back(new Node);
+    nodes_.back()->op = ops[i];
+  }
+  for (int i = 0; i < static_cast<int>(ops.size()); i++) {
+    predecessors[i].erase(i);
+    nodes_[i]->num_predecessors = predecessors[i].size();
+    for (int pred : predecessors[i]) nodes_[pred]->successors.push_back(i);
+    if (predecessors[i].empty()) roots_.push_back(i);
+  }
+  VLOG(3) << "dataflow graph of " << ops.size() << " ops with " << roots_.size() << " roots";
+}
+
+void DataflowExecutor::Run(int index) {
+  auto& node = *nodes_[index];
+  node.op->Execute();
+  for (int succ : node.successors) {
+    if (--nodes_[succ]->pending == 0) {
+      pool_.Schedule([this, succ] { Run(succ); });
+    }
+  }
+  if (--num_remaining_ == 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_.notify_all();
+  }
+}
+
+void DataflowExecutor::Execute() {
+  if (nodes_.empty()) return;
+  for (auto& node : nodes_) node->pending = node->num_predecessors;
+  num_remaining_ = nodes_.size();
+  for (int root : roots_) {
+    pool_.Schedule([this, root] { Run(root); });
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  finished_.wait(lock, [this] { return num_remaining_ == 0; });
+}
+
+}  // namespace host_context
+}  // namespace cinnrt
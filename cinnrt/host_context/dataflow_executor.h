@@ -0,0 +1,97 @@
+#pragma once
+#include <llvm/ADT/ArrayRef.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinnrt {
+namespace host_context {
+
+class OpExecutable;
+class KernelRegistry;
+
+/**
+ * A thread pool in which each worker has its own queue. The tasks scheduled by a worker go to its own queue and are
+ * run in LIFO order, an idle worker steals the oldest task from the others.
+ */
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(int num_threads);
+  ~WorkStealingPool();
+
+  void Schedule(std::function<void()> task);
+
+  int num_threads() const { return threads_.size(); }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  //! Pop a task from the queue of the worker \p index, or steal one from the others.
+  bool Pop(int index, std::function<void()>* task);
+  void Loop(int index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  //! The queue of the next task scheduled from outside the pool.
+  std::atomic<unsigned> next_queue_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int num_tasks_{0};
+  bool stopped_{false};
+};
+
+/**
+ * Execute a sequence of ops as a dataflow graph. An op is dispatched to the pool once all the ops it depends on have
+ * finished, so independent ops, e.g. the `cinn.call`s of independent subgraphs, run concurrently.
+ *
+ * An op depends on the earlier ops writing the values it uses, and on the earlier ops using the values it writes. An op
+ * writes its results and the arguments not declared read-only by KernelRegistry::AddKernelReadOnlyArgs. Since tensors
+ * share their buffers when copied, the tensor results of an op alias the tensor arguments declared by
+ * KernelRegistry::AddKernelResultAliases, or all of them if the kernel declares none. The effects of a `cinn.call` are
+ * those of the ops of its function on the arguments. The ops should have run once before the executor is built to hold
+ * the values of their types and to build the functions they call.
+ */
+class DataflowExecutor {
+ public:
+  /**
+   * @param ops The ops in the program order, they should stay alive and not be changed.
+   * @param registry The registry the kernels of the ops are from.
+   */
+  DataflowExecutor(llvm::ArrayRef<OpExecutable*> ops, KernelRegistry* registry, int num_threads);
+
+  //! Run all the ops and wait for them to finish.
+  void Execute();
+
+  size_t num_ops() const { return nodes_.size(); }
+
+ private:
+  struct Node {
+    OpExecutable* op;
+    std::vector<int> successors;
+    int num_predecessors{0};
+    std::atomic<int> pending{0};
+  };
+
+  void Run(int index);
+
+  std::vector<std::unique_ptr<Node>> nodes_;
+  std::vector<int> roots_;
+  WorkStealingPool pool_;
+
+  std::mutex mutex_;
+  std::condition_variable finished_;
+  std::atomic<int> num_remaining_{0};
+};
+
+}  // namespace host_context
+}  // namespace cinnrt
@@ -0,0 +1,162 @@
+#include "cinnrt/host_context/dataflow_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinnrt/host_context/core_runtime.h"
+#include "cinnrt/host_context/kernel_registry.h"
+#include "cinnrt/host_context/kernel_utils.h"
+#include "cinnrt/host_context/op_executable.h"
+#include "cinnrt/host_context/symbol_table.h"
+#include "cinnrt/kernel/tensor_kernels.h"
+#include "cinnrt/tensor/dense_host_tensor.h"
+#include "cinnrt/tensor/tensor_map.h"
+
+namespace cinnrt {
+namespace host_context {
+
+std::atomic<int> running{0};
+std::atomic<int> max_running{0};
+
+// The instances of slow_add meet in pairs when enabled, an instance waits for another one to run at the same time.
+struct Rendezvous {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool enabled{false};
+  int arrived{0};
+  int num_met{0};
+  int num_timeouts{0};
+
+  void Meet() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!enabled) return;
+    int met = num_met;
+    if (++arrived == 2) {
+      arrived = 0;
+      num_met++;
+      cv.notify_all();
+      return;
+    }
+    // fail rather than hang if the other instance never runs at the same time
+    if (!cv.wait_for(lock, std::chrono::seconds(10), [&] { return num_met != met; })) {
+      arrived = 0;
+      num_timeouts++;
+    }
+  }
+} rendezvous;
+
+// a kernel counting how many instances run at the same time
+int slow_add(int a, int b) {
+  int cur = ++running;
+  int max = max_running.load();
+  while (cur > max && !max_running.compare_exchange_weak(max, cur)) {
+  }
+  rendezvous.Meet();
+  --running;
+  return a + b;
+}
+
+void double_inplace(int* x) { *x *= 2; }
+
+// a kernel reading a tensor, like the external kernels reading the params
+int slow_numel(const tensor::DenseHostTensor& x) {
+  rendezvous.Meet();
+  return x.shape().GetNumElements();
+}
+
+TEST(DataflowExecutor, independent_chains) {
+  KernelRegistry registry;
+  registry.AddKernel("test.slow_add", CINN_KERNEL(slow_add));
+  registry.AddKernelReadOnlyArgs("test.slow_add", {0, 1});
+  registry.AddKernel("test.double_inplace", CINN_KERNEL(double_inplace));
+
+  CoreRuntimeBuilder builder(&registry);
+  builder.SetNumThreads(4);
+  auto* table = builder.symbol_table();
+  table->Register("a", 1);
+  table->Register("b", 2);
+
+  // chain 0: c0 = a + b; c0 *= 2; d0 = c0 + a
+  // chain 1: c1 = b + b; c1 *= 2; d1 = c1 + b
+  for (int i = 0; i < 2; i++) {
+    std::string x = i == 0 ? "a" : "b";
+    std::string c = "c" + std::to_string(i);
+    auto* op0     = builder.NewOpExecutable("test.slow_add");
+    op0->AppendArgument(x);
+    op0->AppendArgument("b");
+    op0->SetResults({c});
+
+    auto* op1 = builder.NewOpExecutable("test.double_inplace");
+    op1->AppendArgument(c);
+    op1->SetResults(llvm::ArrayRef<std::string>{});
+
+    auto* op2 = builder.NewOpExecutable("test.slow_add");
+    op2->AppendArgument(c);
+    op2->AppendArgument(x);
+    op2->SetResults({"d" + std::to_string(i)});
+  }
+
+  // the first run is sequential, the dataflow graph is built after it
+  builder.Execute();
+  ASSERT_EQ(max_running.load(), 1);
+  rendezvous.enabled = true;
+  builder.Execute();
+
+  ASSERT_EQ(table->GetValue("d0")->get<int>(), (1 + 2) * 2 + 1);
+  ASSERT_EQ(table->GetValue("d1")->get<int>(), (2 + 2) * 2 + 2);
+  // the two chains overlap, the slow_adds of the chains meet at both of their steps
+  ASSERT_EQ(rendezvous.num_timeouts, 0);
+  ASSERT_EQ(rendezvous.num_met, 2);
+}
+
+TEST(DataflowExecutor, shared_params) {
+  KernelRegistry registry;
+  kernel::RegisterTensorKernels(&registry);
+  registry.AddKernel("test.slow_numel", CINN_KERNEL(slow_numel));
+  registry.AddKernelReadOnlyArgs("test.slow_numel", {0});
+
+  tensor::DenseHostTensor w0(tensor::TensorShape{{2, 3}}, DType(DType::Kind::F32));
+  tensor::DenseHostTensor w1(tensor::TensorShape{{4, 5}}, DType(DType::Kind::F32));
+  CoreRuntimeBuilder builder(&registry);
+  builder.SetNumThreads(4);
+  auto* table = builder.symbol_table();
+  table->Register("params", tensor::TensorMap{{"w0", &w0}, {"w1", &w1}});
+
+  // n0 = numel(get_param(params, "w0")), n1 = numel(get_param(params, "w1"))
+  std::vector<std::unique_ptr<Value>> names;
+  for (int i = 0; i < 2; i++) {
+    std::string w = "w" + std::to_string(i);
+    auto* op0     = builder.NewOpExecutable("dt.get_param");
+    op0->AppendArgument("params");
+    op0->SetResults({w});
+    names.emplace_back(new Value(w));
+    op0->AppendAttribute(names.back().get());
+
+    auto* op1 = builder.NewOpExecutable("test.slow_numel");
+    op1->AppendArgument(w);
+    op1->SetResults({"n" + std::to_string(i)});
+  }
+
+  builder.Execute();
+  rendezvous.enabled      = true;
+  rendezvous.num_met      = 0;
+  rendezvous.num_timeouts = 0;
+  builder.Execute();
+  rendezvous.enabled = false;
+
+  ASSERT_EQ(table->GetValue("n0")->get<int>(), 6);
+  ASSERT_EQ(table->GetValue("n1")->get<int>(), 20);
+  // the params taken from the same map are independent, the ops reading them overlap
+  ASSERT_EQ(rendezvous.num_timeouts, 0);
+  ASSERT_EQ(rendezvous.num_met, 1);
+}
+
+}  // namespace host_context
+}  // namespace cinnrt
@@ -57,7 +57,9 @@ class KernelFrame {
 
   template <typename T, typename... Args>
   void EmplaceResult(int index, Args&&... args) {
-    SetResultAt(index, T(std::forward<Args>(args)...));
+    CHECK_LT(index, num_results_) << "Invalid result index";
+    CHECK(value_or_attrs_[num_arguments_ + index]);
+    value_or_attrs_[num_arguments_ + index]->template emplace<T>(std::forward<Args>(args)...);
   }
 
   template <typename T>
@@ -2,6 +2,9 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <algorithm>
+#include <utility>
+
 #include "glog/logging.h"
 #include "llvm/ADT/SmallVector.h"
 
@@ -11,6 +14,8 @@ namespace host_context {
 struct KernelRegistry::Impl {
   absl::flat_hash_map<std::string, KernelImplementation> data;
   absl::flat_hash_map<std::string, llvm::SmallVector<std::string, 4>> attr_names;
+  absl::flat_hash_map<std::string, llvm::SmallVector<int, 4>> read_only_args;
+  absl::flat_hash_map<std::string, llvm::SmallVector<std::pair<int, int>, 4>> result_aliases;
 };
 
 KernelRegistry::KernelRegistry() : impl_(std::make_unique<Impl>()) {}
@@ -25,6 +30,30 @@ void KernelRegistry::AddKernelAttrNameList(const std::string &key, const std::ve
   CHECK(added) << "kernel [" << key << "] is registered twice in attribute names";
 }
 
+void KernelRegistry::AddKernelReadOnlyArgs(const std::string &key, const std::vector<int> &indices) {
+  bool added = impl_->read_only_args.try_emplace(key, llvm::SmallVector<int, 4>(indices.begin(), indices.end())).second;
+  CHECK(added) << "kernel [" << key << "] is registered twice in read-only arguments";
+}
+
+bool KernelRegistry::IsReadOnlyArg(const std::string &key, int index) const {
+  auto it = impl_->read_only_args.find(key);
+  if (it == impl_->read_only_args.end()) return false;
+  return std::find(it->second.begin(), it->second.end(), index) != it->second.end();
+}
+
+void KernelRegistry::AddKernelResultAliases(const std::string &key, const std::vector<std::pair<int, int>> &aliases) {
+  bool added =
+      impl_->result_aliases.try_emplace(key, llvm::SmallVector<std::pair<int, int>, 4>(aliases.begin(), aliases.end()))
+          .second;
+  CHECK(added) << "kernel [" << key << "] is registered twice in result aliases";
+}
+
+bool KernelRegistry::MayAliasArg(const std::string &key, int result, int arg) const {
+  auto it = impl_->result_aliases.find(key);
+  if (it == impl_->result_aliases.end()) return true;
+  return std::find(it->second.begin(), it->second.end(), std::make_pair(result, arg)) != it->second.end();
+}
+
 KernelImplementation KernelRegistry::GetKernel(const std::string &key) const {
   auto it = impl_->data.find(key);
   return it != impl_->data.end() ? it->second : KernelImplementation{};
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace cinnrt {
@@ -20,8 +21,23 @@ class KernelRegistry {
 
   void AddKernel(const std::string &key, KernelImplementation fn);
   void AddKernelAttrNameList(const std::string &key, const std::vector<std::string> &names);
+  /**
+   * Declare the arguments the kernel \p key never modifies, the other arguments are assumed to be written by it, which
+   * orders the kernels using the same values in the concurrent execution.
+   */
+  void AddKernelReadOnlyArgs(const std::string &key, const std::vector<int> &indices);
+  /**
+   * Declare the arguments the results of the kernel \p key may share their buffers with, as (result, argument) index
+   * pairs, an empty list declares the results never alias the arguments. The tensor results of the kernels not
+   * declared are assumed to alias all their tensor arguments.
+   */
+  void AddKernelResultAliases(const std::string &key, const std::vector<std::pair<int, int>> &aliases);
 
   KernelImplementation GetKernel(const std::string &key) const;
+  //! Whether the kernel \p key is declared not to modify its argument \p index.
+  bool IsReadOnlyArg(const std::string &key, int index) const;
+  //! Whether the result \p result of the kernel \p key may share its buffer with its argument \p arg.
+  bool MayAliasArg(const std::string &key, int result, int arg) const;
   std::vector<std::string> GetKernelList() const;
 
   size_t size() const;
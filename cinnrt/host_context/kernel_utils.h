@@ -202,7 +202,8 @@ struct KernelImpl<Return (*)(Args...), impl_fn> {
     }
   };
 
-  // Treat any other type as an Argument.
+  // Treat any other type as an Argument. A kernel taking it by value gets a copy, so the types holding containers, e.g.
+  // TensorMap, should be taken by const reference.
   template <typename Head, typename... Tail>
   struct KernelCallHelper<Head, Tail...> {
     using ArgT = std::decay_t<Head>;
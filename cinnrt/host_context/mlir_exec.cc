@@ -25,6 +25,8 @@ int main(int argc, char** argv) {
   using namespace llvm;    // NOLINT
   using namespace cinnrt;  // NOLINT
   cl::opt<std::string> input_file("i", cl::desc("Specify input filename"), cl::value_desc("input file name"));
+  cl::opt<int> num_threads(
+      "num_threads", cl::desc("Run the independent ops concurrently on this number of threads"), cl::init(1));
   cl::ParseCommandLineOptions(argc, argv);
 
   mlir::MLIRContext* context = cinnrt::Global::getMLIRContext();
@@ -54,7 +56,7 @@ int main(int argc, char** argv) {
     }
   }
 
-  host_context::TestMlir(module.get(), &registry);
+  host_context::TestMlir(module.get(), &registry, num_threads);
 
   std::cout << std::endl;
   return 0;
@@ -50,7 +50,7 @@ void MlirFunctionExecutable::BuildExecutables(llvm::ArrayRef<Value*> arguments,
   auto& blocks = region_->getBlocks();
   CHECK_EQ(blocks.size(), 1UL) << "function with more than one block is not supported yet";
 
-  llvm::SmallVector<Value*, 3> runtime_results;
+  auto& runtime_results = runtime_results_;
   for (auto& op : blocks.front()) {
     if (EmitConstantOp(&op)) continue;
     if (EmitBuildShapeOp(&op)) continue;
@@ -73,6 +73,10 @@ void MlirFunctionExecutable::BuildExecutables(llvm::ArrayRef<Value*> arguments,
 
   // after the block is built, we can get the result values of the whole function call in the runtime_results.
 
+  // the tensors dead in the function are released to reuse their buffers, a region might use the values outside it and
+  // keeps all of them.
+  if (!is_region) core_runtime_builder_.ReleaseDeadTensors(runtime_results);
+
   mlir::SmallVector<Value*, 3> results_copied;
   if (!is_region) {
     for (ValueRef& x : results) {
@@ -37,6 +37,12 @@ class MlirFunctionExecutable : public Function, public MlirToRuntimeTranslator {
    */
   void Execute(llvm::ArrayRef<Value*> arguments, llvm::MutableArrayRef<ValueRef> results, bool is_region = false) const;
 
+  //! The runtime of the ops of the function, they use the arguments of the first execution directly.
+  CoreRuntimeBuilder* core_runtime() { return &core_runtime_builder_; }
+
+  //! The values returned by the function, which are copied to the results of the call.
+  llvm::ArrayRef<Value*> runtime_results() const { return runtime_results_; }
+
  private:
   /**
    * Build the runtime executables once the function call arguments and results are passed in.
@@ -49,6 +55,7 @@ class MlirFunctionExecutable : public Function, public MlirToRuntimeTranslator {
   CoreRuntimeBuilder core_runtime_builder_;
   MlirToRuntimeTranslator::function_defs_t& function_table_;
   std::function<void()> copy_res_fn_;
+  llvm::SmallVector<Value*, 3> runtime_results_;
 };
 
 }  // namespace host_context
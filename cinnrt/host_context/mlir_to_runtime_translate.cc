@@ -422,8 +422,11 @@ class MlirProgramTestExecutor : public MlirToRuntimeTranslator {
  public:
   CoreRuntimeBuilder core_runtime;
 
-  MlirProgramTestExecutor(mlir::ModuleOp module, KernelRegistry* registry)
-      : core_runtime(registry), MlirToRuntimeTranslator(module, &core_runtime), registry(registry) {
+  MlirProgramTestExecutor(mlir::ModuleOp module, KernelRegistry* registry, int num_threads = 1)
+      : core_runtime(registry),
+        MlirToRuntimeTranslator(module, &core_runtime),
+        registry(registry),
+        num_threads(num_threads) {
     CHECK(registry);
   }
 
@@ -468,6 +471,7 @@ class MlirProgramTestExecutor : public MlirToRuntimeTranslator {
         LOG(FATAL) << "Not supported op: " << DumpToString(op);
       }
 
+      runtime.SetNumThreads(num_threads);
       runtime.Execute();
 
     } else {
@@ -477,10 +481,11 @@ class MlirProgramTestExecutor : public MlirToRuntimeTranslator {
 
  private:
   KernelRegistry* registry{};
+  int num_threads{1};
 };
 
-void TestMlir(mlir::ModuleOp module, KernelRegistry* registry) {
-  MlirProgramTestExecutor execute(module, registry);
+void TestMlir(mlir::ModuleOp module, KernelRegistry* registry, int num_threads) {
+  MlirProgramTestExecutor execute(module, registry, num_threads);
   execute.Run();
 }
 
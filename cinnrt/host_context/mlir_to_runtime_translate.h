@@ -83,7 +83,8 @@ void MlirToRuntimeTranslate(mlir::ModuleOp module, CoreRuntimeBuilder* runtime);
  * This is mainly used by testcase.
  * @param module a MLIR module.
  * @param registry the kernel registry containing all the valid kernels.
+ * @param num_threads the number of threads to run the ops of the entry functions concurrently.
  */
-void TestMlir(mlir::ModuleOp module, KernelRegistry* registry);
+void TestMlir(mlir::ModuleOp module, KernelRegistry* registry, int num_threads = 1);
 
 }  // namespace cinnrt::host_context
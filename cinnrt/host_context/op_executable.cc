@@ -39,6 +39,10 @@ OpExecutable::OpExecutable(OpExecutable::Impl* impl) : impl_(impl) {}
 
 absl::string_view OpExecutable::name() const { return impl_->name; }
 
+KernelImplementation OpExecutable::kernel_impl() const { return impl_->kernel_impl; }
+
+bool OpExecutable::finished() const { return !impl_->to_execute(); }
+
 OpExecutableBuilder::OpExecutableBuilder(absl::string_view op_name,
                                          SymbolTable* symbol_table,
                                          KernelRegistry* kernel_registry)
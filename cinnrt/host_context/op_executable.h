@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 
+#include "cinnrt/host_context/kernel_registry.h"
 #include "mlir/IR/Function.h"
 #include "mlir/IR/Region.h"
 
@@ -36,6 +37,12 @@ class OpExecutable {
 
   absl::string_view name() const;
 
+  //! The kernel of the op, which can be called on the frame() directly.
+  KernelImplementation kernel_impl() const;
+
+  //! Tell whether the op should be executed only once and has been executed, e.g. `dt.get_param`.
+  bool finished() const;
+
   ~OpExecutable();
 
  protected:
@@ -54,12 +54,12 @@ class Value : public cinnrt::common::Object {
   explicit Value(double x) : data(x) {}
   explicit Value(bool x) : data(x) {}
   explicit Value(std::string x) : data(x) {}
-  explicit Value(tensor::TensorMap&& x) : data(x) {}
-  explicit Value(std::vector<int16_t>&& x) : data(x) {}
-  explicit Value(std::vector<int32_t>&& x) : data(x) {}
-  explicit Value(std::vector<int64_t>&& x) : data(x) {}
-  explicit Value(std::vector<float>&& x) : data(x) {}
-  explicit Value(std::vector<double>&& x) : data(x) {}
+  explicit Value(tensor::TensorMap&& x) : data(std::move(x)) {}
+  explicit Value(std::vector<int16_t>&& x) : data(std::move(x)) {}
+  explicit Value(std::vector<int32_t>&& x) : data(std::move(x)) {}
+  explicit Value(std::vector<int64_t>&& x) : data(std::move(x)) {}
+  explicit Value(std::vector<float>&& x) : data(std::move(x)) {}
+  explicit Value(std::vector<double>&& x) : data(std::move(x)) {}
   explicit Value(tensor::TensorShape&& x) : data(std::move(x)) {}
   explicit Value(tensor::DenseHostTensor&& x) : data(std::move(x)) {}
   explicit Value(MlirFunctionExecutable* x) : data(x) {}
@@ -78,8 +78,19 @@ class Value : public cinnrt::common::Object {
     data = std::move(v);
   }
 
+  //! Construct a \p T in place of the data held.
+  template <typename T, typename... Args>
+  T& emplace(Args&&... args) {
+    return data.template emplace<T>(std::forward<Args>(args)...);
+  }
+
   void set(Value* v) { data = std::move(v->data); }
 
+  template <typename T>
+  bool is_type() const {
+    return data.template is<T>();
+  }
+
   bool valid() const { return true; }
 
   const char* type_info() const override;
@@ -48,22 +48,33 @@ void RegisterBasicKernels(host_context::KernelRegistry *registry) {
   RegisterFloatBasicKernels(registry);
   registry->AddKernel("cinn.get_string", CINN_KERNEL(GetString));
   registry->AddKernel("cinn.print_string", CINN_KERNEL(PrintString));
+  registry->AddKernelReadOnlyArgs("cinn.print_string", {0});
 }
 
 void RegisterIntBasicKernels(host_context::KernelRegistry *registry) {
   registry->AddKernel("cinn.add.i32", CINN_KERNEL(add<int32_t>));
+  registry->AddKernelReadOnlyArgs("cinn.add.i32", {0, 1});
   registry->AddKernel("cinn.sub.i32", CINN_KERNEL(sub<int32_t>));
+  registry->AddKernelReadOnlyArgs("cinn.sub.i32", {0, 1});
   registry->AddKernel("cinn.mul.i32", CINN_KERNEL(mul<int32_t>));
+  registry->AddKernelReadOnlyArgs("cinn.mul.i32", {0, 1});
   registry->AddKernel("cinn.div.i32", CINN_KERNEL(div<int32_t>));
+  registry->AddKernelReadOnlyArgs("cinn.div.i32", {0, 1});
   registry->AddKernel("cinn.print.i32", CINN_KERNEL(print<int32_t>));
+  registry->AddKernelReadOnlyArgs("cinn.print.i32", {0});
 }
 
 void RegisterFloatBasicKernels(host_context::KernelRegistry *registry) {
   registry->AddKernel("cinn.add.f32", CINN_KERNEL(add<float>));
+  registry->AddKernelReadOnlyArgs("cinn.add.f32", {0, 1});
   registry->AddKernel("cinn.sub.f32", CINN_KERNEL(sub<float>));
+  registry->AddKernelReadOnlyArgs("cinn.sub.f32", {0, 1});
   registry->AddKernel("cinn.mul.f32", CINN_KERNEL(mul<float>));
+  registry->AddKernelReadOnlyArgs("cinn.mul.f32", {0, 1});
   registry->AddKernel("cinn.div.f32", CINN_KERNEL(div<float>));
+  registry->AddKernelReadOnlyArgs("cinn.div.f32", {0, 1});
   registry->AddKernel("cinn.print.f32", CINN_KERNEL(print<float>));
+  registry->AddKernelReadOnlyArgs("cinn.print.f32", {0});
 }
 
 }  // namespace cinnrt::kernel
@@ -6,6 +6,7 @@
 #include "cinnrt/common/global.h"
 #include "cinnrt/host_context/kernel_registry.h"
 #include "cinnrt/host_context/kernel_utils.h"
+#include "cinnrt/tensor/buffer_pool.h"
 #include "cinnrt/tensor/dense_host_tensor.h"
 #include "cinnrt/tensor/dense_tensor_view.h"
 #include "cinnrt/tensor/tensor_map.h"
@@ -22,7 +23,10 @@ DenseHostTensor CreateUninitTensor(Attribute<std::vector<int64_t>> shape) {
   const auto &shape_data = shape.get();
   auto array             = llvm::ArrayRef<int64_t>(shape_data.data(), shape_data.size());
   auto type              = GetDType<T>();
-  return DenseHostTensor(TensorShape(array), type);
+  TensorShape tensor_shape(array);
+  // the buffer is recycled once the tensor is released or overwritten by the next execution
+  auto buffer = BufferPool::Global().Acquire(type.GetHostSize() * tensor_shape.GetNumElements());
+  return DenseHostTensor(tensor_shape, type, std::move(buffer));
 }
 
 void PrintTensor(const DenseHostTensor &tensor) { std::cout << tensor << std::endl; }
@@ -34,12 +38,14 @@ void FillTensorWithConstant(DenseHostTensor *tensor, Attribute<T> v) {
 
 TensorMap LoadParams(const std::string &path) { return *(cinnrt::tensor::LoadParams(path)); }
 
-DenseHostTensor GetParam(TensorMap map, Attribute<std::string> nameAttr) {
+DenseHostTensor GetParam(const TensorMap &map, Attribute<std::string> nameAttr) {
   auto &name = nameAttr.get();
-  return *(map[name]);
+  auto it    = map.find(name);
+  CHECK(it != map.end()) << "No param called " << name;
+  return *(it->second);
 }
 
-DenseHostTensor ShallowCopyTensor(DenseHostTensor v) { return v; }
+DenseHostTensor ShallowCopyTensor(const DenseHostTensor &v) { return v; }
 
 /// ===== Kernel end ====
 
@@ -47,11 +53,18 @@ void RegisterTensorKernels(host_context::KernelRegistry *registry) {
   registry->AddKernel("dt.create_uninit_tensor.f32", CINN_KERNEL(CreateUninitTensor<float>));
   registry->AddKernelAttrNameList("dt.create_uninit_tensor.f32", {"shape"});
   registry->AddKernel("dt.print_tensor", CINN_KERNEL(PrintTensor));
+  registry->AddKernelReadOnlyArgs("dt.print_tensor", {0});
   registry->AddKernel("dt.fill_tensor_with_constant.f32", CINN_KERNEL(FillTensorWithConstant<float>));
   registry->AddKernel("dt.fill_tensor_with_constant.f64", CINN_KERNEL(FillTensorWithConstant<double>));
   registry->AddKernel("dt.load_params", CINN_KERNEL(LoadParams));
+  registry->AddKernelReadOnlyArgs("dt.load_params", {0});
   registry->AddKernel("dt.get_param", CINN_KERNEL(GetParam));
+  registry->AddKernelReadOnlyArgs("dt.get_param", {0});
+  // the params are never written after loading, so a param shares its buffer with no other value written
+  registry->AddKernelResultAliases("dt.get_param", {});
   registry->AddKernel("dt.shallow_copy_tensor", CINN_KERNEL(ShallowCopyTensor));
+  registry->AddKernelReadOnlyArgs("dt.shallow_copy_tensor", {0});
+  registry->AddKernelResultAliases("dt.shallow_copy_tensor", {{0, 0}});
 }
 
 }  // namespace cinnrt::kernel
@@ -19,6 +19,7 @@ void PrintShape(const tensor::TensorShape& shape) {
 
 void RegisterTensorShapeKernels(host_context::KernelRegistry* registry) {
   registry->AddKernel("ts.print_shape", CINN_KERNEL(PrintShape));
+  registry->AddKernelReadOnlyArgs("ts.print_shape", {0});
 }
 
 }  // namespace cinnrt::kernel
@@ -75,6 +75,11 @@ class Variant {
 
   template <typename T, std::enable_if_t<!IsVariant<T>, int> = 0>
   Variant& operator=(T&& t) {
+    // Reuse the storage held, e.g. the capacity of a vector, if the type is unchanged.
+    if (IndexOf<std::decay_t<T>> == index_) {
+      get<std::decay_t<T>>() = std::forward<T>(t);
+      return *this;
+    }
     destroy();
     fillValue(std::forward<T>(t));
 
@@ -0,0 +1,92 @@
+#include "cinnrt/tensor/buffer_pool.h"
+
+#include "cinnrt/common/buffer.h"
+
+namespace cinnrt {
+namespace tensor {
+
+constexpr size_t BufferPool::kDefaultMaxCachedBytes;
+
+BufferPool& BufferPool::Global() {
+  // never destroyed, the buffers might be released after the static objects are destroyed
+  static BufferPool* x = new BufferPool;
+  return *x;
+}
+
+std::shared_ptr<Buffer> BufferPool::Acquire(size_t size) {
+  Buffer* buffer = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cached_.find(size);
+    if (it != cached_.end() && !it->second.empty()) {
+      buffer = it->second.back()->second;
+      lru_.erase(it->second.back());
+      it->second.pop_back();
+      cached_bytes_ -= size;
+    } else {
+      num_allocations_++;
+    }
+  }
+  if (!buffer) {
+    buffer = new Buffer(cinnrt::common::DefaultHostTarget());
+    buffer->ResizeLazy(size);
+  }
+  return std::shared_ptr<Buffer>(buffer, [this, size](Buffer* x) { Release(x, size); });
+}
+
+void BufferPool::Release(Buffer* buffer, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  lru_.emplace_front(size, buffer);
+  cached_[size].push_back(lru_.begin());
+  cached_bytes_ += size;
+  EvictUntil(max_cached_bytes_);
+}
+
+void BufferPool::EvictUntil(size_t max_bytes) {
+  while (cached_bytes_ > max_bytes) {
+    size_t size    = lru_.back().first;
+    Buffer* buffer = lru_.back().second;
+    // the buffers of a size are released in order, the least recent one of the size is the first
+    auto& buffers = cached_[size];
+    buffers.erase(buffers.begin());
+    if (buffers.empty()) cached_.erase(size);
+    lru_.pop_back();
+    cached_bytes_ -= size;
+    buffer->Free();
+    delete buffer;
+  }
+}
+
+void BufferPool::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  EvictUntil(0);
+}
+
+void BufferPool::SetMaxCachedBytes(size_t max_cached_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_cached_bytes_ = max_cached_bytes;
+  EvictUntil(max_cached_bytes_);
+}
+
+size_t BufferPool::max_cached_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_cached_bytes_;
+}
+
+size_t BufferPool::num_allocations() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_allocations_;
+}
+
+size_t BufferPool::num_cached() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+size_t BufferPool::cached_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cached_bytes_;
+}
+
+}  // namespace tensor
+}  // namespace cinnrt
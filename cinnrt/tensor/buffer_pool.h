@@ -0,0 +1,66 @@
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cinnrt {
+class Buffer;
+
+namespace tensor {
+
+/**
+ * A pool of the host buffers of the DenseHostTensors. A buffer acquired from the pool goes back to it once no tensor
+ * holds it, and is reused by the next acquisition of the same size, so a program executed repeatedly stops allocating
+ * after its first executions. The released buffers cached take up to max_cached_bytes(), the least recently released
+ * ones are freed beyond it.
+ */
+class BufferPool {
+ public:
+  static BufferPool& Global();
+
+  //! Get a buffer of \p size bytes, a released one of the same size is reused if any.
+  std::shared_ptr<Buffer> Acquire(size_t size);
+
+  //! Free the buffers released to the pool.
+  void Clear();
+
+  //! Set the limit of the bytes of the released buffers cached, the least recently released ones are freed beyond it.
+  void SetMaxCachedBytes(size_t max_cached_bytes);
+  size_t max_cached_bytes() const;
+
+  //! The number of the buffers allocated by the pool.
+  size_t num_allocations() const;
+  //! The number of the buffers released to the pool and not acquired again.
+  size_t num_cached() const;
+  //! The bytes of the buffers released to the pool and not acquired again.
+  size_t cached_bytes() const;
+
+  static constexpr size_t kDefaultMaxCachedBytes = 256UL << 20;
+
+ private:
+  BufferPool() = default;
+
+  using LruList = std::list<std::pair<size_t, Buffer*>>;
+
+  void Release(Buffer* buffer, size_t size);
+
+  //! Free the least recently released buffers until the cache fits in \p max_bytes, with the lock held.
+  void EvictUntil(size_t max_bytes);
+
+  mutable std::mutex mutex_;
+  //! The released buffers, the most recently released first.
+  LruList lru_;
+  //! The released buffers by their sizes, the most recently released last.
+  absl::flat_hash_map<size_t, std::vector<LruList::iterator>> cached_;
+  size_t cached_bytes_{0};
+  size_t max_cached_bytes_{kDefaultMaxCachedBytes};
+  size_t num_allocations_{0};
+};
+
+}  // namespace tensor
+}  // namespace cinnrt
@@ -12,6 +12,12 @@ DenseHostTensor::DenseHostTensor(const TensorShape& shape, DType dtype) : HostTe
   buffer_->ResizeLazy(dtype.GetHostSize() * shape.GetNumElements());
 }
 
+DenseHostTensor::DenseHostTensor(const TensorShape& shape, DType dtype, std::shared_ptr<cinnrt::Buffer> buffer)
+    : HostTensor(TensorMetadata{dtype, shape}), buffer_(std::move(buffer)) {
+  CHECK(metadata().IsValid()) << "Tensor construct get invalid metadata";
+  CHECK(buffer_);
+}
+
 const TensorShape& DenseHostTensor::shape() const { return metadata().shape; }
 
 void DenseHostTensor::Init(const std::vector<int64_t>& shape, DType dtype) {
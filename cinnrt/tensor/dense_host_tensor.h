@@ -24,7 +24,11 @@ class Tensor {
   const TensorMetadata& metadata() const { return metadata_; }
 
  protected:
-  Tensor() = default;
+  Tensor()              = default;
+  Tensor(const Tensor&) = default;
+  Tensor(Tensor&&)      = default;
+  Tensor& operator=(const Tensor&) = default;
+  Tensor& operator=(Tensor&&) = default;
   void setTensorMetadata(TensorMetadata& metadata) { metadata_ = metadata; }
   explicit Tensor(const TensorMetadata& metadata) : metadata_(metadata) {}
   explicit Tensor(TensorMetadata&& metadata) : metadata_(std::move(metadata)) {}
@@ -51,6 +55,12 @@ class DenseHostTensor : public HostTensor {
  public:
   DenseHostTensor() = default;
   DenseHostTensor(const TensorShape& shape, DType dtype);
+  //! Hold the \p buffer given, e.g. one from the BufferPool, instead of allocating.
+  DenseHostTensor(const TensorShape& shape, DType dtype, std::shared_ptr<cinnrt::Buffer> buffer);
+  DenseHostTensor(const DenseHostTensor&) = default;
+  DenseHostTensor(DenseHostTensor&&)      = default;
+  DenseHostTensor& operator=(const DenseHostTensor&) = default;
+  DenseHostTensor& operator=(DenseHostTensor&&) = default;
 
   void Init(const std::vector<int64_t>& shape, DType dtype);
   const TensorShape& shape() const;
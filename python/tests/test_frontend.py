@@ -189,5 +189,75 @@ class TestLoadPaddleModel_MultiFC(unittest.TestCase):
         self.assertTrue(np.allclose(out.numpy(self.target), target, atol=1e-4))
 
 
+def aligned_array(shape, misaligned=False):
+    # the tensors on X86 require the memory aligned to 32 bytes
+    size = int(np.prod(shape))
+    buf = np.zeros(size + 32, dtype="float32")
+    offset = (-buf.ctypes.data % 32) // 4 + (1 if misaligned else 0)
+    return buf[offset:offset + size].reshape(shape)
+
+
+@unittest.skipIf(enable_gpu == "ON", "numpy arrays are only bound on X86")
+class TestBindNumpy(unittest.TestCase):
+    def setUp(self):
+        self.target = DefaultHostTarget()
+        self.model_dir = naive_model_dir
+        self.x_shape = [4, 30]
+        self.out_name = "save_infer_model/scale_0.tmp_0"
+        np.random.seed(0)
+        self.x_data = np.random.random(self.x_shape).astype("float32")
+
+    def new_executor(self):
+        executor = Interpreter(["A"], [self.x_shape])
+        executor.load_paddle_model(self.model_dir, self.target, False)
+        return executor
+
+    def expected(self):
+        executor = self.new_executor()
+        executor.get_tensor("A").from_numpy(self.x_data, self.target)
+        executor.run()
+        return executor.get_tensor(self.out_name).numpy(self.target)
+
+    def test_share_numpy(self):
+        tensor = self.new_executor().get_tensor("A")
+        x = aligned_array(self.x_shape)
+        self.assertTrue(tensor.share_numpy(x, self.target))
+        x[...] = self.x_data
+        self.assertTrue(
+            np.array_equal(tensor.numpy_view(self.target), self.x_data))
+        # the misaligned array is copied
+        y = aligned_array(self.x_shape, misaligned=True)
+        y[...] = self.x_data
+        self.assertFalse(tensor.share_numpy(y, self.target))
+        y[...] = 0
+        self.assertTrue(
+            np.array_equal(tensor.numpy_view(self.target), self.x_data))
+
+    def test_bind_input(self):
+        expected = self.expected()
+        for misaligned in [False, True]:
+            executor = self.new_executor()
+            x = aligned_array(self.x_shape, misaligned)
+            executor.bind_input("A", x)
+            # the bound array is read at every run, copied or not
+            x[...] = self.x_data
+            executor.run()
+            out = executor.get_tensor(self.out_name).numpy(self.target)
+            self.assertTrue(np.allclose(out, expected, atol=1e-5))
+
+    def test_bind_output(self):
+        expected = self.expected()
+        executor = self.new_executor()
+        executor.get_tensor("A").from_numpy(self.x_data, self.target)
+        out = aligned_array(expected.shape)
+        executor.bind_output(self.out_name, out)
+        view = executor.get_tensor(self.out_name).numpy_view(self.target)
+        for i in range(2):
+            executor.run()
+            self.assertTrue(np.allclose(out, expected, atol=1e-5))
+            # the bound output is written in place instead of reallocated
+            self.assertEqual(view.ctypes.data, out.ctypes.data)
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -511,6 +511,34 @@ class OpTest_softmax_2(SingleOpTester):
                         "softmax", attrs, 0)
 
 
+class OpTest_log_softmax_0(SingleOpTester):
+    def create_target_data(self, inputs_data, attrs):
+        [X] = inputs_data
+        X_max = np.max(X, axis=-1, keepdims=True)
+        return X - X_max - np.log(
+            np.sum(np.exp(X - X_max), axis=-1, keepdims=True))
+
+    def test_op(self):
+        attrs = framework.NodeAttr()
+        attrs.set_attr("axis", -1)
+        self.to_test_op([[12, 224, 224]], [[12, 224, 224], [12, 224, 224]],
+                        "log_softmax", attrs, 0)
+
+
+class OpTest_log_softmax_1(SingleOpTester):
+    def create_target_data(self, inputs_data, attrs):
+        [X] = inputs_data
+        X_max = np.max(X, axis=1, keepdims=True)
+        return X - X_max - np.log(
+            np.sum(np.exp(X - X_max), axis=1, keepdims=True))
+
+    def test_op(self):
+        attrs = framework.NodeAttr()
+        attrs.set_attr("axis", 1)
+        self.to_test_op([[12, 224, 224]], [[12, 224, 224], [12, 224, 224]],
+                        "log_softmax", attrs, 0)
+
+
 class OpTest_sigmoid(SingleOpTester):
     def create_target_data(self, inputs_data, attrs):
         x = np.array(inputs_data[0])
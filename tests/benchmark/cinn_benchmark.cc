@@ -0,0 +1,234 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmark the hlir programs, their instructions, the PE kernels and the CinnRtPredictor with the harness of the
+// `cinn.benchmark` kernel, and write the results as JSON for regression tracking, e.g.
+//
+//   cinn-benchmark --mode=program --op=fc --shapes=32x512,512x256,256 --threads=1,4 --json=fc.json
+//   cinn-benchmark --mode=pe --op=fc --shapes=32x512,512x256,256
+//   cinn-benchmark --mode=predictor --mlir_path=model.mlir --model_dir=model --shapes=1x3x224x224
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/string.h"
+#include "cinnrt/api/cinnrt_api.h"
+#include "cinnrt/common/benchmark.h"
+
+DEFINE_string(mode, "program", "What to benchmark: program, instructions, pe or predictor.");
+DEFINE_string(op, "fc", "The op to build the program of: relu, sigmoid, elementwise_add, matmul or fc.");
+DEFINE_string(shapes, "32x512,512x256,256", "The shapes of the inputs, separated by commas, e.g. 32x512,512x256.");
+DEFINE_string(threads, "1", "The numbers of the threads to benchmark with, separated by commas.");
+DEFINE_bool(pin_threads, false, "Pin the i-th benchmark thread to the i-th cpu.");
+DEFINE_int32(warmup, 3, "The number of the warm up runs.");
+DEFINE_int32(max_count, 1000, "The max number of the runs of each thread.");
+DEFINE_int32(duration_ms, 10000, "The max duration of the runs of each thread.");
+DEFINE_string(json, "", "The file to write the results to as JSON, the results are printed if empty.");
+DEFINE_string(mlir_path, "", "The MLIR of the model for the predictor mode.");
+DEFINE_string(model_dir, "", "The params of the model for the predictor mode.");
+DEFINE_string(shared_libs, "", "The kernel libraries to load for the predictor mode, separated by commas.");
+
+namespace cinn {
+namespace tests {
+
+using hlir::framework::Program;
+using hlir::framework::Scope;
+
+std::vector<std::vector<int>> ParseShapes(const std::string& str) {
+  std::vector<std::vector<int>> shapes;
+  for (auto& shape : utils::Split(str, ",")) {
+    shapes.emplace_back();
+    for (auto& dim : utils::Split(shape, "x")) shapes.back().push_back(std::stoi(dim));
+  }
+  return shapes;
+}
+
+std::vector<int> ParseInts(const std::string& str) {
+  std::vector<int> res;
+  for (auto& x : utils::Split(str, ",")) res.push_back(std::stoi(x));
+  return res;
+}
+
+//! The program of an op compiled with its scope, each benchmark thread runs its own. The programs are compiled before
+//! starting the threads, as the compilation shares the global states.
+struct CompiledProgram {
+  std::shared_ptr<Scope> scope;
+  std::unique_ptr<hlir::framework::GraphCompiler> graph_compiler;
+  std::unique_ptr<Program> program;
+};
+
+CompiledProgram CompileOp(const std::string& op, const std::vector<std::vector<int>>& shapes, bool fuse) {
+  auto target = common::DefaultHostTarget();
+  frontend::Program program;
+  std::vector<frontend::Variable> inputs;
+  for (int i = 0; i < shapes.size(); i++) {
+    inputs.push_back(frontend::Placeholder(Float(32), shapes[i], "input_" + std::to_string(i)));
+  }
+  auto input = [&](int i) {
+    CHECK_LT(i, inputs.size()) << "Op " << op << " needs more input shapes";
+    return inputs[i];
+  };
+  if (op == "relu") {
+    program.relu(input(0));
+  } else if (op == "sigmoid") {
+    program.sigmoid(input(0));
+  } else if (op == "elementwise_add") {
+    program.elementwise_add(input(0), input(1));
+  } else if (op == "matmul") {
+    program.matmul(input(0), input(1));
+  } else if (op == "fc") {
+    program.relu(program.elementwise_add(program.matmul(input(0), input(1)), input(2)));
+  } else {
+    LOG(FATAL) << "Not supported op " << op;
+  }
+  program.SetInputs(inputs);
+  program.Validate();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  if (fuse) hlir::framework::ApplyPass(graph.get(), "OpFusion");
+
+  CompiledProgram compiled;
+  compiled.scope = hlir::framework::BuildScope(target, graph);
+  compiled.graph_compiler.reset(new hlir::framework::GraphCompiler(target, compiled.scope, graph));
+  compiled.program = compiled.graph_compiler->Build();
+
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (auto& x : inputs) {
+    auto tensor = compiled.scope->GetTensor(x->id);
+    auto* data  = tensor->mutable_data<float>(target);
+    for (int i = 0; i < tensor->shape().numel(); i++) data[i] = dist(engine);
+  }
+  compiled.program->PreRun();
+  return compiled;
+}
+
+cinnrt::BenchmarkOptions Options(const std::string& name, int num_threads) {
+  cinnrt::BenchmarkOptions options;
+  options.name            = name;
+  options.num_warmup_runs = FLAGS_warmup;
+  options.max_count       = FLAGS_max_count;
+  options.duration        = std::chrono::milliseconds(FLAGS_duration_ms);
+  options.num_threads     = num_threads;
+  options.pin_threads     = FLAGS_pin_threads;
+  options.params          = {{"mode", FLAGS_mode}, {"shapes", FLAGS_shapes}};
+  if (FLAGS_mode != "predictor") options.params.emplace_back("op", FLAGS_op);
+  return options;
+}
+
+std::vector<cinnrt::BenchmarkResult> BenchmarkProgram(int num_threads) {
+  auto shapes = ParseShapes(FLAGS_shapes);
+  std::vector<std::unique_ptr<CompiledProgram>> programs(num_threads);
+  for (auto& program : programs) program.reset(new CompiledProgram(CompileOp(FLAGS_op, shapes, true)));
+  auto result = cinnrt::RunBenchmark(Options(FLAGS_op, num_threads), [&](int i) {
+    return [program = programs[i]->program.get()] { program->Execute(); };
+  });
+  return {result};
+}
+
+// Benchmark each instruction of the program, the PE kernels are the instructions of the program not fused.
+std::vector<cinnrt::BenchmarkResult> BenchmarkInstructions(int num_threads, bool fuse) {
+  auto shapes = ParseShapes(FLAGS_shapes);
+  // compile once to know the instructions
+  auto num_instrs = CompileOp(FLAGS_op, shapes, fuse).program->GetRunInstructions().size();
+  std::vector<cinnrt::BenchmarkResult> results;
+  for (int k = 0; k < num_instrs; k++) {
+    std::vector<std::unique_ptr<CompiledProgram>> programs(num_threads);
+    for (auto& program : programs) program.reset(new CompiledProgram(CompileOp(FLAGS_op, shapes, fuse)));
+    auto result = cinnrt::RunBenchmark(Options(FLAGS_op, num_threads), [&](int i) {
+      auto* instr = programs[i]->program->GetRunInstructions()[k].get();
+      return [instr] { instr->Run(); };
+    });
+    result.name = utils::Join(programs[0]->program->GetRunInstructions()[k]->GetFnNames(), "+");
+    results.push_back(result);
+  }
+  return results;
+}
+
+std::vector<cinnrt::BenchmarkResult> BenchmarkPredictor(int num_threads) {
+  cinnrt::CinnRtConfig config;
+  config.set_mlir_path(FLAGS_mlir_path);
+  config.set_model_dir(FLAGS_model_dir);
+  if (!FLAGS_shared_libs.empty()) config.set_shared_libs(utils::Split(FLAGS_shared_libs, ","));
+  auto shapes = ParseShapes(FLAGS_shapes);
+
+  // the predictors are created before starting the threads like the programs
+  std::vector<std::shared_ptr<cinnrt::CinnRtPredictor>> predictors(num_threads);
+  for (auto& predictor : predictors) {
+    predictor = cinnrt::CreateCinnRtPredictor(config);
+    CHECK_EQ(predictor->GetInputNum(), shapes.size()) << "The shapes should be given for all the inputs";
+    for (int k = 0; k < shapes.size(); k++) {
+      std::vector<int64_t> shape(shapes[k].begin(), shapes[k].end());
+      predictor->GetInput(k)->Init(shape, cinnrt::GetDType<float>());
+    }
+  }
+  auto result = cinnrt::RunBenchmark(Options("predictor", num_threads), [&](int i) {
+    return [predictor = predictors[i].get()] { predictor->Run(); };
+  });
+  return {result};
+}
+
+int Main() {
+  std::vector<cinnrt::BenchmarkResult> results;
+  for (int num_threads : ParseInts(FLAGS_threads)) {
+    std::vector<cinnrt::BenchmarkResult> res;
+    if (FLAGS_mode == "program") {
+      res = BenchmarkProgram(num_threads);
+    } else if (FLAGS_mode == "instructions") {
+      res = BenchmarkInstructions(num_threads, true);
+    } else if (FLAGS_mode == "pe") {
+      res = BenchmarkInstructions(num_threads, false);
+    } else if (FLAGS_mode == "predictor") {
+      res = BenchmarkPredictor(num_threads);
+    } else {
+      LOG(FATAL) << "Not supported mode " << FLAGS_mode;
+    }
+    results.insert(results.end(), res.begin(), res.end());
+  }
+
+  auto json = cinnrt::BenchmarkResultsToJson(results);
+  if (FLAGS_json.empty()) {
+    std::cout << json;
+  } else {
+    std::ofstream os(FLAGS_json);
+    CHECK(os.is_open()) << "Failed to open " << FLAGS_json;
+    os << json;
+  }
+  return 0;
+}
+
+}  // namespace tests
+}  // namespace cinn
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+  return cinn::tests::Main();
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/common/context.h"
+#include "cinn/lang/lower.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace tests {
+
+// A fused group as large as the ones of the big models: a chain of elementwise ops inlined into one loop nest, with
+// a reduction at the end.
+std::vector<ir::LoweredFunc> LowerFusedGroup(int num_ops) {
+  Expr M(64), N(128), K(32);
+  Placeholder<float> A("A", {M, N, K});
+  Placeholder<float> B("B", {M, N, K});
+
+  std::vector<ir::Tensor> chain;
+  ir::Tensor x = A;
+  for (int i = 0; i < num_ops; i++) {
+    x = Compute(
+        {M, N, K},
+        [=](Var i0, Var i1, Var i2) -> Expr {
+          auto y = x(i0, i1, i2) * B(i0, i1, i2) + Expr(static_cast<float>(i));
+          return i % 2 ? y - Expr(1.f) : ir::Max::Make(y, Expr(0.f));
+        },
+        "x_" + std::to_string(i));
+    chain.push_back(x);
+  }
+  Var k(K.as_int32(), "k");
+  auto out = Compute(
+      {M, N}, [=](Var i0, Var i1) -> Expr { return ReduceSum(x(i0, i1, k), {k}); }, "out");
+
+  auto stages = CreateStages({out});
+  for (auto& t : chain) stages[t]->ComputeInline();
+  return lang::LowerVec("fused_group", stages, {A, B, out});
+}
+
+TEST(LowerVec, fused_group) {
+  const int repeat = 5;
+  for (int num_ops : {16, 64, 256}) {
+    for (bool hash_cons : {false, true}) {
+      FLAGS_cinn_ir_hash_cons = hash_cons;
+      utils::Timer timer;
+      timer.Start();
+      for (int i = 0; i < repeat; i++) ASSERT_EQ(LowerFusedGroup(num_ops).size(), 1UL);
+      LOG(INFO) << "LowerVec of " << num_ops << " fused ops with hash-consing " << (hash_cons ? "on" : "off")
+                << " takes " << timer.Stop() / repeat << " ms";
+    }
+  }
+  FLAGS_cinn_ir_hash_cons = false;
+}
+
+}  // namespace tests
+}  // namespace cinn